@@ -0,0 +1,230 @@
+// 委托回报分发基准：原 std::deque + 互斥锁 + 条件变量（200ms wait_for、备注前缀路由）vs OrderEventRouter
+//
+// producers 个线程模拟交易回调线程写入回报，分发线程按策略路由到两个处理函数，统计每秒分发条数与
+// publish → 处理函数的时延分位数。两种负载：
+// - flood：各生产者连续写入，测吞吐；
+// - paced：每 gap_us 微秒写入一批 burst 条（回报成簇到达），测空闲唤醒后的时延。
+//
+// 用法：bench_order_events [events=200000] [producers=2] [burst=8] [gap_us=200]
+
+#include "Order.h"
+#include "OrderEventRouter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Load {
+    size_t events = 0;      // 每个生产者
+    int producers = 0;
+    size_t burst = 0;       // 0 表示连续写入
+    int gap_us = 0;
+};
+
+/// 发布时刻写入 filled_volume（基准专用），处理函数据此计算时延
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+/// 分发线程内的处理函数：记录时延，处理完全部回报后置位 done
+class Sink {
+public:
+    explicit Sink(size_t total) : total_(total) { latency_ns_.reserve(total); }
+
+    void on_event(const OrderResult& result, int) {
+        latency_ns_.push_back(now_ns() - result.filled_volume);
+        if (latency_ns_.size() == total_) {
+            done.store(true);
+        }
+    }
+
+    std::vector<int64_t>& latency_ns() { return latency_ns_; }
+
+    std::atomic<bool> done{false};
+
+private:
+    size_t total_;
+    std::vector<int64_t> latency_ns_;
+};
+
+OrderResult make_event(int producer, size_t i) {
+    OrderResult r;
+    r.success = true;
+    r.is_local = true;
+    r.order_id = std::to_string(100000 + i);
+    r.symbol = "600000.SH";
+    r.volume = 100;
+    bool sell = (i + static_cast<size_t>(producer)) % 2 == 0;
+    uint16_t strategy = sell ? StrategyIds::kQh2hSell : StrategyIds::kQh2hBaseCancel;
+    r.remark = (sell ? "qh2h_sell_600000.SH_" : "qh2h_base_cancel_600000.SH_") + r.order_id;
+    r.tag = make_order_tag(strategy, 1, static_cast<uint32_t>(i));
+    return r;
+}
+
+/// 原实现（复刻 main.cpp 的旧分发线程，仅用于对比）
+class LegacyDispatcher {
+public:
+    void publish(const OrderResult& result, int type) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(Event{result, type});
+        cv_.notify_one();
+    }
+
+    void run(const std::atomic<bool>& stop, Sink& sell, Sink& cancel) {
+        while (!stop.load()) {
+            Event ev;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait_for(lock, std::chrono::milliseconds(200), [&]() { return stop.load() || !queue_.empty(); });
+                if (stop.load() && queue_.empty()) {
+                    break;
+                }
+                if (queue_.empty()) {
+                    continue;
+                }
+                ev = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            const std::string& remark = ev.result.remark;
+            if (remark.rfind("qh2h_sell_", 0) == 0) {
+                sell.on_event(ev.result, ev.type);
+                continue;
+            }
+            if (remark.rfind("qh2h_base_cancel_", 0) == 0 || !ev.result.is_local) {
+                cancel.on_event(ev.result, ev.type);
+            }
+        }
+    }
+
+private:
+    struct Event {
+        OrderResult result;
+        int type;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Event> queue_;
+};
+
+/// 新实现：OrderEventRouter，按订单标签中的策略编号路由
+class RingDispatcher {
+public:
+    void publish(const OrderResult& result, int type) { router_.publish(result, type); }
+
+    void run(const std::atomic<bool>& stop, Sink& sell, Sink& cancel) {
+        router_.subscribe(StrategyIds::kQh2hSell, [&sell](const OrderResult& r, int t) { sell.on_event(r, t); });
+        router_.subscribe(StrategyIds::kQh2hBaseCancel,
+                          [&cancel](const OrderResult& r, int t) { cancel.on_event(r, t); });
+        router_.run(stop);
+    }
+
+private:
+    OrderEventRouter router_;
+};
+
+struct Result {
+    double events_per_sec = 0;
+    std::vector<int64_t> latency_ns;
+};
+
+template <typename Dispatcher>
+Result run(const Load& load) {
+    size_t total = load.events * static_cast<size_t>(load.producers);
+    Dispatcher dispatcher;
+    Sink sink(total);  // 两个策略的处理函数都在分发线程内，共用一个记录
+    std::atomic<bool> stop(false);
+    std::thread consumer([&]() { dispatcher.run(stop, sink, sink); });
+
+    // 预先构造回报，计时只覆盖 publish 与分发
+    std::vector<std::vector<OrderResult>> events(static_cast<size_t>(load.producers));
+    for (int p = 0; p < load.producers; ++p) {
+        for (size_t i = 0; i < load.events; ++i) {
+            events[static_cast<size_t>(p)].push_back(make_event(p, i));
+        }
+    }
+
+    Clock::time_point t0 = Clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < load.producers; ++p) {
+        producers.emplace_back([&, p]() {
+            std::vector<OrderResult>& mine = events[static_cast<size_t>(p)];
+            for (size_t i = 0; i < mine.size(); ++i) {
+                if (load.burst > 0 && i > 0 && i % load.burst == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(load.gap_us));
+                }
+                mine[i].filled_volume = now_ns();
+                dispatcher.publish(mine[i], 10);
+            }
+        });
+    }
+    for (std::thread& t : producers) {
+        t.join();
+    }
+    while (!sink.done.load()) {
+        std::this_thread::yield();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    stop.store(true);
+    consumer.join();
+
+    Result result;
+    result.events_per_sec = total / seconds;
+    result.latency_ns.swap(sink.latency_ns());
+    std::sort(result.latency_ns.begin(), result.latency_ns.end());
+    return result;
+}
+
+double percentile_us(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t i = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return sorted[i] / 1000.0;
+}
+
+void report(const char* name, const Result& r) {
+    const std::vector<int64_t>& l = r.latency_ns;
+    std::printf("%-14s events/s=%10.0f  p50_us=%8.1f  p99_us=%8.1f  p999_us=%9.1f  max_us=%9.1f\n", name,
+                r.events_per_sec, percentile_us(l, 0.50), percentile_us(l, 0.99), percentile_us(l, 0.999),
+                l.empty() ? 0.0 : l.back() / 1000.0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t events = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 200000;
+    int producers = argc > 2 ? std::atoi(argv[2]) : 2;
+    size_t burst = argc > 3 ? static_cast<size_t>(std::atoi(argv[3])) : 8;
+    int gap_us = argc > 4 ? std::atoi(argv[4]) : 200;
+
+    std::printf("events=%zu producers=%d burst=%zu gap_us=%d\n", events, producers, burst, gap_us);
+    Load flood;
+    flood.events = events / static_cast<size_t>(producers);
+    flood.producers = producers;
+    std::printf("[flood]\n");
+    report("deque+mutex", run<LegacyDispatcher>(flood));
+    report("mpsc ring", run<RingDispatcher>(flood));
+
+    // 成簇到达：总量取 flood 的 1/10，避免间隔累计过长
+    Load paced = flood;
+    paced.events = std::max<size_t>(flood.events / 10, burst);
+    paced.burst = burst;
+    paced.gap_us = gap_us;
+    std::printf("[paced]\n");
+    report("deque+mutex", run<LegacyDispatcher>(paced));
+    report("mpsc ring", run<RingDispatcher>(paced));
+    return 0;
+}
@@ -0,0 +1,180 @@
+// 快照存储基准：seqlock 槽位（SnapshotStore）vs 原实现 std::map<std::string, MarketSnapshot> + 互斥锁
+//
+// 一个写线程模拟行情回调，按批（每批 batch 条）循环写入全部证券；原实现在整批写入期间持锁。
+// readers 个读线程模拟模块轮询，按代码随机读取快照。分别统计写入/读取吞吐与单次读取最大耗时。
+//
+// 用法：bench_snapshot_store [symbols=5000] [readers=3] [seconds=2] [batch=1000]
+
+#include "InstrumentRegistry.h"
+#include "MarketData.h"
+#include "SnapshotStore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    uint64_t writes = 0;
+    uint64_t reads = 0;
+    int64_t max_read_ns = 0;
+};
+
+/// 原实现：代码字符串为键的有序表，读写共用一把锁
+class MapCache {
+public:
+    void write_batch(const std::vector<std::string>& symbols, size_t begin, size_t count,
+                     const MarketSnapshot& snap) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            std::string symbol = symbols[(begin + i) % symbols.size()];
+            cache_[symbol] = snap;
+        }
+    }
+
+    bool read(const std::string& symbol, MarketSnapshot& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(symbol);
+        if (it == cache_.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, MarketSnapshot> cache_;
+};
+
+/// 新实现：代码先经注册表无锁查 ID，再按 ID 读写 seqlock 槽位
+class SlotCache {
+public:
+    explicit SlotCache(size_t capacity) { store_.reset(capacity); }
+
+    void write_batch(const std::vector<std::string>& symbols, size_t begin, size_t count,
+                     MarketSnapshot snap) {
+        InstrumentRegistry& registry = InstrumentRegistry::instance();
+        for (size_t i = 0; i < count; ++i) {
+            InstrumentId id = registry.find(symbols[(begin + i) % symbols.size()]);
+            snap.instrument = id;
+            store_.store(id, snap);
+        }
+    }
+
+    bool read(const std::string& symbol, MarketSnapshot& out) {
+        return store_.load(InstrumentRegistry::instance().find(symbol), out);
+    }
+
+private:
+    SnapshotStore store_;
+};
+
+template <typename Cache>
+Result run(Cache& cache, const std::vector<std::string>& symbols, int readers, double seconds,
+           size_t batch) {
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> reads(0);
+    std::atomic<int64_t> max_read_ns(0);
+    Result result;
+
+    MarketSnapshot snap;
+    snap.valid = true;
+    snap.last_price = 10.0;
+    for (int k = 0; k < kDepthLevels; ++k) {
+        snap.bid_px[k] = 100000 - k * 100;
+        snap.ask_px[k] = 100100 + k * 100;
+        snap.bid_qty[k] = snap.ask_qty[k] = 1000;
+    }
+    cache.write_batch(symbols, 0, symbols.size(), snap);  // 预热：所有证券都有快照
+
+    std::thread writer([&]() {
+        size_t pos = 0;
+        MarketSnapshot s = snap;
+        while (!stop.load(std::memory_order_relaxed)) {
+            s.timestamp++;
+            cache.write_batch(symbols, pos, batch, s);
+            pos = (pos + batch) % symbols.size();
+            result.writes += batch;
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (int r = 0; r < readers; ++r) {
+        workers.emplace_back([&, r]() {
+            uint32_t x = 2463534242u + static_cast<uint32_t>(r) * 7919u;
+            uint64_t n = 0;
+            int64_t worst = 0;
+            MarketSnapshot out;
+            while (!stop.load(std::memory_order_relaxed)) {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                const std::string& symbol = symbols[x % symbols.size()];
+                Clock::time_point t0 = Clock::now();
+                cache.read(symbol, out);
+                int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+                worst = std::max(worst, ns);
+                ++n;
+            }
+            reads.fetch_add(n);
+            int64_t prev = max_read_ns.load();
+            while (worst > prev && !max_read_ns.compare_exchange_weak(prev, worst)) {
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    writer.join();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    result.reads = reads.load();
+    result.max_read_ns = max_read_ns.load();
+    return result;
+}
+
+void report(const char* name, const Result& r, double seconds) {
+    std::printf("%-12s writes/s=%12.0f  reads/s=%12.0f  max_read_us=%9.1f\n", name,
+                r.writes / seconds, r.reads / seconds, r.max_read_ns / 1000.0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t symbols_n = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 5000;
+    int readers = argc > 2 ? std::atoi(argv[2]) : 3;
+    double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+    size_t batch = argc > 4 ? static_cast<size_t>(std::atoi(argv[4])) : 1000;
+
+    std::vector<std::string> symbols;
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    for (size_t i = 0; i < symbols_n; ++i) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%06u.%s", static_cast<unsigned>(600000 + i), i % 2 ? "SZ" : "SH");
+        symbols.push_back(buf);
+        registry.intern(buf);
+    }
+
+    std::printf("symbols=%zu readers=%d seconds=%.1f batch=%zu\n", symbols_n, readers, seconds, batch);
+    {
+        MapCache cache;
+        report("map+mutex", run(cache, symbols, readers, seconds, batch), seconds);
+    }
+    {
+        SlotCache cache(registry.size());
+        report("seqlock", run(cache, symbols, readers, seconds, batch), seconds);
+    }
+    return 0;
+}
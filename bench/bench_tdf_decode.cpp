@@ -0,0 +1,259 @@
+// 行情解码基准：重放合成的 TDF_MARKET_DATA / TDF_TRANSACTION 数组，比较原解码路径与当前路径的每秒记录数
+//
+// - legacy：原 HandleMarketData / HandleTransactionData 的逐条处理方式（std::string 代码、substr 过滤、
+//   每条判断涨跌幅比例、五档逐字段 /10000.0、整批持锁写 std::map；逐笔回调构造带 std::string 的结构体）；
+// - current：经 TDF 桩以 OnDataReceived 推送给 TdfMarketDataApi（无逐条堆分配的解码路径）。
+//
+// 全市场推送：约 1/5 为非股票代码（可转债、基金），约 1/4 的记录没有涨跌停价（走推算分支）。
+//
+// 用法：bench_tdf_decode [symbols=5000] [rounds=200]
+
+#include "MockTdf.h"
+#include "TdfMarketDataApi.h"
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ==================== 原解码路径（复刻，仅用于对比） ====================
+
+struct LegacySnapshot {
+    std::string symbol;
+    int timestamp = 0;
+    double last_price = 0.0, pre_close = 0.0, open = 0.0, high = 0.0, low = 0.0;
+    double up_limit = 0.0, down_limit = 0.0, high_limit = 0.0, low_limit = 0.0;
+    int64_t volume = 0, turnover = 0;
+    double bid_price[5] = {}, ask_price[5] = {};
+    int64_t bid_volume[5] = {}, ask_volume[5] = {};
+    bool valid = false;
+};
+
+struct LegacyTransaction {
+    std::string symbol;
+    int timestamp;
+    double price;
+    int volume;
+    double turnover;
+    int bsf_flag;
+    char function_code;
+};
+
+bool legacy_is_stock(const std::string& symbol) {
+    if (symbol.length() < 9) {
+        return false;
+    }
+    std::string code = symbol.substr(0, 6);
+    return (code[0] == '6' && (code[1] == '0' || code[1] == '8')) ||
+           (code[0] == '0' && code[1] == '0') ||
+           (code[0] == '3' && code[1] == '0');
+}
+
+double legacy_limit_ratio(const std::string& symbol, const TDF_MARKET_DATA& data) {
+    std::string code = symbol.substr(0, 6);
+    if (code.compare(0, 2, "30") == 0 || code.compare(0, 2, "68") == 0) {
+        return 0.20;
+    }
+    std::string prefix(data.chPrefix, strnlen(data.chPrefix, sizeof(data.chPrefix)));
+    for (char& c : prefix) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return prefix.find("ST") != std::string::npos ? 0.05 : 0.10;
+}
+
+double round_price(double v) {
+    return std::round(v * 100.0) / 100.0;
+}
+
+class LegacyDecoder {
+public:
+    void market(const TDF_MARKET_DATA* data, unsigned int count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (unsigned int i = 0; i < count; ++i) {
+            std::string symbol = data[i].szWindCode;
+            if (!legacy_is_stock(symbol)) {
+                continue;
+            }
+            LegacySnapshot& snap = cache_[symbol];
+            snap.valid = true;
+            snap.symbol = symbol;
+            snap.timestamp = data[i].nTime;
+            snap.pre_close = data[i].nPreClose / 10000.0;
+            snap.open = data[i].nOpen / 10000.0;
+            snap.high = data[i].nHigh / 10000.0;
+            snap.low = data[i].nLow / 10000.0;
+            snap.last_price = data[i].nMatch / 10000.0;
+            double high_limit = data[i].nHighLimited / 10000.0;
+            double low_limit = data[i].nLowLimited / 10000.0;
+            if (high_limit <= 0.0 || low_limit <= 0.0) {
+                double ratio = legacy_limit_ratio(symbol, data[i]);
+                if (high_limit <= 0.0) {
+                    high_limit = round_price(snap.pre_close * (1.0 + ratio));
+                }
+                if (low_limit <= 0.0) {
+                    low_limit = round_price(snap.pre_close * (1.0 - ratio));
+                }
+            }
+            snap.high_limit = snap.up_limit = high_limit;
+            snap.low_limit = snap.down_limit = low_limit;
+            for (int k = 0; k < 5; ++k) {
+                snap.bid_price[k] = data[i].nBidPrice[k] / 10000.0;
+                snap.bid_volume[k] = data[i].nBidVol[k];
+                snap.ask_price[k] = data[i].nAskPrice[k] / 10000.0;
+                snap.ask_volume[k] = data[i].nAskVol[k];
+            }
+            snap.volume = data[i].iVolume;
+            snap.turnover = data[i].iTurnover;
+        }
+    }
+
+    void transactions(const TDF_TRANSACTION* data, unsigned int count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (unsigned int i = 0; i < count; ++i) {
+            std::string symbol = data[i].szWindCode;
+            if (symbol.length() >= 9 && !legacy_is_stock(symbol)) {
+                continue;
+            }
+            if (callback_) {
+                LegacyTransaction td;
+                td.symbol = symbol;
+                td.timestamp = data[i].nTime;
+                td.price = data[i].nPrice / 10000.0;
+                td.volume = data[i].nVolume;
+                td.turnover = static_cast<double>(data[i].nTurnover);
+                td.bsf_flag = data[i].nBSFlag;
+                td.function_code = data[i].chFunctionCode;
+                callback_(td);
+            }
+        }
+    }
+
+    std::function<void(const LegacyTransaction&)> callback_;
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, LegacySnapshot> cache_;
+};
+
+// ==================== 合成数据 ====================
+
+void make_code(size_t i, char* out, size_t n) {
+    // 每 10 条：8 条股票（沪主板/深主板/中小板/创业板/科创板），2 条非股票（可转债、ETF）
+    static const char* kPrefixes[] = {"600", "601", "000", "002", "300", "301", "688", "603", "110", "510"};
+    const char* prefix = kPrefixes[i % 10];
+    bool sh = prefix[0] == '6' || prefix[0] == '1' || prefix[0] == '5';
+    std::snprintf(out, n, "%s%03u.%s", prefix, static_cast<unsigned>(i / 10 % 1000), sh ? "SH" : "SZ");
+}
+
+std::vector<TDF_MARKET_DATA> make_market(size_t symbols) {
+    std::vector<TDF_MARKET_DATA> out(symbols);
+    for (size_t i = 0; i < symbols; ++i) {
+        TDF_MARKET_DATA& m = out[i];
+        std::memset(&m, 0, sizeof(m));
+        make_code(i, m.szWindCode, sizeof(m.szWindCode));
+        m.nTime = 93000000;
+        m.nPreClose = 100000 + static_cast<long long>(i);
+        m.nOpen = m.nHigh = m.nLow = m.nMatch = m.nPreClose;
+        if (i % 4 != 0) {
+            m.nHighLimited = m.nPreClose * 11 / 10;
+            m.nLowLimited = m.nPreClose * 9 / 10;
+        }
+        for (int k = 0; k < 10; ++k) {
+            m.nBidPrice[k] = m.nMatch - 100 * (k + 1);
+            m.nAskPrice[k] = m.nMatch + 100 * (k + 1);
+            m.nBidVol[k] = m.nAskVol[k] = 1000 * (k + 1);
+        }
+        m.iVolume = 1000000;
+        m.iTurnover = 10000000;
+    }
+    return out;
+}
+
+std::vector<TDF_TRANSACTION> make_transactions(const std::vector<TDF_MARKET_DATA>& market) {
+    std::vector<TDF_TRANSACTION> out(market.size());
+    for (size_t i = 0; i < market.size(); ++i) {
+        TDF_TRANSACTION& t = out[i];
+        std::memset(&t, 0, sizeof(t));
+        std::memcpy(t.szWindCode, market[i].szWindCode, sizeof(t.szWindCode));
+        t.nTime = 93000000 + static_cast<int>(i);
+        t.nPrice = market[i].nMatch;
+        t.nVolume = 100;
+        t.nTurnover = t.nPrice / 100;
+        t.nBSFlag = 'B';
+        t.chFunctionCode = '0';
+    }
+    return out;
+}
+
+double rate(size_t records, Clock::duration elapsed) {
+    return records / std::chrono::duration<double>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t symbols = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 5000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 200;
+    std::vector<TDF_MARKET_DATA> md = make_market(symbols);
+    std::vector<TDF_TRANSACTION> tx = make_transactions(md);
+    size_t records = symbols * static_cast<size_t>(rounds);
+    uint64_t sink = 0;
+
+    // 原路径
+    LegacyDecoder legacy;
+    legacy.callback_ = [&sink](const LegacyTransaction& td) { sink += td.volume; };
+    legacy.market(&md[0], static_cast<unsigned int>(md.size()));  // 预热：建立全部 map 节点
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        legacy.market(&md[0], static_cast<unsigned int>(md.size()));
+    }
+    Clock::duration legacy_md = Clock::now() - t0;
+    t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        legacy.transactions(&tx[0], static_cast<unsigned int>(tx.size()));
+    }
+    Clock::duration legacy_tx = Clock::now() - t0;
+
+    // 当前路径：TDF 桩 -> OnDataReceived（全市场订阅，无 CSV）
+    TdfMarketDataApi api;
+    api.set_csv_path("bench_tdf_decode_no_such.csv");
+    api.set_tick_history_capacity(0);
+    api.set_transaction_callback([&sink](const TransactionData& td) { sink += td.volume; });
+    if (!api.connect("127.0.0.1", 6221)) {
+        std::fprintf(stderr, "connect failed\n");
+        return 1;
+    }
+    THANDLE handle = mock_tdf::last_handle();
+    mock_tdf::deliver(handle, MSG_DATA_MARKET, md);  // 预热：注册全部代码
+    t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        mock_tdf::deliver(handle, MSG_DATA_MARKET, md);
+    }
+    Clock::duration current_md = Clock::now() - t0;
+    t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        mock_tdf::deliver(handle, MSG_DATA_TRANSACTION, tx);
+    }
+    Clock::duration current_tx = Clock::now() - t0;
+    api.disconnect();
+
+    std::printf("symbols=%zu rounds=%d (sink=%llu)\n", symbols, rounds, static_cast<unsigned long long>(sink));
+    std::printf("%-22s legacy=%12.0f rec/s  current=%12.0f rec/s  x%.2f\n", "TDF_MARKET_DATA",
+                rate(records, legacy_md), rate(records, current_md),
+                rate(records, current_md) / rate(records, legacy_md));
+    std::printf("%-22s legacy=%12.0f rec/s  current=%12.0f rec/s  x%.2f\n", "TDF_TRANSACTION",
+                rate(records, legacy_tx), rate(records, current_tx),
+                rate(records, current_tx) / rate(records, legacy_tx));
+    return 0;
+}
@@ -352,7 +352,7 @@ void example_market_data_only(const ConfigReader& config, const std::string& csv
             char buf[256];
             snprintf(buf, sizeof(buf), 
                 "[逐笔成交] %s %02d:%02d:%02d.%03d 价格=%.2f 量=%d 额=%.0f %s",
-                td.symbol.c_str(), hour, minute, second, ms,
+                td.symbol, hour, minute, second, ms,
                 td.price, td.volume, td.turnover, bs_str);
             std::cout << buf << std::endl;
         } else if (count == max_print) {
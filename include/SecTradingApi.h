@@ -3,6 +3,8 @@
 #include "ITradingApi.h"
 #include "Order.h"
 #include "MarketData.h"
+#include "OrderStore.h"
+#include "PositionLedger.h"
 #include <functional>
 #include <map>
 #include <mutex>
@@ -16,17 +18,6 @@ struct stStructMsg;
 struct stStructOrderFuncMsg;
 struct ITPDK_CusReqInfo;
 
-/// @brief 订单状态常量定义（避免字符串不一致）
-namespace OrderStatus {
-    constexpr const char* SUBMITTED = "submitted";   // 已提交
-    constexpr const char* ACCEPTED = "accepted";     // 已确认
-    constexpr const char* PARTIAL = "partial_filled"; // 部分成交
-    constexpr const char* FILLED = "filled";         // 全部成交
-    constexpr const char* CANCELING = "canceling";   // 撤单中
-    constexpr const char* CANCELLED = "cancelled";   // 已撤单
-    constexpr const char* REJECTED = "rejected";     // 已拒绝/废单
-}
-
 /// @brief SEC 交易接口实现
 /// 封装华泰证券 SECITPDK 交易 API
 class SecTradingApi : public ITradingApi {
@@ -47,16 +38,44 @@ public:
     
     std::string place_order(const OrderRequest& req) override;
     
+    /// @brief 批量下单（SECITPDK_BatchOrderEntrust，一次往返提交整批委托）
+    std::vector<std::string> place_orders(const std::vector<OrderRequest>& reqs) override;
+    
     bool cancel_order(const std::string& order_id) override;
     
+    /// @brief 批量撤单（整批覆盖的批量委托走 SECITPDK_BatchOrderWithdraw，其余逐笔撤单）
+    std::vector<bool> cancel_orders(const std::vector<std::string>& order_ids) override;
+    
+    /// @brief 查询持仓：已建账时直接返回本地台账，否则查询柜台并建账
     std::vector<Position> query_positions() override;
     
+    bool query_positions_local(std::vector<Position>& out) override;
+    
+    /// @brief 查询柜台持仓并与本地台账对账（以柜台为准，偏差写日志）
+    size_t reconcile_positions() override;
+    
     std::vector<OrderResult> query_orders() override;
 
-    /// @brief 查询单个订单状态
-    /// @param order_id 订单ID
-    /// @return OrderResult 对象，如果未找到则返回空OrderResult
-    OrderResult query_order(const std::string& order_id);
+    /// @brief 按证券查询当日委托（SECITPDK_QueryOrders 按交易所+证券代码过滤）
+    std::vector<OrderResult> query_orders(const std::string& symbol) override;
+
+    /// @brief 查询单个订单状态（按委托号 lWth / 开发商本地编号过滤的单行查询）
+    /// @param order_id 订单ID（本地ID或柜台委托号）
+    /// @return OrderResult 对象；柜台查询失败时退回本地订单簿，均未找到时 success=false
+    OrderResult query_order(const std::string& order_id) override;
+
+    /// @brief 本地订单簿中某证券的活动订单
+    bool query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) override;
+
+    /// @brief 本地订单簿中某标签键的订单
+    bool query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) override;
+
+    /// @brief 本地订单的资金账号（登录客户号）与证券代码
+    bool order_route(const std::string& order_id, std::string& account, std::string& symbol) override;
+
+    /// @brief 查询本地订单状态机状态
+    /// @return 未找到时返回 false
+    bool query_order_state(const std::string& order_id, OrderState& state);
 
     /// @brief 等待订单完成（成交或撤单）
     /// @param order_id 订单ID
@@ -71,26 +90,17 @@ public:
     /// @brief 获取当前是否为 dry-run 模式
     bool is_dry_run() const { return dry_run_mode_; }
 
+    /// @brief 设置异步委托模式（SECITPDK_OrderEntrust_ASync）
+    /// @param enable true=下单只发出请求即返回本地ID，柜台确认通过异步回调按开发商本地编号关联
+    void set_async_entry(bool enable) { async_entry_ = enable; }
+
+    /// @brief 获取当前是否为异步委托模式
+    bool is_async_entry() const { return async_entry_; }
+
     /// @brief 设置订单回调（委托/成交/撤单/废单）
     void set_order_callback(OrderEventCallback callback);
 
 private:
-    // 内部订单跟踪结构
-    struct Order {
-        std::string order_id;
-        std::string symbol;
-        int64_t volume = 0;
-        double price = 0.0;
-        std::string status;  // "submitted", "accepted", "partial_filled", "filled", "canceled", "rejected"
-        int64_t filled_volume = 0;
-        double filled_price = 0.0;
-        double last_fill_price = 0.0;
-        std::string remark;  // ✅ 添加备注字段
-        int side = -1;       // 0=Buy, 1=Sell
-        int order_type = -1;
-        int entrust_type = -1;
-    };
-
     // SEC ITPDK 回调函数（静态）
     static void OnStructMsgCallback(const char* pTime, stStructMsg& stMsg, int nType);
     static void OnOrderAsyncCallback(const char* pTime, stStructOrderFuncMsg& stMsg, int nType);
@@ -101,7 +111,18 @@ private:
     
     // 内部辅助方法
     std::string generate_order_id();
-    void update_order_status(int64_t order_id, const std::string& status, 
+    bool fetch_positions(std::vector<Position>& result);
+    bool fetch_orders(const std::string& market, const std::string& code, int64_t wth,
+                      int64_t kfsbdbh, std::vector<OrderResult>& result);
+    OrderResult local_order(const std::string& order_id);    // 只读本地订单簿
+    bool resolve_route(const OrderRequest& req, InstrumentId& instrument, const InstrumentInfo*& info,
+                       std::string& market, std::string& account) const;
+    int64_t generate_kfsbdbh();
+    static OrderResult to_order_result(const OrderRecord& order);
+    bool set_state(OrderRecord& order, OrderState state);     // 需持有 orders_mutex_
+    void credit_fill(const OrderRecord& order, int64_t qty);  // 成交增量记账（区分终态后的迟到成交）
+    OrderRecord* find_batch_leg(const stStructMsg& msg);      // 批次内尚无委托号的对应腿；需持有 orders_mutex_
+    void update_order_status(int64_t order_id, OrderState state, 
                             const std::string& info = "");
     
     // 连接参数
@@ -112,14 +133,11 @@ private:
     bool is_connected_;
     
     // 订单管理
-    std::map<std::string, Order> orders_;      // local_id -> 订单状态
-    std::map<int64_t, std::string> sysid_to_local_; // sys_id -> local_id
-    std::map<int64_t, std::string> kfsbdbh_to_local_; // kfsbdbh -> local_id (异步下单)
+    OrderStore orders_;                    // 本地订单簿（local_id / sys_id / kfsbdbh / 批次 / 备注索引）
     std::mutex orders_mutex_;              // 订单状态互斥锁
     
-    // 持仓缓存
-    std::vector<Position> positions_cache_;
-    std::mutex positions_mutex_;
+    // 持仓台账（推送增量维护，定期对账）
+    PositionLedger positions_;
     
     // 股东号缓存
     std::string sh_account_;        // 上海股东号
@@ -127,9 +145,11 @@ private:
     
     // Dry-run 模式标志
     bool dry_run_mode_;             // true=测试模式，false=正常模式
+    bool async_entry_;              // true=异步委托，false=同步委托
     
     // 订单ID生成器
     int64_t order_id_counter_;
+    int64_t kfsbdbh_counter_;       // 开发商本地编号，连接时按当日时间初始化
     std::mutex id_mutex_;
 
     OrderEventCallback order_callback_;
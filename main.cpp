@@ -1,12 +1,14 @@
 // Multi-module runner:
-// - 1x SecTradingApi + 1x TdfMarketDataApi
-// - Modules run on parallel threads (tick loops)
+// - 1x SecTradingApi (or SimTradingApi: SELL_BUILD_SIM + trading.sim=1) + 1x TdfMarketDataApi
+// - Modules run on parallel threads (tick loops, optionally woken early by market update push)
 // - All trading calls are serialized via QueuedTradingApi
 // - Market subscription is merged once at startup (TDF does not support runtime changes)
-// - Order callbacks are routed by remark prefix:
-//   * "qh2h_sell_"        -> Qh2hSellModule
-//   * "qh2h_base_cancel_" -> BaseCancelModule
-//   * (external orders / empty remark) -> BaseCancelModule (for monitoring)
+// - Order callbacks are published to an OrderEventRouter and dispatched on one thread
+//   by the strategy id carried in the order tag:
+//   * StrategyIds::kQh2hSell       -> Qh2hSellModule
+//   * StrategyIds::kQh2hBaseCancel -> BaseCancelModule
+//   * external orders (not placed by this process) -> BaseCancelModule via subscribe_external
+//     (for monitoring)
 
 #include "SecTradingApi.h"
 #include "TdfMarketDataApi.h"
@@ -14,18 +16,23 @@
 
 #include "src/core/AppContext.h"
 #include "src/core/ConfigReader.h"
+#include "src/core/OrderEventRouter.h"
 #include "src/core/QueuedTradingApi.h"
+#include "src/core/RateLimiter.h"
 
 #include "src/modules/BaseCancelModule.h"
 #include "src/modules/Qh2hSellModule.h"
 #include "src/modules/UsageExampleModule.h"
 
+#ifdef SELL_WITH_SIM
+#include "src/sim/SimTradingApi.h"
+#endif
+
 #include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cctype>
-#include <condition_variable>
 #include <fstream>
 #include <mutex>
 #include <sstream>
@@ -33,7 +40,6 @@
 #include <thread>
 #include <unordered_set>
 #include <utility>
-#include <deque>
 #include <vector>
 
 #ifdef _WIN32
@@ -462,7 +468,43 @@ int main(int argc, char** argv) {
     const double input_amt = config.get_strategy_input_amt(600000.0);
 
     auto trading_raw = std::make_shared<SecTradingApi>();
-    auto trading = std::make_shared<QueuedTradingApi>(trading_raw);
+    trading_raw->set_async_entry(config.get_trading_async_order() != 0);
+    std::shared_ptr<ITradingApi> trading_inner = trading_raw;
+#ifdef SELL_WITH_SIM
+    // 模拟撮合：委托按行情在本地撮合，不发往柜台
+    std::shared_ptr<SimTradingApi> sim;
+    if (config.get_trading_int("sim", 0) != 0) {
+        sim = std::make_shared<SimTradingApi>();
+        sim->set_latency(std::chrono::microseconds(std::max(0, config.get_trading_int("sim_ack_us", 200))),
+                         std::chrono::microseconds(std::max(0, config.get_trading_int("sim_fill_us", 300))));
+        const std::string sim_positions = config.get_trading_sim_positions();
+        if (!sim_positions.empty() && !sim->load_positions_csv(sim_positions)) {
+            main_logger->error("failed to load sim positions: " + sim_positions);
+            return 1;
+        }
+        trading_inner = sim;
+        main_logger->warn("[SIM] trading is simulated; orders are matched locally");
+    }
+#endif
+    auto trading = std::make_shared<QueuedTradingApi>(trading_inner);
+    trading->set_query_freshness(std::chrono::milliseconds(
+        std::max(0, config.get_trading_query_freshness_ms())));
+
+    auto limiter = std::make_shared<RateLimiter>();
+    int order_rate = config.get_trading_int("order_rate", 100);
+    limiter->set_account_limit(order_rate, config.get_trading_int("order_burst", order_rate));
+    int cancel_rate = config.get_trading_int("cancel_rate", 100);
+    limiter->set_cancel_limit(cancel_rate, config.get_trading_int("cancel_burst", cancel_rate));
+    static const char* const kExchanges[][2] = {{"SH", "_sh"}, {"SZ", "_sz"}};
+    for (const auto& exchange : kExchanges) {
+        int rate = config.get_trading_int(std::string("order_rate") + exchange[1], 0);
+        limiter->set_exchange_limit(exchange[0], rate,
+                                    config.get_trading_int(std::string("order_burst") + exchange[1], rate));
+        rate = config.get_trading_int(std::string("cancel_rate") + exchange[1], 0);
+        limiter->set_cancel_exchange_limit(exchange[0], rate,
+                                           config.get_trading_int(std::string("cancel_burst") + exchange[1], rate));
+    }
+    trading->set_rate_limiter(limiter);
     if (!trading->connect(config_section, trading_port, trading_account, trading_password)) {
         main_logger->error("trading connect failed");
         return 1;
@@ -528,6 +570,13 @@ int main(int argc, char** argv) {
 
     auto market = std::make_shared<TdfMarketDataApi>();
     market->set_csv_path(subscribe_csv);
+    const std::string record_dir = config.get_market_record_dir();
+    if (!record_dir.empty()) {
+        ensure_dir(record_dir);
+        market->enable_recording(record_dir,
+                                 static_cast<size_t>(std::max(1, config.get_market_record_buffer_mb())) << 20);
+        main_logger->info("[REC] raw market data journal dir: " + record_dir);
+    }
     if (!market->connect(config.get_market_host(), config.get_market_port(),
                          config.get_market_user(), config.get_market_password())) {
         main_logger->error("market connect failed");
@@ -541,15 +590,7 @@ int main(int argc, char** argv) {
     ctx.market = market;
     g_stop_flag = &ctx.stop;
 
-    struct OrderEvent {
-        OrderResult result;
-        int type;
-        OrderEvent() : result(), type(0) {}
-        OrderEvent(const OrderResult& r, int t) : result(r), type(t) {}
-    };
-    std::mutex ev_mutex;
-    std::condition_variable ev_cv;
-    std::deque<OrderEvent> ev_queue;
+    OrderEventRouter router;
 
     Qh2hSellModule* sell_module = nullptr;
     BaseCancelModule* base_cancel_module = nullptr;
@@ -577,41 +618,32 @@ int main(int argc, char** argv) {
     std::vector<std::thread> module_threads;
     module_threads.reserve(modules.size());
 
-    trading_raw->set_order_callback([&](const OrderResult& result, int notify_type) {
-        std::lock_guard<std::mutex> lock(ev_mutex);
-        ev_queue.push_back(OrderEvent{result, notify_type});
-        ev_cv.notify_one();
-    });
-
-    std::thread dispatcher([&]() {
-        while (!ctx.stop.load()) {
-            OrderEvent ev;
-            {
-                std::unique_lock<std::mutex> lock(ev_mutex);
-                ev_cv.wait_for(lock, std::chrono::milliseconds(200), [&]() {
-                    return ctx.stop.load() || !ev_queue.empty();
-                });
-                if (ctx.stop.load() && ev_queue.empty()) {
-                    break;
-                }
-                if (ev_queue.empty()) {
-                    continue;
-                }
-                ev = std::move(ev_queue.front());
-                ev_queue.pop_front();
-            }
+    // 回报按下单时写入的策略编号路由；外部订单交给排撤模块
+    if (sell_module) {
+        router.subscribe(StrategyIds::kQh2hSell, [&](const OrderResult& result, int notify_type) {
+            sell_module->on_order_event(ctx, result, notify_type);
+        });
+    }
+    if (base_cancel_module) {
+        auto handler = [&](const OrderResult& result, int notify_type) {
+            base_cancel_module->on_order_event(ctx, result, notify_type);
+        };
+        router.subscribe(StrategyIds::kQh2hBaseCancel, handler);
+        router.subscribe_external(handler);
+    }
 
-            const std::string& remark = ev.result.remark;
-            if (sell_module && remark.rfind("qh2h_sell_", 0) == 0) {
-                sell_module->on_order_event(ctx, ev.result, ev.type);
-                continue;
-            }
-            if (base_cancel_module && (remark.rfind("qh2h_base_cancel_", 0) == 0 || !ev.result.is_local)) {
-                base_cancel_module->on_order_event(ctx, ev.result, ev.type);
-                continue;
-            }
-        }
-    });
+    auto publish_order_event = [&](const OrderResult& result, int notify_type) {
+        router.publish(result, notify_type);
+    };
+    trading_raw->set_order_callback(publish_order_event);
+#ifdef SELL_WITH_SIM
+    if (sim) {
+        sim->attach_market(market);
+        sim->set_order_callback(publish_order_event);
+    }
+#endif
+
+    std::thread dispatcher([&]() { router.run(ctx.stop); });
 
     for (auto& mod : modules) {
         if (!mod->init(ctx)) {
@@ -624,20 +656,33 @@ int main(int argc, char** argv) {
             auto next = std::chrono::steady_clock::now();
             while (!ctx.stop.load()) {
                 module->tick(ctx);
-                next += interval;
+                // 被行情推送提前唤醒时保持原定的下一个周期点，避免周期被推迟
                 auto now = std::chrono::steady_clock::now();
-                if (next < now) {
-                    next = now + interval;
+                if (next <= now) {
+                    next += interval;
+                    if (next < now) {
+                        next = now + interval;
+                    }
                 }
-                std::this_thread::sleep_until(next);
+                module->wait_next_tick(ctx, next);
             }
         });
     }
 
     main_logger->info("[RUN] modules started; Ctrl+C to stop");
 
+    // 持仓台账由成交/撤单推送维护，这里定期与柜台对账
+    const int reconcile_sec = config.get_trading_position_reconcile_sec();
+    auto next_reconcile = std::chrono::steady_clock::now() + std::chrono::seconds(reconcile_sec);
     while (!ctx.stop.load()) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (reconcile_sec > 0 && std::chrono::steady_clock::now() >= next_reconcile) {
+            size_t drifted = trading->reconcile_positions();
+            if (drifted > 0) {
+                main_logger->warn_f("[POS] reconcile: %zu symbols drifted", drifted);
+            }
+            next_reconcile = std::chrono::steady_clock::now() + std::chrono::seconds(reconcile_sec);
+        }
     }
 
     main_logger->warn("[STOP] stopping...");
@@ -651,7 +696,43 @@ int main(int argc, char** argv) {
         dispatcher.join();
     }
 
+    static const char* const kLaneNames[] = {"cancel", "order", "query"};
+    for (int i = 0; i < QueuedTradingApi::kLaneCount; ++i) {
+        auto stats = trading->lane_stats(static_cast<QueuedTradingApi::Lane>(i));
+        main_logger->info_f("[QUEUE] lane=%s calls=%llu avg_wait_us=%llu max_wait_us=%llu",
+                            kLaneNames[i], static_cast<unsigned long long>(stats.count),
+                            static_cast<unsigned long long>(stats.count ? stats.total_wait_us / stats.count : 0),
+                            static_cast<unsigned long long>(stats.max_wait_us));
+    }
+    main_logger->info_f("[QUEUE] coalesced_queries=%llu",
+                        static_cast<unsigned long long>(trading->coalesced_queries()));
+    auto ev_stats = router.stats();
+    main_logger->info_f("[EVENT] dispatched=%llu avg_us=%llu max_us=%llu full_waits=%llu",
+                        static_cast<unsigned long long>(ev_stats.count),
+                        static_cast<unsigned long long>(ev_stats.count ? ev_stats.total_us / ev_stats.count : 0),
+                        static_cast<unsigned long long>(ev_stats.max_us),
+                        static_cast<unsigned long long>(ev_stats.full_waits));
+
+#ifdef SELL_WITH_SIM
+    if (sim) {
+        auto sim_stats = sim->stats();
+        main_logger->info_f("[SIM] orders=%llu fills=%llu cancels=%llu rejects=%llu max_lag_us=%llu",
+                            static_cast<unsigned long long>(sim_stats.orders),
+                            static_cast<unsigned long long>(sim_stats.fills),
+                            static_cast<unsigned long long>(sim_stats.cancels),
+                            static_cast<unsigned long long>(sim_stats.rejects),
+                            static_cast<unsigned long long>(sim_stats.max_lag_us));
+    }
+#endif
+
     market->disconnect();
+    if (!record_dir.empty()) {
+        auto rec_stats = market->recording_stats();
+        main_logger->info_f("[REC] records=%llu bytes=%llu dropped=%llu",
+                            static_cast<unsigned long long>(rec_stats.records),
+                            static_cast<unsigned long long>(rec_stats.bytes),
+                            static_cast<unsigned long long>(rec_stats.dropped));
+    }
     trading->disconnect();
     trading->shutdown();
 
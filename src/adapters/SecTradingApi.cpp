@@ -4,6 +4,9 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
 #include <thread>
 #include <cstring>
 #include <vector>
@@ -126,7 +129,9 @@ std::mutex SecTradingApi::instances_mutex_;
 SecTradingApi::SecTradingApi() 
     : is_connected_(false),
       dry_run_mode_(false),
-      order_id_counter_(100000) {
+      async_entry_(false),
+      order_id_counter_(100000),
+      kfsbdbh_counter_(0) {
 }
 
 SecTradingApi::~SecTradingApi() {
@@ -219,6 +224,21 @@ bool SecTradingApi::connect(const std::string& host, int port,
     // ==================== 5. 设置回调函数（登录成功后）====================
     std::cout << "[SEC] Setting callbacks..." << std::endl;
     SECITPDK_SetStructMsgCallback(OnStructMsgCallback);
+    SECITPDK_SetStructOrderFuncCallback(OnOrderAsyncCallback);  // 异步委托确认
+
+    // 开发商本地编号按当日时间起算（HHMMSS * 100000），重启后不会与当日已用编号冲突
+    {
+        std::time_t now_c = std::time(nullptr);
+        std::tm local_tm;
+#ifdef _WIN32
+        localtime_s(&local_tm, &now_c);
+#else
+        localtime_r(&now_c, &local_tm);
+#endif
+        std::lock_guard<std::mutex> lock(id_mutex_);
+        kfsbdbh_counter_ = static_cast<int64_t>(local_tm.tm_hour * 10000 + local_tm.tm_min * 100 +
+                                                local_tm.tm_sec) * 100000;
+    }
     
     // ==================== 6. 查询并缓存股东号 ====================
     std::cout << "[SEC] Querying shareholder accounts..." << std::endl;
@@ -261,34 +281,54 @@ void SecTradingApi::set_dry_run(bool enable) {
     }
 }
 
-std::string SecTradingApi::place_order(const OrderRequest& req) {
-    if (!is_connected_) {
-        std::cerr << "[SEC] Not connected" << std::endl;
-        return "";
+bool SecTradingApi::resolve_route(const OrderRequest& req, InstrumentId& instrument, const InstrumentInfo*& info,
+                                  std::string& market, std::string& account) const {
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    instrument = req.instrument;
+    if (instrument == kInvalidInstrument) {
+        instrument = registry.intern(req.symbol);
+    }
+    info = registry.info(instrument);
+    if (!info) {
+        std::cerr << "[SEC] Invalid symbol format: " << req.symbol << " (instrument=" << req.instrument << ")" << std::endl;
+        return false;
     }
     
-    // 确定市场和股东号
-    std::string market;
-    std::string account;
-    
-    if (req.symbol.find(".SH") != std::string::npos) {
+    if (std::strcmp(info->market, "SH") == 0) {
         market = "SH";
         account = sh_account_;
-    } else if (req.symbol.find(".SZ") != std::string::npos) {
+    } else if (std::strcmp(info->market, "SZ") == 0) {
         market = "SZ";
         account = sz_account_;
     } else {
-        std::cerr << "[SEC] Invalid symbol format: " << req.symbol << std::endl;
-        return "";
+        std::cerr << "[SEC] Invalid symbol format: " << info->symbol << std::endl;
+        return false;
     }
     
     if (account.empty()) {
         std::cerr << "[SEC] Shareholder account not found for market: " << market << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string SecTradingApi::place_order(const OrderRequest& req) {
+    if (!is_connected_) {
+        std::cerr << "[SEC] Not connected" << std::endl;
+        return "";
+    }
+    
+    // 确定市场和股东号（优先使用注册表中预解析的代码/市场）
+    InstrumentId instrument = kInvalidInstrument;
+    const InstrumentInfo* info = nullptr;
+    std::string market;
+    std::string account;
+    if (!resolve_route(req, instrument, info, market, account)) {
         return "";
     }
     
-    // 提取股票代码（去掉市场后缀）
-    std::string stock_code = req.symbol.substr(0, req.symbol.find('.'));
+    // 股票代码（去掉市场后缀）
+    std::string stock_code = info->code;
     
     // ===== DRY-RUN 模式：使用跌停价买入后立即撤单（测试连接） =====
     if (dry_run_mode_) {
@@ -314,8 +354,7 @@ std::string SecTradingApi::place_order(const OrderRequest& req) {
         
         if (sys_id > 0) {
             std::cout << "[SEC] [DRY-RUN] 测试订单已提交，sys_id: " << sys_id << std::endl;
-            // 等待1秒，然后撤单
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            // 同步委托已返回委托号，直接撤单
             int64_t cancel_ret = SECITPDK_OrderWithdraw(account_id_.c_str(), market.c_str(), sys_id);
             if (cancel_ret > 0) {
                 std::cout << "[SEC] [DRY-RUN] ✓ 测试订单已撤单，交易接口连接正常！" << std::endl;
@@ -339,9 +378,64 @@ std::string SecTradingApi::place_order(const OrderRequest& req) {
               << " " << ((trade_type == JYLB_BUY) ? "BUY" : "SELL")
               << " " << req.volume << "@" << req.price << std::endl;
     
+    const int order_side = (trade_type == JYLB_BUY) ? 0 : 1;
+    
     // 生成本地订单ID
     std::string local_id = generate_order_id();
     
+    // ===== 异步模式：先登记本地订单再发出请求，确认/推送按开发商本地编号关联 =====
+    if (async_entry_) {
+        int64_t kfsbdbh = generate_kfsbdbh();
+        {
+            std::lock_guard<std::mutex> lock(orders_mutex_);
+            OrderRecord& order = orders_.create(local_id, instrument, req.tag, req.remark);
+            order.volume = req.volume;
+            order.price = req.price;
+            order.side = order_side;
+            order.order_type = order_type;
+            order.entrust_type = trade_type;
+            orders_.bind_kfsbdbh(order, kfsbdbh);
+        }
+        positions_.on_order(instrument, order_side, req.volume);
+
+        int64_t ret = SECITPDK_OrderEntrust_ASync(
+            account_id_.c_str(),
+            market.c_str(),
+            stock_code.c_str(),
+            trade_type,
+            req.volume,
+            req.price,
+            order_type,
+            account.c_str(),
+            kfsbdbh
+        );
+
+        if (ret < 0) {
+            char error_msg[256] = {0};
+            SECITPDK_GetLastError(error_msg);
+            std::cerr << "[SEC] Async order failed: " << error_msg << std::endl;
+            positions_.on_release(instrument, order_side, req.volume);
+            std::lock_guard<std::mutex> lock(orders_mutex_);
+            orders_.erase(local_id);
+            return "";
+        }
+
+        std::cout << "[SEC] Async order sent, kfsbdbh: " << kfsbdbh << ", local_id: " << local_id << std::endl;
+        return local_id;
+    }
+    
+    // ===== 同步模式：同样先登记本地订单再调用，委托号返回后补登 =====
+    {
+        std::lock_guard<std::mutex> lock(orders_mutex_);
+        OrderRecord& order = orders_.create(local_id, instrument, req.tag, req.remark);
+        order.volume = req.volume;
+        order.price = req.price;
+        order.side = order_side;
+        order.order_type = order_type;
+        order.entrust_type = trade_type;
+    }
+    positions_.on_order(instrument, order_side, req.volume);
+
     // 调用下单接口（同步）
     int64_t sys_id = SECITPDK_OrderEntrust(
         account_id_.c_str(),    // 客户号
@@ -359,60 +453,212 @@ std::string SecTradingApi::place_order(const OrderRequest& req) {
         SECITPDK_GetLastError(error_msg);
         std::string error(error_msg);
         std::cerr << "[SEC] Order failed: " << error << std::endl;
+        positions_.on_release(instrument, order_side, req.volume);
+        std::lock_guard<std::mutex> lock(orders_mutex_);
+        orders_.erase(local_id);
         return "";
     }
     
     std::cout << "[SEC] Order placed successfully, sys_id: " << sys_id << ", local_id: " << local_id << std::endl;
     {
         std::lock_guard<std::mutex> lock(orders_mutex_);
-        Order& order = orders_[local_id];
-        order.order_id = local_id;
-        order.symbol = req.symbol;
-        order.volume = req.volume;
-        order.price = req.price;
-        order.status = OrderStatus::SUBMITTED;
-        order.filled_volume = 0;
-        order.filled_price = 0.0;
-        order.remark = req.remark;  // ✅ 添加备注字段
-        order.last_fill_price = 0.0;
-        order.side = (trade_type == JYLB_BUY) ? 0 : 1;
-        order.order_type = order_type;
-        order.entrust_type = trade_type;
-        sysid_to_local_[sys_id] = local_id;
+        OrderRecord* order = orders_.find(local_id);
+        if (order) {
+            orders_.bind_sys_id(*order, sys_id);
+        }
     }
     return local_id;
 }
 
-bool SecTradingApi::cancel_order(const std::string& order_id) {
+std::vector<std::string> SecTradingApi::place_orders(const std::vector<OrderRequest>& reqs) {
+    std::vector<std::string> local_ids(reqs.size());
+    if (reqs.empty()) {
+        return local_ids;
+    }
     if (!is_connected_) {
         std::cerr << "[SEC] Not connected" << std::endl;
-        return false;
+        return local_ids;
+    }
+    // dry-run / 异步模式逐笔处理（dry-run 需要改写价格并撤单，异步单本身不阻塞）
+    if (dry_run_mode_ || async_entry_) {
+        return ITradingApi::place_orders(reqs);
     }
     
-    std::string market;
-    int64_t sys_id = 0;
+    // 组装批量委托，legs[i] 对应 reqs 下标；无法路由的腿直接留空
+    std::vector<BatchOrderInfo> batch;
+    std::vector<size_t> legs;
+    std::vector<const InstrumentInfo*> infos;
+    std::vector<InstrumentId> instruments;
+    batch.reserve(reqs.size());
+    legs.reserve(reqs.size());
+    infos.reserve(reqs.size());
+    instruments.reserve(reqs.size());
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        const OrderRequest& req = reqs[i];
+        InstrumentId instrument = kInvalidInstrument;
+        const InstrumentInfo* info = nullptr;
+        std::string market;
+        std::string account;
+        if (!resolve_route(req, instrument, info, market, account)) {
+            continue;
+        }
+        BatchOrderInfo leg;
+        std::memset(&leg, 0, sizeof(leg));
+        std::strncpy(leg.Jys, market.c_str(), sizeof(leg.Jys) - 1);
+        std::strncpy(leg.Zqdm, info->code, sizeof(leg.Zqdm) - 1);
+        std::strncpy(leg.Gdh, account.c_str(), sizeof(leg.Gdh) - 1);
+        leg.Jylb = (req.side == OrderSide::Buy) ? JYLB_BUY : JYLB_SALE;
+        leg.Wtjg = req.price;
+        leg.Wtsl = req.volume;
+        leg.Ddlx = (req.order_type >= 0) ? req.order_type : (req.is_market ? 1 : 0);
+        batch.push_back(leg);
+        legs.push_back(i);
+        infos.push_back(info);
+        instruments.push_back(instrument);
+    }
+    if (batch.empty()) {
+        return local_ids;
+    }
+    
+    // 先登记各腿并冻结再调用柜台（与单笔下单一致）：调用期间到达的推送按批次号关联到本地订单
+    int64_t batch_no = generate_kfsbdbh();  // 委托批次号与开发商本地编号共用序列，保证当日唯一
+    std::vector<std::string> leg_ids(batch.size());
+    {
+        std::lock_guard<std::mutex> lock(orders_mutex_);
+        for (size_t k = 0; k < batch.size(); ++k) {
+            const BatchOrderInfo& leg = batch[k];
+            const OrderRequest& req = reqs[legs[k]];
+            leg_ids[k] = generate_order_id();
+            OrderRecord& order = orders_.create(leg_ids[k], instruments[k], req.tag, req.remark);
+            order.volume = req.volume;
+            order.price = req.price;
+            order.side = (leg.Jylb == JYLB_BUY) ? 0 : 1;
+            order.order_type = leg.Ddlx;
+            order.entrust_type = leg.Jylb;
+            orders_.bind_batch(order, batch_no);
+        }
+    }
+    for (size_t k = 0; k < batch.size(); ++k) {
+        positions_.on_order(instruments[k], batch[k].Jylb == JYLB_BUY ? 0 : 1, batch[k].Wtsl);
+    }
+
+    std::cout << "[SEC] Placing batch " << batch_no << ": " << batch.size() << " orders" << std::endl;
+    int64_t ret = SECITPDK_BatchOrderEntrust(account_id_.c_str(), batch, batch_no);
+    if (ret < 0) {
+        char error_msg[256] = {0};
+        SECITPDK_GetLastError(error_msg);
+        std::cerr << "[SEC] Batch order failed: " << error_msg << std::endl;
+    } else if (ret > 0) {
+        std::cerr << "[SEC] Batch " << batch_no << ": " << ret << " legs rejected" << std::endl;
+    }
+
+    // 逐腿补登委托号：Wth>0 为柜台委托号，否则为错误码。调用期间的推送可能已把委托号
+    // 登记到同批次中另一条代码/方向/数量/价格都相同的腿上，此时该请求取那条本地订单，
+    // 自己的记录留给同样的另一腿；最后仍未登记委托号的记录即失败的腿，回滚
+    std::vector<bool> rollback(batch.size(), false);
     {
         std::lock_guard<std::mutex> lock(orders_mutex_);
-        for (const auto& kv : sysid_to_local_) {
-            if (kv.second == order_id) {
-                sys_id = kv.first;
+        std::vector<OrderRecord*> records(batch.size(), nullptr);
+        for (size_t k = 0; k < batch.size(); ++k) {
+            records[k] = orders_.find(leg_ids[k]);
+        }
+        std::vector<bool> claimed(batch.size(), false);
+        std::vector<OrderRecord*> owners(batch.size(), nullptr);
+        for (size_t k = 0; k < batch.size(); ++k) {
+            if (ret < 0 || batch[k].Wth <= 0) {
+                continue;
+            }
+            OrderRecord* bound = orders_.find_by_sys_id(batch[k].Wth);
+            for (size_t j = 0; bound && j < batch.size(); ++j) {
+                if (records[j] == bound) {
+                    owners[k] = bound;
+                    claimed[j] = true;
+                }
+            }
+        }
+        for (size_t k = 0; k < batch.size(); ++k) {
+            if (ret < 0 || batch[k].Wth <= 0 || owners[k]) {
+                continue;
+            }
+            for (size_t n = 0; n < batch.size(); ++n) {
+                size_t j = (k + n) % batch.size();  // 优先自己的记录
+                OrderRecord* rec = records[j];
+                if (claimed[j] || !rec || rec->sys_id != 0 || rec->instrument != instruments[k] ||
+                    rec->entrust_type != batch[k].Jylb || rec->volume != batch[k].Wtsl ||
+                    std::fabs(rec->price - batch[k].Wtjg) > 1e-6) {
+                    continue;
+                }
+                orders_.bind_sys_id(*rec, batch[k].Wth);
+                owners[k] = rec;
+                claimed[j] = true;
                 break;
             }
         }
-        auto it = orders_.find(order_id);
-        if (it != orders_.end()) {
-            if (it->second.symbol.find(".SH") != std::string::npos) {
-                market = "SH";
-            } else if (it->second.symbol.find(".SZ") != std::string::npos) {
-                market = "SZ";
+        for (size_t k = 0; k < batch.size(); ++k) {
+            if (owners[k]) {
+                local_ids[legs[k]] = owners[k]->order_id;
+            } else if (ret >= 0) {
+                std::cerr << "[SEC] Batch leg failed: " << infos[k]->symbol << " code=" << batch[k].Wth
+                          << " msg=" << batch[k].Msg << std::endl;
             }
+            if (!claimed[k] && records[k] && records[k]->sys_id == 0) {
+                orders_.erase(leg_ids[k]);
+                rollback[k] = true;
+            }
+        }
+    }
+    for (size_t k = 0; k < batch.size(); ++k) {
+        if (rollback[k]) {
+            positions_.on_release(instruments[k], batch[k].Jylb == JYLB_BUY ? 0 : 1, batch[k].Wtsl);
         }
     }
-    if (market.empty() || sys_id == 0) {
+    return local_ids;
+}
+
+OrderRecord* SecTradingApi::find_batch_leg(const stStructMsg& msg) {
+    if (msg.BatchNo <= 0) {
+        return nullptr;
+    }
+    std::vector<OrderRecord*> legs;
+    orders_.find_by_batch(msg.BatchNo, legs);
+    for (OrderRecord* leg : legs) {
+        const InstrumentInfo* info = InstrumentRegistry::instance().info(leg->instrument);
+        if (leg->sys_id == 0 && info && std::strcmp(info->code, msg.StockCode) == 0 &&
+            std::strcmp(info->market, msg.Market) == 0 && leg->entrust_type == msg.EntrustType &&
+            leg->volume == msg.OrderQty && std::fabs(leg->price - msg.OrderPrice) <= 1e-6) {
+            return leg;
+        }
+    }
+    return nullptr;
+}
+
+bool SecTradingApi::cancel_order(const std::string& order_id) {
+    if (!is_connected_) {
+        std::cerr << "[SEC] Not connected" << std::endl;
+        return false;
+    }
+    
+    std::string market;
+    int64_t sys_id = 0;
+    int64_t kfsbdbh = 0;
+    {
+        std::lock_guard<std::mutex> lock(orders_mutex_);
+        const OrderRecord* order = orders_.find(order_id);
+        const InstrumentInfo* info = order ? InstrumentRegistry::instance().info(order->instrument) : nullptr;
+        if (info) {
+            sys_id = order->sys_id;
+            kfsbdbh = order->kfsbdbh;
+            market = info->market;
+        }
+    }
+    if (market.empty() || (sys_id == 0 && kfsbdbh == 0)) {
         std::cerr << "[SEC] Cannot determine market/sys_id for order: " << order_id << std::endl;
         return false;
     }
-    int64_t nRet = SECITPDK_OrderWithdraw(account_id_.c_str(), market.c_str(), sys_id);
+    // 异步单尚未收到柜台委托号时按开发商本地编号撤单
+    int64_t nRet = (sys_id != 0)
+        ? SECITPDK_OrderWithdraw(account_id_.c_str(), market.c_str(), sys_id)
+        : SECITPDK_OrderWithdrawByKFSBDBH(account_id_.c_str(), market.c_str(), kfsbdbh);
     
     if (nRet <= 0) {
         char error_msg[256] = {0};
@@ -427,25 +673,131 @@ bool SecTradingApi::cancel_order(const std::string& order_id) {
     // 更新订单状态
     {
         std::lock_guard<std::mutex> lock(orders_mutex_);
-        auto it = orders_.find(order_id);
-        if (it != orders_.end()) {
-            it->second.status = OrderStatus::CANCELING;
+        OrderRecord* order = orders_.find(order_id);
+        if (order) {
+            set_state(*order, OrderState::CANCEL_PENDING);
         }
     }
     
     return true;
 }
 
-std::vector<Position> SecTradingApi::query_positions() {
+std::vector<bool> SecTradingApi::cancel_orders(const std::vector<std::string>& order_ids) {
+    std::vector<bool> results(order_ids.size(), false);
+    if (order_ids.empty()) {
+        return results;
+    }
     if (!is_connected_) {
         std::cerr << "[SEC] Not connected" << std::endl;
+        return results;
+    }
+    
+    // 按委托批次归组：批次内所有未终结的订单都在撤单列表中时，整批一次撤单
+    std::map<int64_t, std::vector<size_t>> by_batch;
+    {
+        std::lock_guard<std::mutex> lock(orders_mutex_);
+        for (size_t i = 0; i < order_ids.size(); ++i) {
+            const OrderRecord* order = orders_.find(order_ids[i]);
+            if (order && order->batch_no > 0 && order->live) {
+                by_batch[order->batch_no].push_back(i);
+            }
+        }
+        std::vector<OrderRecord*> legs;
+        for (auto it = by_batch.begin(); it != by_batch.end();) {
+            legs.clear();
+            orders_.find_by_batch(it->first, legs);
+            size_t live_count = 0;
+            for (const OrderRecord* leg : legs) {
+                if (leg->live) {
+                    ++live_count;
+                }
+            }
+            if (live_count != it->second.size()) {
+                it = by_batch.erase(it);  // 只撤批次中的一部分，走逐笔撤单
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    std::vector<bool> handled(order_ids.size(), false);
+    for (const auto& kv : by_batch) {
+        // nLSH 为 0 表示撤全部委托，批次号必须非 0
+        int64_t nRet = SECITPDK_BatchOrderWithdraw(account_id_.c_str(), kv.first);
+        if (nRet <= 0) {
+            char error_msg[256] = {0};
+            SECITPDK_GetLastError(error_msg);
+            std::cerr << "[SEC] Batch cancel failed (batch " << kv.first << "): " << error_msg
+                      << ", falling back to single cancels" << std::endl;
+            continue;
+        }
+        std::cout << "[SEC] Batch cancel submitted: batch " << kv.first << ", "
+                  << kv.second.size() << " orders" << std::endl;
+        std::lock_guard<std::mutex> lock(orders_mutex_);
+        for (size_t i : kv.second) {
+            results[i] = true;
+            handled[i] = true;
+            OrderRecord* order = orders_.find(order_ids[i]);
+            if (order) {
+                set_state(*order, OrderState::CANCEL_PENDING);
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < order_ids.size(); ++i) {
+        if (!handled[i]) {
+            results[i] = cancel_order(order_ids[i]);
+        }
+    }
+    return results;
+}
+
+std::vector<Position> SecTradingApi::query_positions() {
+    std::vector<Position> result;
+    if (positions_.seeded()) {
+        return positions_.snapshot();
+    }
+    if (!fetch_positions(result)) {
         return {};
     }
+    positions_.seed(result);
+    return result;
+}
+
+bool SecTradingApi::query_positions_local(std::vector<Position>& out) {
+    if (!positions_.seeded()) {
+        return false;
+    }
+    out = positions_.snapshot();
+    return true;
+}
+
+size_t SecTradingApi::reconcile_positions() {
+    std::vector<Position> counter;
+    uint64_t since = positions_.version();  // 查询期间到达的推送不被柜台结果覆盖
+    if (!fetch_positions(counter)) {
+        return 0;
+    }
+    std::vector<std::string> drift;
+    size_t drifted = positions_.reconcile(counter, since, &drift);
+    for (const auto& line : drift) {
+        std::cerr << "[SEC] Position drift: " << line << std::endl;
+    }
+    std::cout << "[SEC] Positions reconciled: " << counter.size() << " symbols, "
+              << drifted << " drifted" << std::endl;
+    return drifted;
+}
+
+bool SecTradingApi::fetch_positions(std::vector<Position>& result) {
+    if (!is_connected_) {
+        std::cerr << "[SEC] Not connected" << std::endl;
+        return false;
+    }
     
     std::cout << "[SEC] Querying positions..." << std::endl;
     
     // 分页查询持仓：设置单页条数，使用 BrowIndex 继续翻页
-    std::vector<Position> result;
+    result.clear();
     std::vector<ITPDK_ZQGL> page;
     const int rowcount = 200;       // 单页条数（根据柜台上限可调整）
     int64_t brow_index = 0;         // 0 表示从第一页开始
@@ -472,7 +824,7 @@ std::vector<Position> SecTradingApi::query_positions() {
             std::string error(error_msg);
             std::cerr << "[SEC] Query positions failed on page " << page_no
                       << ": " << error << std::endl;
-            return {};
+            return false;
         }
 
         if (nRet == 0) {
@@ -521,23 +873,20 @@ std::vector<Position> SecTradingApi::query_positions() {
     }
 
     std::cout << "[SEC] Total positions aggregated: " << result.size() << std::endl;
-
-    // 缓存持仓
-    {
-        std::lock_guard<std::mutex> lock(positions_mutex_);
-        positions_cache_ = result;
-    }
-    
-    return result;
+    return true;
 }
 
-std::vector<OrderResult> SecTradingApi::query_orders() {
+bool SecTradingApi::fetch_orders(const std::string& market, const std::string& code, int64_t wth,
+                                 int64_t kfsbdbh, std::vector<OrderResult>& result) {
     if (!is_connected_) {
         std::cerr << "[SEC] Not connected" << std::endl;
-        return {};
+        return false;
     }
     
-    std::cout << "[SEC] Querying orders from API..." << std::endl;
+    std::cout << "[SEC] Querying orders from API..."
+              << (code.empty() ? "" : " zqdm=" + code)
+              << (wth != 0 ? " wth=" + std::to_string(wth) : "")
+              << (kfsbdbh != 0 ? " kfsbdbh=" + std::to_string(kfsbdbh) : "") << std::endl;
     
     std::vector<ITPDK_DRWT> all_orders;
     std::vector<ITPDK_DRWT> page;
@@ -548,17 +897,18 @@ std::vector<OrderResult> SecTradingApi::query_orders() {
     while (true) {
         page.clear();
         // 参数: khh, nType(0=当日), nSortType, nRowcount, nBrowindex,
-        //       jys(空=全部), zqdm(空=全部), lWth(0=全部), arDrwt, nKFSBDBH
+        //       jys(空=全部), zqdm(空=全部), lWth(0=全部), arDrwt, nKFSBDBH(0=全部)
         int64_t nRet = SECITPDK_QueryOrders(
             account_id_.c_str(),  // 客户号
             0,                    // 查询类型：0=当日委托
             0,                    // 排序类型
             rowcount,             // 请求行数
             brow_index,           // 定位串
-            "",                   // 交易所（空=全部）
-            "",                   // 证券代码（空=全部）
-            0,                    // 委托号（0=全部）
-            page                  // 返回结果
+            market.c_str(),       // 交易所（空=全部）
+            code.c_str(),         // 证券代码（空=全部）
+            wth,                  // 委托号（0=全部）
+            page,                 // 返回结果
+            kfsbdbh               // 开发商本地编号（0=全部）
         );
 
         if (nRet < 0) {
@@ -566,7 +916,7 @@ std::vector<OrderResult> SecTradingApi::query_orders() {
             SECITPDK_GetLastError(error_msg);
             std::string error(error_msg);
             std::cerr << "[SEC] Query orders failed: " << error << std::endl;
-            return {};
+            return false;
         }
         if (nRet == 0) {
             break;
@@ -590,7 +940,7 @@ std::vector<OrderResult> SecTradingApi::query_orders() {
     std::cout << "[SEC] Found " << all_orders.size() << " orders from API" << std::endl;
     
     // 转换API返回的数据为 OrderResult 格式
-    std::vector<OrderResult> result;
+    result.clear();
     result.reserve(all_orders.size());
     
     for (const auto& api_order : all_orders) {
@@ -632,20 +982,24 @@ std::vector<OrderResult> SecTradingApi::query_orders() {
         // 关联本地id
         {
             std::lock_guard<std::mutex> lock(orders_mutex_);
-            auto local_it = sysid_to_local_.find(api_order.OrderId);
-            if (local_it != sysid_to_local_.end()) {
-                const std::string& local_id = local_it->second;
-                order_result.order_id = local_id;  // 用本地ID，便于撤单
-                auto ord_it = orders_.find(local_id);
-                if (ord_it != orders_.end()) {
-                    order_result.remark = ord_it->second.remark;
-                    order_result.filled_price = ord_it->second.filled_price;
-                    order_result.last_fill_price = ord_it->second.last_fill_price;
-                    order_result.side = ord_it->second.side;
-                    order_result.order_type = ord_it->second.order_type;
-                    order_result.entrust_type = ord_it->second.entrust_type;
-                    order_result.is_local = true;
+            OrderRecord* local = orders_.find_by_sys_id(api_order.OrderId);
+            if (!local && api_order.KFSBDBH != 0) {
+                // 异步委托的确认回调尚未到达时，按开发商本地编号关联并补登委托号
+                local = orders_.find_by_kfsbdbh(api_order.KFSBDBH);
+                if (local) {
+                    orders_.bind_sys_id(*local, api_order.OrderId);
                 }
+            }
+            if (local) {
+                order_result.order_id = local->order_id;  // 用本地ID，便于撤单
+                order_result.remark = local->remark;
+                order_result.tag = local->tag;
+                order_result.filled_price = local->filled_price;
+                order_result.last_fill_price = local->last_fill_price;
+                order_result.side = local->side;
+                order_result.order_type = local->order_type;
+                order_result.entrust_type = local->entrust_type;
+                order_result.is_local = true;
             } else {
                 order_result.remark = "";
             }
@@ -665,64 +1019,90 @@ std::vector<OrderResult> SecTradingApi::query_orders() {
         std::lock_guard<std::mutex> lock(orders_mutex_);
         for (const auto& order : result) {
             // 如果内存中已有该订单，更新状态
-            auto it = orders_.find(order.order_id);
-            if (it != orders_.end()) {
-                // 更新已有订单的状态
-                it->second.filled_volume = order.filled_volume;
+            OrderRecord* local = order.is_local ? orders_.find(order.order_id) : nullptr;
+            if (local) {
+                // 更新已有订单的状态（成交量只增不减，终态不被覆盖）
+                if (order.filled_volume > local->filled_volume) {
+                    credit_fill(*local, order.filled_volume - local->filled_volume);
+                    local->filled_volume = order.filled_volume;
+                }
                 if (order.status == OrderResult::Status::FILLED) {
-                    it->second.status = OrderStatus::FILLED;
+                    set_state(*local, OrderState::FILLED);
                 } else if (order.status == OrderResult::Status::PARTIAL) {
-                    it->second.status = OrderStatus::PARTIAL;
+                    set_state(*local, OrderState::PARTIAL);
                 } else if (order.status == OrderResult::Status::CANCELLED) {
-                    it->second.status = OrderStatus::CANCELLED;
+                    set_state(*local, OrderState::CANCELLED);
                 } else if (order.status == OrderResult::Status::REJECTED) {
-                    it->second.status = OrderStatus::REJECTED;
+                    set_state(*local, OrderState::REJECTED);
                 }
             }
         }
     }
     
+    return true;
+}
+
+std::vector<OrderResult> SecTradingApi::query_orders() {
+    std::vector<OrderResult> result;
+    fetch_orders("", "", 0, 0, result);
+    return result;
+}
+
+std::vector<OrderResult> SecTradingApi::query_orders(const std::string& symbol) {
+    std::vector<OrderResult> result;
+    size_t dot = symbol.find('.');
+    if (dot == std::string::npos) {
+        return result;
+    }
+    fetch_orders(symbol.substr(dot + 1), symbol.substr(0, dot), 0, 0, result);
     return result;
 }
 
 OrderResult SecTradingApi::query_order(const std::string& order_id) {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
-    
-        auto it = orders_.find(order_id); // Changed to use string directly
-    
-    if (it != orders_.end()) {
-        OrderResult result;
-        result.success = true;
-        result.order_id = order_id;
-        result.symbol = it->second.symbol;
-        result.volume = it->second.volume;
-        result.filled_volume = it->second.filled_volume;
-        result.filled_price = it->second.filled_price;
-        result.last_fill_price = it->second.last_fill_price;
-        result.price = it->second.price;
-        result.remark = it->second.remark;
-        result.side = it->second.side;
-        result.order_type = it->second.order_type;
-        result.entrust_type = it->second.entrust_type;
-        result.is_local = true;
-        
-        // 转换字符串状态到枚举
-        const std::string& status_str = it->second.status;
-        if (status_str == "submitted" || status_str == "accepted") {
-            result.status = OrderResult::Status::SUBMITTED;
-        } else if (status_str == "partial_filled") {
-            result.status = OrderResult::Status::PARTIAL;
-        } else if (status_str == "filled") {
-            result.status = OrderResult::Status::FILLED;
-        } else if (status_str == "canceled" || status_str == "canceling") {
-            result.status = OrderResult::Status::CANCELLED;
-        } else if (status_str == "rejected") {
-            result.status = OrderResult::Status::REJECTED;
+    // 按委托号（或异步委托尚未确认时按开发商本地编号）做单行查询，刷新本地订单后返回
+    std::string market;
+    std::string code;
+    int64_t wth = 0;
+    int64_t kfsbdbh = 0;
+    {
+        std::lock_guard<std::mutex> lock(orders_mutex_);
+        const OrderRecord* order = orders_.find(order_id);
+        if (order) {
+            const std::string& symbol = order->symbol();
+            size_t dot = symbol.find('.');
+            if (dot != std::string::npos) {
+                code = symbol.substr(0, dot);
+                market = symbol.substr(dot + 1);
+            }
+            wth = order->sys_id;
+            kfsbdbh = wth == 0 ? order->kfsbdbh : 0;
         } else {
-            result.status = OrderResult::Status::UNKNOWN;
+            // 非本地订单：order_id 即柜台委托号
+            char* end = nullptr;
+            wth = std::strtoll(order_id.c_str(), &end, 10);
+            if (end == order_id.c_str() || *end != '\0') {
+                wth = 0;
+            }
+        }
+    }
+
+    std::vector<OrderResult> rows;
+    if ((wth != 0 || kfsbdbh != 0) && fetch_orders(market, code, wth, kfsbdbh, rows)) {
+        for (const auto& row : rows) {
+            if (row.order_id == order_id) {
+                return row.is_local ? local_order(order_id) : row;
+            }
         }
-        
-        return result;
+    }
+    return local_order(order_id);
+}
+
+OrderResult SecTradingApi::local_order(const std::string& order_id) {
+    std::lock_guard<std::mutex> lock(orders_mutex_);
+    
+    const OrderRecord* order = orders_.find(order_id);
+    if (order) {
+        return to_order_result(*order);
     }
     
     // 订单未找到
@@ -732,22 +1112,57 @@ OrderResult SecTradingApi::query_order(const std::string& order_id) {
     return result;
 }
 
+bool SecTradingApi::query_order_state(const std::string& order_id, OrderState& state) {
+    std::lock_guard<std::mutex> lock(orders_mutex_);
+    const OrderRecord* order = orders_.find(order_id);
+    if (!order) {
+        return false;
+    }
+    state = order->state.load(std::memory_order_acquire);
+    return true;
+}
+
+bool SecTradingApi::query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) {
+    std::vector<const OrderRecord*> records;
+    std::lock_guard<std::mutex> lock(orders_mutex_);
+    orders_.live_orders(instrument, records);
+    for (const OrderRecord* order : records) {
+        out.push_back(to_order_result(*order));
+    }
+    return true;
+}
+
+bool SecTradingApi::query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) {
+    std::vector<const OrderRecord*> records;
+    std::lock_guard<std::mutex> lock(orders_mutex_);
+    orders_.find_by_tag(tag_key, records);
+    for (const OrderRecord* order : records) {
+        out.push_back(to_order_result(*order));
+    }
+    return true;
+}
+
+bool SecTradingApi::order_route(const std::string& order_id, std::string& account, std::string& symbol) {
+    std::lock_guard<std::mutex> lock(orders_mutex_);
+    const OrderRecord* order = orders_.find(order_id);
+    if (!order) {
+        return false;
+    }
+    account = account_id_;
+    symbol = order->symbol();
+    return true;
+}
+
 OrderResult SecTradingApi::wait_order(const std::string& order_id, int timeout_ms) {
     auto start = std::chrono::steady_clock::now();
     
     while (true) {
-        OrderResult order = query_order(order_id);
-        
-        // 订单未找到
-        if (!order.success) {
-            return order;
-        }
+        OrderState state = OrderState::PENDING;
         
-        // 检查订单是否完成
-        if (order.status == OrderResult::Status::FILLED || 
-            order.status == OrderResult::Status::CANCELLED || 
-            order.status == OrderResult::Status::REJECTED) {
-            return order;
+        // 订单未找到 / 已完成（成交、撤单、废单或撤单已发出）
+        if (!query_order_state(order_id, state) || is_terminal(state) ||
+            state == OrderState::CANCEL_PENDING) {
+            return local_order(order_id);
         }
         
         // 检查超时
@@ -763,7 +1178,7 @@ OrderResult SecTradingApi::wait_order(const std::string& order_id, int timeout_m
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
-    return query_order(order_id);
+    return local_order(order_id);
 }
 
 // 静态回调函数
@@ -800,9 +1215,9 @@ void SecTradingApi::OnStructMsgCallback(const char* pTime, stStructMsg& stMsg, i
 }
 
 void SecTradingApi::OnOrderAsyncCallback(const char* pTime, stStructOrderFuncMsg& stMsg, int nType) {
-    std::string account_id(stMsg.AccountId);
+    std::string account_id = trim_copy(std::string(stMsg.AccountId));
     
-    // 查找对应的实例
+    // 查找对应的实例（account_id -> single instance 兜底）
     SecTradingApi* instance = nullptr;
     {
         std::lock_guard<std::mutex> lock(instances_mutex_);
@@ -810,33 +1225,21 @@ void SecTradingApi::OnOrderAsyncCallback(const char* pTime, stStructOrderFuncMsg
         if (it != instances_by_account_.end()) {
             instance = it->second;
         }
+        if (!instance && instances_.size() == 1) {
+            instance = instances_.begin()->second;
+        }
     }
     
     if (instance) {
         instance->handle_order_async(pTime, stMsg, nType);
+        return;
     }
+
+    std::cerr << "[SEC] Async callback dropped (no instance): account=" << account_id
+              << " kfsbdbh=" << stMsg.KFSBDBH << std::endl;
 }
 
 void SecTradingApi::handle_struct_msg(const char* pTime, stStructMsg& stMsg, int nType) {
-    auto to_status = [](const std::string& status_str) -> OrderResult::Status {
-        if (status_str == OrderStatus::SUBMITTED || status_str == OrderStatus::ACCEPTED) {
-            return OrderResult::Status::SUBMITTED;
-        }
-        if (status_str == OrderStatus::PARTIAL) {
-            return OrderResult::Status::PARTIAL;
-        }
-        if (status_str == OrderStatus::FILLED) {
-            return OrderResult::Status::FILLED;
-        }
-        if (status_str == OrderStatus::CANCELLED || status_str == OrderStatus::CANCELING) {
-            return OrderResult::Status::CANCELLED;
-        }
-        if (status_str == OrderStatus::REJECTED) {
-            return OrderResult::Status::REJECTED;
-        }
-        return OrderResult::Status::UNKNOWN;
-    };
-
     int64_t sys_id = stMsg.OrderId;
     std::string symbol = stMsg.StockCode;
 
@@ -845,53 +1248,61 @@ void SecTradingApi::handle_struct_msg(const char* pTime, stStructMsg& stMsg, int
     bool is_local = false;
     {
         std::lock_guard<std::mutex> lock(orders_mutex_);
-        auto it_local = sysid_to_local_.find(sys_id);
-        if (it_local != sysid_to_local_.end()) {
-            auto it = orders_.find(it_local->second);
-            if (it == orders_.end()) return;
-            Order& order = it->second;
-
+        OrderRecord* order = orders_.find_by_sys_id(sys_id);
+        if (!order) {
+            // 推送先于异步确认到达：按开发商本地编号关联并补登柜台委托号
+            int64_t kfsbdbh = std::strtoll(stMsg.KFSBDBH, nullptr, 10);
+            order = (kfsbdbh > 0) ? orders_.find_by_kfsbdbh(kfsbdbh) : nullptr;
+            if (!order) {
+                // 推送先于批量委托返回到达：按批次号关联到尚未登记委托号的对应腿
+                order = find_batch_leg(stMsg);
+            }
+            if (order) {
+                orders_.bind_sys_id(*order, sys_id);
+            }
+        }
+        if (order) {
+            bool applied = false;
             if (nType == NOTIFY_PUSH_ORDER) {
                 std::cout << "[SEC] Order confirmed: " << sys_id << " (" << symbol << ")" << std::endl;
-                order.status = OrderStatus::ACCEPTED;
+                applied = set_state(*order, OrderState::ACCEPTED);
             } else if (nType == NOTIFY_PUSH_MATCH) {
                 std::cout << "[SEC] Order matched: " << sys_id << " (" << symbol << ")"
                           << " qty=" << stMsg.MatchQty << " price=" << stMsg.MatchPrice << std::endl;
 
-                double total_value = order.filled_price * order.filled_volume +
-                                     stMsg.MatchPrice * stMsg.MatchQty;
-                order.filled_volume += stMsg.MatchQty;
-                order.filled_price = order.filled_volume > 0 ? total_value / order.filled_volume : 0.0;
-                order.last_fill_price = stMsg.MatchPrice;
-
-                if (order.filled_volume >= order.volume) {
-                    order.status = OrderStatus::FILLED;
-                } else {
-                    order.status = OrderStatus::PARTIAL;
+                // 按累计成交量推进；柜台未回送累计值时按本次成交累加
+                int64_t total_qty = stMsg.TotalMatchQty;
+                double total_amt = stMsg.TotalMatchAmt;
+                if (total_qty <= 0) {
+                    total_qty = order->filled_volume + stMsg.MatchQty;
+                    total_amt = order->filled_price * order->filled_volume + stMsg.MatchPrice * stMsg.MatchQty;
+                }
+                // 撤单推送之后到达的成交同样计入（终态不变）
+                int64_t prev_filled = order->filled_volume;
+                if (order->apply_fill(total_qty, total_amt, stMsg.MatchPrice)) {
+                    applied = true;
+                    if (is_terminal(order->state.load(std::memory_order_relaxed))) {
+                        std::cout << "[SEC] Late fill after terminal state: " << sys_id
+                                  << " filled=" << order->filled_volume << std::endl;
+                    }
+                    credit_fill(*order, order->filled_volume - prev_filled);
+                    set_state(*order, order->filled_volume >= order->volume ? OrderState::FILLED
+                                                                           : OrderState::PARTIAL);
                 }
             } else if (nType == NOTIFY_PUSH_WITHDRAW) {
                 std::cout << "[SEC] Order canceled: " << sys_id << " (" << symbol << ")" << std::endl;
-                order.status = OrderStatus::CANCELLED;
+                applied = set_state(*order, OrderState::CANCELLED);
             } else if (nType == NOTIFY_PUSH_INVALID) {
                 std::cout << "[SEC] Order rejected: " << sys_id << " (" << symbol << ")" << std::endl;
-                order.status = OrderStatus::REJECTED;
+                applied = set_state(*order, OrderState::REJECTED);
             }
 
-            snapshot.success = true;
-            snapshot.order_id = order.order_id;
-            snapshot.symbol = order.symbol;
-            snapshot.volume = order.volume;
-            snapshot.filled_volume = order.filled_volume;
-            snapshot.filled_price = order.filled_price;
-            snapshot.last_fill_price = order.last_fill_price;
-            snapshot.price = order.price;
-            snapshot.remark = order.remark;
-            snapshot.status = to_status(order.status);
-            snapshot.side = order.side;
-            snapshot.order_type = order.order_type;
-            snapshot.entrust_type = order.entrust_type;
-            snapshot.is_local = true;
-
+            if (!applied) {
+                // 重复或乱序到达的推送（如终态之后的确认推送）不再通知上层
+                std::cout << "[SEC] Stale push ignored: " << sys_id << " type=" << nType << std::endl;
+                return;
+            }
+            snapshot = to_order_result(*order);
             has_snapshot = true;
             is_local = true;
         }
@@ -955,25 +1366,87 @@ void SecTradingApi::handle_struct_msg(const char* pTime, stStructMsg& stMsg, int
 }
 
 void SecTradingApi::handle_order_async(const char* pTime, stStructOrderFuncMsg& stMsg, int nType) {
-    // 异步下单回调处理
-    int64_t order_id = stMsg.OrderId;
+    (void)pTime;
+    (void)nType;
+    // 异步下单确认：按开发商本地编号找到本地订单，绑定柜台委托号
+    int64_t kfsbdbh = std::strtoll(stMsg.KFSBDBH, nullptr, 10);
+    int64_t sys_id = stMsg.OrderId;
     
-    std::cout << "[SEC] Async order callback: order_id=" << order_id 
+    std::cout << "[SEC] Async order callback: kfsbdbh=" << kfsbdbh << ", order_id=" << sys_id
               << ", retcode=" << stMsg.nRetCode << std::endl;
     
-    if (stMsg.nRetCode != 0) {
-        std::string error(stMsg.sRetNote);
-        std::cerr << "[SEC] Order error: " << error << std::endl;
-        
+    OrderResult snapshot;
+    bool rejected = false;
+    {
         std::lock_guard<std::mutex> lock(orders_mutex_);
-        auto it_local = sysid_to_local_.find(order_id);
-        if (it_local != sysid_to_local_.end()) {
-            auto it = orders_.find(it_local->second);
-            if (it != orders_.end()) {
-                it->second.status = OrderStatus::REJECTED;
-            }
+        OrderRecord* order = orders_.find_by_kfsbdbh(kfsbdbh);
+        if (!order) {
+            return;  // 非本进程异步单
+        }
+        if (sys_id > 0 && stMsg.nRetCode >= 0) {
+            orders_.bind_sys_id(*order, sys_id);
+        } else {
+            std::cerr << "[SEC] Async order error: " << stMsg.sRetNote << std::endl;
+            set_state(*order, OrderState::REJECTED);
+            snapshot = to_order_result(*order);
+            snapshot.err_msg = stMsg.sRetNote;
+            rejected = true;
+        }
+    }
+
+    // 柜台拒单不会再有废单推送，这里补发给上层
+    if (rejected) {
+        OrderEventCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            callback = order_callback_;
+        }
+        if (callback) {
+            callback(snapshot, NOTIFY_PUSH_INVALID);
+        }
+    }
+}
+
+OrderResult SecTradingApi::to_order_result(const OrderRecord& order) {
+    OrderResult result;
+    result.success = true;
+    result.order_id = order.order_id;
+    result.symbol = order.symbol();
+    result.volume = order.volume;
+    result.filled_volume = order.filled_volume;
+    result.filled_price = order.filled_price;
+    result.last_fill_price = order.last_fill_price;
+    result.price = order.price;
+    result.remark = order.remark;
+    result.tag = order.tag;
+    result.side = order.side;
+    result.order_type = order.order_type;
+    result.entrust_type = order.entrust_type;
+    result.is_local = true;
+    result.status = to_result_status(order.state.load(std::memory_order_acquire));
+    return result;
+}
+
+bool SecTradingApi::set_state(OrderRecord& order, OrderState state) {
+    if (!order.transition(state)) {
+        return false;
+    }
+    // 终态订单移出活动列表；撤单/废单退回未成交部分的冻结
+    if (is_terminal(state)) {
+        orders_.retire(order);
+        if (state != OrderState::FILLED) {
+            positions_.on_release(order.instrument, order.side, order.volume - order.filled_volume);
         }
     }
+    return true;
+}
+
+void SecTradingApi::credit_fill(const OrderRecord& order, int64_t qty) {
+    if (is_terminal(order.state.load(std::memory_order_relaxed))) {
+        positions_.on_late_fill(order.instrument, order.side, qty);
+    } else {
+        positions_.on_fill(order.instrument, order.side, qty);
+    }
 }
 
 std::string SecTradingApi::generate_order_id() {
@@ -981,20 +1454,21 @@ std::string SecTradingApi::generate_order_id() {
     return std::to_string(++order_id_counter_);
 }
 
+int64_t SecTradingApi::generate_kfsbdbh() {
+    std::lock_guard<std::mutex> lock(id_mutex_);
+    return ++kfsbdbh_counter_;
+}
+
 void SecTradingApi::update_order_status(int64_t order_id, 
-                                       const std::string& status,
+                                       OrderState state,
                                        const std::string& info) {
     std::lock_guard<std::mutex> lock(orders_mutex_);
     
-    // 先找到local_id
-    auto it_local = sysid_to_local_.find(order_id);
-    if (it_local != sysid_to_local_.end()) {
-        auto it = orders_.find(it_local->second);
-        if (it != orders_.end()) {
-            it->second.status = status;
-            if (!info.empty()) {
-                std::cout << "[SEC] Order " << order_id << ": " << info << std::endl;
-            }
+    OrderRecord* order = orders_.find_by_sys_id(order_id);
+    if (order) {
+        set_state(*order, state);
+        if (!info.empty()) {
+            std::cout << "[SEC] Order " << order_id << ": " << info << std::endl;
         }
     }
 }
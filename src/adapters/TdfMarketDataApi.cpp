@@ -3,6 +3,7 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <ctime>
 #include <thread>
@@ -22,9 +23,92 @@
 #include "TDFAPI.h"
 #include "TDFAPIStruct.h"
 
-// 静态实例 map（回调用）
-static std::map<THANDLE, TdfMarketDataApi*> g_instance_map;
-static std::mutex g_instance_mutex;
+// 快照槽位预留：订阅列表之外的代码 / 全市场订阅
+static const size_t kUnlistedReserve = 256;
+static const size_t kFullMarketReserve = 8192;
+
+// 历史 tick 默认条数：快照约 3 秒一笔，1200 条约覆盖最近一小时
+static const size_t kDefaultTickHistory = 1200;
+
+// 句柄 -> 实例表（回调用）：固定槽位，回调线程无锁查找
+// 每个槽位带在途计数，注销时先摘除实例再等待在途回调结束，之后槽位才可复用
+namespace {
+struct InstanceSlot {
+    std::atomic<bool> used;
+    std::atomic<THANDLE> handle;
+    std::atomic<TdfMarketDataApi*> instance;
+    std::atomic<int> in_flight;
+};
+
+const size_t kMaxInstances = 16;
+InstanceSlot g_instance_slots[kMaxInstances];  // 静态零初始化
+
+bool RegisterInstance(THANDLE handle, TdfMarketDataApi* instance) {
+    for (size_t i = 0; i < kMaxInstances; ++i) {
+        bool expected = false;
+        if (g_instance_slots[i].used.compare_exchange_strong(expected, true)) {
+            g_instance_slots[i].instance.store(instance);
+            g_instance_slots[i].handle.store(handle, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+void UnregisterInstance(THANDLE handle) {
+    for (size_t i = 0; i < kMaxInstances; ++i) {
+        InstanceSlot& slot = g_instance_slots[i];
+        if (slot.handle.load(std::memory_order_acquire) != handle) {
+            continue;
+        }
+        slot.instance.store(nullptr);
+        while (slot.in_flight.load() != 0) {
+            std::this_thread::yield();
+        }
+        slot.handle.store(nullptr, std::memory_order_release);
+        slot.used.store(false, std::memory_order_release);
+        return;
+    }
+}
+
+/// @brief 回调期间持有实例引用（在途计数），析构时释放
+class InstanceRef {
+public:
+    explicit InstanceRef(THANDLE handle) : slot_(nullptr), instance_(nullptr) {
+        for (size_t i = 0; i < kMaxInstances; ++i) {
+            InstanceSlot& slot = g_instance_slots[i];
+            if (slot.handle.load(std::memory_order_acquire) != handle) {
+                continue;
+            }
+            slot.in_flight.fetch_add(1);
+            // 与 UnregisterInstance 的“先摘实例、再等计数”配对：要么看到空实例，要么注销方等待本回调
+            TdfMarketDataApi* instance = slot.instance.load();
+            if (instance && slot.handle.load() == handle) {
+                slot_ = &slot;
+                instance_ = instance;
+            } else {
+                slot.in_flight.fetch_sub(1, std::memory_order_release);
+            }
+            return;
+        }
+    }
+
+    ~InstanceRef() {
+        if (slot_) {
+            slot_->in_flight.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    InstanceRef(const InstanceRef&) = delete;
+    InstanceRef& operator=(const InstanceRef&) = delete;
+
+    TdfMarketDataApi* get() const { return instance_; }
+
+private:
+    InstanceSlot* slot_;
+    TdfMarketDataApi* instance_;
+};
+}
 
 // 辅助函数：将TDF时间格式转换为字符串
 static std::string TimeToString(int nTime) {
@@ -85,25 +169,29 @@ static double RoundToPrice(double value) {
     return std::round(value * 100.0) / 100.0;
 }
 
-static std::string ExtractNumericCode(const std::string& wind_code) {
-    auto pos = wind_code.find('.');
-    if (pos == std::string::npos) {
-        return wind_code;
+// 沪市股票：60xxxx, 68xxxx；深市股票：00xxxx, 30xxxx（格式：600000.SH 或 000001.SZ）
+static bool IsStockCode(const char* wind_code) {
+    if (strnlen(wind_code, 32) < 9) {
+        return false;
     }
-    return wind_code.substr(0, pos);
+    char c0 = wind_code[0];
+    char c1 = wind_code[1];
+    return (c0 == '6' && (c1 == '0' || c1 == '8')) ||
+           (c0 == '0' && c1 == '0') ||
+           (c0 == '3' && c1 == '0');
 }
 
 static bool ContainsSTToken(const char* raw, size_t len) {
     if (!raw) {
         return false;
     }
-    std::string buffer;
-    buffer.reserve(len);
-    for (size_t i = 0; i < len && raw[i] != '\0'; ++i) {
-        unsigned char ch = static_cast<unsigned char>(raw[i]);
-        buffer.push_back(static_cast<char>(std::toupper(ch)));
+    for (size_t i = 0; i + 1 < len && raw[i] != '\0'; ++i) {
+        if (std::toupper(static_cast<unsigned char>(raw[i])) == 'S' &&
+            std::toupper(static_cast<unsigned char>(raw[i + 1])) == 'T') {
+            return true;
+        }
     }
-    return buffer.find("ST") != std::string::npos;
+    return false;
 }
 
 static bool IsStSecurity(const TDF_MARKET_DATA& data) {
@@ -116,12 +204,9 @@ static bool IsStSecurity(const TDF_MARKET_DATA& data) {
     return false;
 }
 
-static double DeduceLimitRatio(const std::string& wind_code, const TDF_MARKET_DATA& data) {
-    std::string numeric_code = ExtractNumericCode(wind_code);
-    if (!numeric_code.empty()) {
-        if (numeric_code.rfind("30", 0) == 0 || numeric_code.rfind("68", 0) == 0) {
-            return 0.20;  // 创业板、科创板
-        }
+static double DeduceLimitRatio(const char* code, const TDF_MARKET_DATA& data) {
+    if ((code[0] == '3' && code[1] == '0') || (code[0] == '6' && code[1] == '8')) {
+        return 0.20;  // 创业板、科创板
     }
     if (IsStSecurity(data)) {
         return 0.05;   // ST 股票 5% 涨跌幅
@@ -142,7 +227,12 @@ static std::pair<double, double> BuildLimitFallback(double pre_close, double rat
 }
 
 TdfMarketDataApi::TdfMarketDataApi() 
-    : tdf_handle_(nullptr), is_connected_(false), port_(0) {}
+    : tdf_handle_(nullptr), is_connected_(false), port_(0),
+      tick_history_capacity_(kDefaultTickHistory) {
+    for (size_t i = 0; i < kMaxUpdateListeners; ++i) {
+        update_listeners_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
 
 TdfMarketDataApi::~TdfMarketDataApi() {
     disconnect();
@@ -167,6 +257,19 @@ bool TdfMarketDataApi::connect(const std::string& host, int port,
     subscription_list_ = GenerateSubscriptionList(csv_path);
     std::cout << "[TDF订阅] CSV: " << csv_path << std::endl;
     std::cout << "[TDF订阅] 股票列表: " << subscription_list_ << std::endl;
+
+    // 快照槽位按已注册证券数预分配；订阅为空时 TDF 推送全市场，多预留槽位
+    size_t snapshot_capacity = InstrumentRegistry::instance().size() +
+        (subscribed_ids_.empty() ? kFullMarketReserve : kUnlistedReserve);
+    snapshot_store_.reset(std::min(snapshot_capacity, InstrumentRegistry::kCapacity));
+    auction_tracker_.reset(snapshot_store_.capacity());
+    bid_queues_.reset(snapshot_store_.capacity() > 0
+                          ? new SeqLock<LimitUpQueue>[snapshot_store_.capacity()]
+                          : nullptr);
+    high_limit_raw_.assign(snapshot_store_.capacity(), 0);
+    limit_ratio_.assign(snapshot_store_.capacity(), 0.0);
+    // 历史 tick 只为订阅列表中的证券预分配（全市场订阅时不保留）
+    tick_history_.reset(subscribed_ids_, tick_history_capacity_);
     
     // 设置TDF日志路径（在环境设置之前）
     TDF_SetLogPath("./log");
@@ -195,8 +298,9 @@ bool TdfMarketDataApi::connect(const std::string& host, int port,
     settings.szMarkets = "SZ-2-0;SH-2-0";
     // 使用成员变量，保证指针有效
     settings.szSubScriptions = subscription_list_.c_str();
-    // nTypeFlags: 0表示只要行情快照，DATA_TYPE_TRANSACTION(0x2)表示要逐笔成交
-    settings.nTypeFlags = DATA_TYPE_TRANSACTION;  // 快照自动推送 + 逐笔成交
+    // nTypeFlags: 0表示只要行情快照，DATA_TYPE_TRANSACTION(0x2)表示要逐笔成交，
+    // DATA_TYPE_ORDERQUEUE(0x8)表示要委托队列（涨停封单深度）
+    settings.nTypeFlags = DATA_TYPE_TRANSACTION | DATA_TYPE_ORDERQUEUE;
     
     TDF_ERR err = TDF_ERR_SUCCESS;
     tdf_handle_ = TDF_OpenExt(&settings, &err);
@@ -220,9 +324,19 @@ bool TdfMarketDataApi::connect(const std::string& host, int port,
         }
     }
     
-    {
-        std::lock_guard<std::mutex> lock(g_instance_mutex);
-        g_instance_map[tdf_handle_] = this;
+    // 记录写线程须在回调开始路由到本实例之前就绪
+    if (recorder_ && !recorder_->start()) {
+        std::cerr << "[TDF警告] 行情记录启动失败，继续运行但不记录" << std::endl;
+    }
+    
+    if (!RegisterInstance(tdf_handle_, this)) {
+        std::cerr << "[TDF错误] 实例表已满（" << kMaxInstances << "），无法接收回调" << std::endl;
+        TDF_Close(tdf_handle_);
+        tdf_handle_ = nullptr;
+        if (recorder_) {
+            recorder_->stop();
+        }
+        return false;
     }
     
     is_connected_ = true;
@@ -233,12 +347,12 @@ bool TdfMarketDataApi::connect(const std::string& host, int port,
 void TdfMarketDataApi::disconnect() {
     if (tdf_handle_) {
         TDF_Close(tdf_handle_);
-        {
-            std::lock_guard<std::mutex> lock(g_instance_mutex);
-            g_instance_map.erase(tdf_handle_);
-        }
+        UnregisterInstance(tdf_handle_);  // 等待在途回调结束
         tdf_handle_ = nullptr;
     }
+    if (recorder_) {
+        recorder_->stop();  // 在途回调已结束，写完缓冲后关闭日志
+    }
     is_connected_ = false;
 }
 
@@ -246,17 +360,62 @@ bool TdfMarketDataApi::is_connected() const {
     return is_connected_;
 }
 
-MarketSnapshot TdfMarketDataApi::get_snapshot(const std::string& symbol) {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
-    auto it = snapshot_cache_.find(symbol);
-    return (it != snapshot_cache_.end()) ? it->second : MarketSnapshot{};
+MarketSnapshot TdfMarketDataApi::get_snapshot(InstrumentId id) {
+    MarketSnapshot snap;
+    if (!snapshot_store_.load(id, snap)) {
+        return MarketSnapshot{};
+    }
+    return snap;
 }
 
-std::pair<double, double> TdfMarketDataApi::get_limits(const std::string& symbol) {
-    MarketSnapshot snap = get_snapshot(symbol);
+std::pair<double, double> TdfMarketDataApi::get_limits(InstrumentId id) {
+    MarketSnapshot snap = get_snapshot(id);
     return {snap.high_limit, snap.low_limit};
 }
 
+bool TdfMarketDataApi::get_limit_up_queue(InstrumentId id, LimitUpQueue& out) {
+    if (id < 0 || static_cast<size_t>(id) >= high_limit_raw_.size()) {
+        return false;
+    }
+    const SeqLock<LimitUpQueue>& slot = bid_queues_[static_cast<size_t>(id)];
+    if (slot.version() == 0) {
+        return false;
+    }
+    out = slot.load();
+    return true;
+}
+
+std::shared_ptr<MarketUpdateQueue> TdfMarketDataApi::subscribe_updates(
+    const std::vector<InstrumentId>& ids) {
+    std::lock_guard<std::mutex> lock(update_listener_mutex_);
+    for (size_t i = 0; i < kMaxUpdateListeners; ++i) {
+        if (update_listeners_[i].load(std::memory_order_relaxed) != nullptr) {
+            continue;
+        }
+        auto queue = std::make_shared<MarketUpdateQueue>();
+        for (InstrumentId id : ids) {
+            queue->watch(id);
+        }
+        update_queue_owners_.push_back(queue);
+        update_listeners_[i].store(queue.get(), std::memory_order_release);
+        return queue;
+    }
+    std::cerr << "[TDF] 行情推送订阅已满（" << kMaxUpdateListeners << "）" << std::endl;
+    return nullptr;
+}
+
+void TdfMarketDataApi::unsubscribe_updates(const std::shared_ptr<MarketUpdateQueue>& queue) {
+    if (!queue) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(update_listener_mutex_);
+    for (size_t i = 0; i < kMaxUpdateListeners; ++i) {
+        if (update_listeners_[i].load(std::memory_order_relaxed) == queue.get()) {
+            update_listeners_[i].store(nullptr, std::memory_order_release);
+        }
+    }
+}
+
 std::pair<double, double> TdfMarketDataApi::get_auction_data(
     const std::string& symbol, const std::string& date, const std::string& end_time) {
     (void)date;
@@ -266,14 +425,25 @@ std::pair<double, double> TdfMarketDataApi::get_auction_data(
         return {0.0, 0.0};
     }
 
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    InstrumentId id = InstrumentRegistry::instance().find(symbol);
+
+    // 优先使用逐笔累计：截止时间落在集合竞价时段内时，直接取该时段的撮合价与成交额
+    AuctionSession session;
+    if (AuctionTracker::classify(end_hhmmss, session)) {
+        AuctionStats stats;
+        if (auction_tracker_.load(id, session, stats)) {
+            if (stats.first_time > end_hhmmss) {
+                return {0.0, 0.0};  // 截止时间前尚未撮合
+            }
+            return {stats.price, static_cast<double>(stats.amount)};
+        }
+    }
 
     double open_price = 0.0;
 
-    // 优先使用快照：包含 nOpen 和累计成交额 iTurnover（集合竞价阶段策略需要的字段）
-    auto snap_it = snapshot_cache_.find(symbol);
-    if (snap_it != snapshot_cache_.end()) {
-        const MarketSnapshot& snap = snap_it->second;
+    // 没有逐笔数据时退回快照：包含 nOpen 和累计成交额 iTurnover
+    MarketSnapshot snap;
+    if (snapshot_store_.load(id, snap)) {
         if (snap.valid && snap.open > 0.0) {
             open_price = snap.open;
         }
@@ -302,34 +472,74 @@ std::vector<MarketSnapshot> TdfMarketDataApi::get_history_ticks(
     const std::string& start_time,
     const std::string& end_time
 ) {
-    // TDF API 不直接支持历史tick查询
-    // 这里返回空列表，实际应用中需要：
-    // 1. 使用TDF回放功能（nTime参数）
-    // 2. 或者从本地缓存的tick数据中过滤
+    // 仅返回本地环形缓冲中仍保留的 tick（订阅证券、最近 tick_history_capacity_ 条）
     std::vector<MarketSnapshot> result;
-    std::cerr << "Warning: get_history_ticks not implemented for TDF" << std::endl;
+
+    int start_hhmmss = 0;
+    if (!TryParseHhmmss(start_time, start_hhmmss)) {
+        return result;
+    }
+    int end_hhmmss = 235959;
+    if (!end_time.empty() && !TryParseHhmmss(end_time, end_hhmmss)) {
+        return result;
+    }
+
+    InstrumentId id = InstrumentRegistry::instance().find(symbol);
+    std::vector<TickRecord> records;
+    if (!tick_history_.query(id, start_hhmmss * 1000, end_hhmmss * 1000 + 999, records)) {
+        return result;
+    }
+
+    result.reserve(records.size());
+    for (const TickRecord& rec : records) {
+        MarketSnapshot snap;
+        snap.instrument = id;
+        snap.timestamp = rec.timestamp;
+        snap.last_price = rec.last_price;
+        snap.high = rec.high;
+        snap.low = rec.low;
+        snap.volume = rec.volume;
+        snap.turnover = rec.turnover;
+        snap.bid_px[0] = rec.bid_px1;
+        snap.bid_qty[0] = rec.bid_volume1;
+        snap.ask_px[0] = rec.ask_px1;
+        snap.ask_qty[0] = rec.ask_volume1;
+        snap.valid = true;
+        result.push_back(snap);
+    }
     return result;
 }
 
 // 回调
 void TdfMarketDataApi::OnDataReceived(THANDLE hTdf, TDF_MSG* pMsgHead) {
-    std::lock_guard<std::mutex> lock(g_instance_mutex);
-    auto it = g_instance_map.find(hTdf);
-    if (it != g_instance_map.end()) {
-        TdfMarketDataApi* instance = it->second;
-        if (pMsgHead->nDataType == MSG_DATA_MARKET) {
-            instance->HandleMarketData(pMsgHead);
-        } else if (pMsgHead->nDataType == MSG_DATA_TRANSACTION) {
-            instance->HandleTransactionData(pMsgHead);
-        }
+    if (!pMsgHead) return;
+    InstanceRef ref(hTdf);
+    TdfMarketDataApi* instance = ref.get();
+    if (!instance) {
+        return;
+    }
+    // 接收时间在入口处取，原始数据在处理完成后再拷入记录缓冲，不推迟快照发布
+    MarketRecorder* recorder = instance->recorder_.get();
+    int64_t recv_ns = recorder ? MarketRecorder::now_ns() : 0;
+    if (pMsgHead->nDataType == MSG_DATA_MARKET) {
+        instance->HandleMarketData(pMsgHead);
+    } else if (pMsgHead->nDataType == MSG_DATA_TRANSACTION) {
+        instance->HandleTransactionData(pMsgHead);
+    } else if (pMsgHead->nDataType == MSG_DATA_ORDERQUEUE) {
+        instance->HandleOrderQueue(pMsgHead);
+    } else {
+        return;
+    }
+    if (recorder && pMsgHead->pAppHead) {
+        recorder->record(pMsgHead->nDataType, pMsgHead->nServerTime, pMsgHead->pData,
+                         pMsgHead->pAppHead->nItemSize, pMsgHead->pAppHead->nItemCount, recv_ns);
     }
 }
 
 void TdfMarketDataApi::OnSystemMessage(THANDLE hTdf, TDF_MSG* pSysMsg) {
-    std::lock_guard<std::mutex> lock(g_instance_mutex);
-    auto it = g_instance_map.find(hTdf);
-    if (it != g_instance_map.end()) {
-        it->second->HandleSystemMessage(pSysMsg);
+    InstanceRef ref(hTdf);
+    if (ref.get()) {
+        ref.get()->HandleSystemMessage(pSysMsg);
     }
 }
 
@@ -366,48 +576,72 @@ void TdfMarketDataApi::HandleMarketData(TDF_MSG* pMsgHead) {
     // 注释掉频繁的回调日志，减少输出
     // std::cout << "[TDF回调] 收到 " << count << " 条行情数据" << std::endl;
     
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    // 基础价格与涨跌停价整批换算（TDF价格字段单位是10000）：先把定点值按记录连续取出，
+    // 再在一个循环里统一除以10000转为元，逐条处理时只读取结果
+    const size_t kPriceFields = 7;
+    price_batch_.resize(static_cast<size_t>(count) * kPriceFields);
+    double* prices = price_batch_.data();
     for (unsigned int i = 0; i < count; ++i) {
-        std::string symbol = pMarket[i].szWindCode;
+        double* p = prices + static_cast<size_t>(i) * kPriceFields;
+        p[0] = static_cast<double>(pMarket[i].nPreClose);
+        p[1] = static_cast<double>(pMarket[i].nOpen);
+        p[2] = static_cast<double>(pMarket[i].nHigh);
+        p[3] = static_cast<double>(pMarket[i].nLow);
+        p[4] = static_cast<double>(pMarket[i].nMatch);   // nMatch是最新成交价
+        p[5] = static_cast<double>(pMarket[i].nHighLimited);
+        p[6] = static_cast<double>(pMarket[i].nLowLimited);
+    }
+    for (size_t k = 0; k < price_batch_.size(); ++k) {
+        prices[k] /= 10000.0;
+    }
+
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    MarketSnapshot snap;
+    for (unsigned int i = 0; i < count; ++i) {
+        const char* wind_code = pMarket[i].szWindCode;
         
         // 过滤：只处理6位股票代码（排除可转债、基金等）
-        bool is_stock = false;
-        if (symbol.length() >= 9) {  // 格式：600000.SH 或 000001.SZ
-            std::string code = symbol.substr(0, 6);
-            // 沪市股票：60xxxx, 68xxxx
-            // 深市股票：00xxxx, 30xxxx
-            if ((code[0] == '6' && (code[1] == '0' || code[1] == '8')) ||
-                (code[0] == '0' && code[1] == '0') ||
-                (code[0] == '3' && code[1] == '0')) {
-                is_stock = true;
-            }
-        }
-        
         // 只缓存股票数据，跳过可转债、基金等
-        if (!is_stock) {
+        if (!IsStockCode(wind_code)) {
             continue;
         }
         
-        MarketSnapshot& snap = snapshot_cache_[symbol];
+        // 已注册代码无锁查找；首次出现的代码（全市场订阅时）才注册
+        InstrumentId id = registry.find(wind_code);
+        if (id == kInvalidInstrument) {
+            id = registry.intern(wind_code);
+        }
+        if (id == kInvalidInstrument) {
+            continue;
+        }
+
         snap.valid = true;
-        snap.symbol = symbol;
         
         // 时间信息（HHMMSSmmm格式，如93015000表示09:30:15.000）
         snap.timestamp = pMarket[i].nTime;
         
-        // 基础价格（TDF价格字段单位是10000，需要除以10000转为元）
-        snap.pre_close = pMarket[i].nPreClose / 10000.0;
-        snap.open = pMarket[i].nOpen / 10000.0;
-        snap.high = pMarket[i].nHigh / 10000.0;
-        snap.low = pMarket[i].nLow / 10000.0;
-        snap.last_price = pMarket[i].nMatch / 10000.0;  // nMatch是最新成交价
-        
-        // 涨跌停价格（TDF价格字段单位是10000，需要除以10000转为元）
-        double high_limit = pMarket[i].nHighLimited / 10000.0;
-        double low_limit = pMarket[i].nLowLimited / 10000.0;
+        // 基础价格与涨跌停价格（已在上面整批换算为元）
+        const double* p = prices + static_cast<size_t>(i) * kPriceFields;
+        snap.pre_close = p[0];
+        snap.open = p[1];
+        snap.high = p[2];
+        snap.low = p[3];
+        snap.last_price = p[4];
+        double high_limit = p[5];
+        double low_limit = p[6];
 
         if (high_limit <= 0.0 || low_limit <= 0.0) {
-            double ratio = DeduceLimitRatio(symbol, pMarket[i]);
+            // 涨跌幅比例按证券缓存：代码前缀和 ST 标记当日不变，只在首次出现时判断
+            double ratio = 0.0;
+            if (static_cast<size_t>(id) < limit_ratio_.size()) {
+                ratio = limit_ratio_[static_cast<size_t>(id)];
+                if (ratio <= 0.0) {
+                    ratio = DeduceLimitRatio(wind_code, pMarket[i]);
+                    limit_ratio_[static_cast<size_t>(id)] = ratio;
+                }
+            } else {
+                ratio = DeduceLimitRatio(wind_code, pMarket[i]);
+            }
             auto fallback_limits = BuildLimitFallback(snap.pre_close, ratio);
             if (high_limit <= 0.0) {
                 high_limit = fallback_limits.first;
@@ -424,35 +658,47 @@ void TdfMarketDataApi::HandleMarketData(TDF_MSG* pMsgHead) {
         snap.up_limit = snap.high_limit;
         snap.down_limit = snap.low_limit;
         
-        // 五档买盘（从买一到买五）
-        snap.bid_price1 = pMarket[i].nBidPrice[0] / 10000.0;
-        snap.bid_price2 = pMarket[i].nBidPrice[1] / 10000.0;
-        snap.bid_price3 = pMarket[i].nBidPrice[2] / 10000.0;
-        snap.bid_price4 = pMarket[i].nBidPrice[3] / 10000.0;
-        snap.bid_price5 = pMarket[i].nBidPrice[4] / 10000.0;
-        
-        snap.bid_volume1 = pMarket[i].nBidVol[0];
-        snap.bid_volume2 = pMarket[i].nBidVol[1];
-        snap.bid_volume3 = pMarket[i].nBidVol[2];
-        snap.bid_volume4 = pMarket[i].nBidVol[3];
-        snap.bid_volume5 = pMarket[i].nBidVol[4];
-        
-        // 五档卖盘（从卖一到卖五）
-        snap.ask_price1 = pMarket[i].nAskPrice[0] / 10000.0;
-        snap.ask_price2 = pMarket[i].nAskPrice[1] / 10000.0;
-        snap.ask_price3 = pMarket[i].nAskPrice[2] / 10000.0;
-        snap.ask_price4 = pMarket[i].nAskPrice[3] / 10000.0;
-        snap.ask_price5 = pMarket[i].nAskPrice[4] / 10000.0;
-        
-        snap.ask_volume1 = pMarket[i].nAskVol[0];
-        snap.ask_volume2 = pMarket[i].nAskVol[1];
-        snap.ask_volume3 = pMarket[i].nAskVol[2];
-        snap.ask_volume4 = pMarket[i].nAskVol[3];
-        snap.ask_volume5 = pMarket[i].nAskVol[4];
+        // 十档盘口（保持 TDF 定点价格，不做浮点换算）
+        std::memcpy(snap.bid_px, pMarket[i].nBidPrice, sizeof(snap.bid_px));
+        std::memcpy(snap.bid_qty, pMarket[i].nBidVol, sizeof(snap.bid_qty));
+        std::memcpy(snap.ask_px, pMarket[i].nAskPrice, sizeof(snap.ask_px));
+        std::memcpy(snap.ask_qty, pMarket[i].nAskVol, sizeof(snap.ask_qty));
+        snap.total_bid_volume = pMarket[i].nTotalBidVol;
+        snap.total_ask_volume = pMarket[i].nTotalAskVol;
+        snap.weighted_avg_bid_px = pMarket[i].nWeightedAvgBidPrice;
+        snap.weighted_avg_ask_px = pMarket[i].nWeightedAvgAskPrice;
         
         // 成交信息
         snap.volume = pMarket[i].iVolume;
         snap.turnover = pMarket[i].iTurnover;
+        snap.num_trades = pMarket[i].nNumTrades;
+        snap.instrument = id;
+
+        snapshot_store_.store(id, snap);  // ID 超出预分配容量时丢弃
+        uint64_t version = snapshot_store_.version(id);
+        for (size_t k = 0; k < kMaxUpdateListeners; ++k) {
+            MarketUpdateQueue* queue = update_listeners_[k].load(std::memory_order_acquire);
+            if (queue) {
+                queue->publish(id, version);  // 只入队，模块代码在各自线程执行
+            }
+        }
+        if (static_cast<size_t>(id) < high_limit_raw_.size()) {
+            high_limit_raw_[static_cast<size_t>(id)] = static_cast<int64_t>(high_limit * 10000.0 + 0.5);
+        }
+
+        TickRecord rec;
+        rec.seq = 0;  // 由 TickHistory 填写
+        rec.timestamp = snap.timestamp;
+        rec.last_price = snap.last_price;
+        rec.high = snap.high;
+        rec.low = snap.low;
+        rec.volume = snap.volume;
+        rec.turnover = snap.turnover;
+        rec.bid_px1 = snap.bid_px[0];
+        rec.bid_volume1 = snap.bid_qty[0];
+        rec.ask_px1 = snap.ask_px[0];
+        rec.ask_volume1 = snap.ask_qty[0];
+        tick_history_.append(id, rec);  // 未订阅证券没有缓冲，直接忽略
     }
 }
 
@@ -461,32 +707,35 @@ void TdfMarketDataApi::HandleTransactionData(TDF_MSG* pMsgHead) {
     unsigned int count = pMsgHead->pAppHead->nItemCount;
     TDF_TRANSACTION* pTrans = (TDF_TRANSACTION*)pMsgHead->pData;
     
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
     for (unsigned int i = 0; i < count; ++i) {
-        std::string symbol = pTrans[i].szWindCode;
+        const char* symbol = pTrans[i].szWindCode;
         int tick_hhmmss = NormalizeToHhmmss(pTrans[i].nTime);
         if (tick_hhmmss <= 0) {
             continue;
         }
 
-        bool is_stock = true;
-        if (symbol.length() >= 9) {
-            std::string code = symbol.substr(0, 6);
-            is_stock = false;
-            if ((code[0] == '6' && (code[1] == '0' || code[1] == '8')) ||
-                (code[0] == '0' && code[1] == '0') ||
-                (code[0] == '3' && code[1] == '0')) {
-                is_stock = true;
-            }
-        }
-        if (!is_stock) {
+        if (strnlen(symbol, sizeof(pTrans[i].szWindCode)) >= 9 && !IsStockCode(symbol)) {
             continue;
         }
 
-        // 如果设置了回调，调用回调函数
+        // 已注册代码无锁查找；首次出现的股票代码才注册
+        InstrumentId id = registry.find(symbol);
+        if (id == kInvalidInstrument && IsStockCode(symbol)) {
+            id = registry.intern(symbol);
+        }
+
+        // 集合竞价成交累计（撤单记录不计入）
+        if (pTrans[i].chFunctionCode != 'C') {
+            auction_tracker_.on_trade(id, tick_hhmmss, pTrans[i].nPrice / 10000.0,
+                                      pTrans[i].nVolume, pTrans[i].nTurnover);
+        }
+
+        // 如果设置了回调，调用回调函数（symbol 指向 TDF 缓冲，只在回调期间有效）
         if (transaction_callback_) {
             TransactionData td;
             td.symbol = symbol;
+            td.instrument = id;
             td.timestamp = pTrans[i].nTime;
             td.price = pTrans[i].nPrice / 10000.0;
             td.volume = pTrans[i].nVolume;
@@ -528,6 +777,40 @@ void TdfMarketDataApi::HandleTransactionData(TDF_MSG* pMsgHead) {
     }
 }
 
+void TdfMarketDataApi::HandleOrderQueue(TDF_MSG* pMsgHead) {
+    if (!pMsgHead || !pMsgHead->pData) return;
+    unsigned int count = pMsgHead->pAppHead->nItemCount;
+    TDF_ORDER_QUEUE* pQueue = (TDF_ORDER_QUEUE*)pMsgHead->pData;
+
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    for (unsigned int i = 0; i < count; ++i) {
+        // 只关心买方队列（卖方队列与涨停封单无关）
+        if (pQueue[i].nSide != 'B') {
+            continue;
+        }
+        InstrumentId id = registry.find(pQueue[i].szWindCode);
+        if (id == kInvalidInstrument || static_cast<size_t>(id) >= high_limit_raw_.size()) {
+            continue;
+        }
+
+        int items = std::min(std::max(pQueue[i].nABItems, 0), 200);
+        int64_t volume = 0;
+        for (int k = 0; k < items; ++k) {
+            volume += pQueue[i].nABVolume[k];
+        }
+
+        LimitUpQueue queue;
+        queue.timestamp = pQueue[i].nTime;
+        queue.price = pQueue[i].nPrice / 10000.0;
+        queue.volume = volume;
+        queue.orders = pQueue[i].nOrders;
+        queue.items = items;
+        int64_t high_limit = high_limit_raw_[static_cast<size_t>(id)];
+        queue.sealed = high_limit > 0 && pQueue[i].nPrice == high_limit;
+        bid_queues_[static_cast<size_t>(id)].store(queue);
+    }
+}
+
 std::string TdfMarketDataApi::GenerateSubscriptionList(const std::string& csv_path) {
     std::ifstream file(csv_path);
     if (!file.is_open()) {
@@ -535,6 +818,9 @@ std::string TdfMarketDataApi::GenerateSubscriptionList(const std::string& csv_pa
         return "";
     }
     
+    subscribed_ids_.clear();
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+
     std::string line, sub_list;
     bool header = true;
     while (std::getline(file, line)) {
@@ -569,6 +855,10 @@ std::string TdfMarketDataApi::GenerateSubscriptionList(const std::string& csv_pa
         
         if (!sub_list.empty()) sub_list += ";";
         sub_list += windCode;
+        InstrumentId id = registry.intern(windCode);
+        if (id != kInvalidInstrument) {
+            subscribed_ids_.push_back(id);
+        }
     }
     
     std::cout << "[TDF订阅] 从CSV读取 " << (sub_list.empty() ? 0 : std::count(sub_list.begin(), sub_list.end(), ';') + 1) << " 只股票" << std::endl;
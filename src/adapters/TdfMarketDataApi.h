@@ -1,6 +1,12 @@
 #pragma once
 #include "IMarketDataApi.h"  // 假设你有这个接口
+#include "AuctionTracker.h"
+#include "MarketRecorder.h"
+#include "SnapshotStore.h"
+#include "TickHistory.h"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <string>
@@ -13,10 +19,12 @@ struct TDF_OPEN_SETTING_EXT;
 struct TDF_MSG;
 struct TDF_MARKET_DATA;
 struct TDF_TRANSACTION;
+struct TDF_ORDER_QUEUE;
 
 // 逐笔成交数据结构（用于回调）
 struct TransactionData {
-    std::string symbol;     // 股票代码 (如 600000.SH)
+    const char* symbol;     // 股票代码 (如 600000.SH)，指向 TDF 缓冲，仅回调期间有效
+    InstrumentId instrument;  // 证券 ID（未注册为 kInvalidInstrument）
     int timestamp;          // 时间 HHMMSSmmm
     double price;           // 成交价格
     int volume;             // 成交量
@@ -46,16 +54,30 @@ private:
     std::string password_;
     std::string subscription_list_;  //  保存订阅列表，避免c_str()指针失效
     std::string csv_path_;           // CSV 配置文件路径
+    std::vector<InstrumentId> subscribed_ids_;     // 订阅代码 ID（用于预分配快照槽位）
+    size_t tick_history_capacity_;                 // 每只订阅证券保留的历史 tick 条数
     
     // 逐笔成交回调
     TransactionCallback transaction_callback_;
     
-    // 缓存
-    std::map<std::string, MarketSnapshot> snapshot_cache_;
-    std::map<std::string, std::vector<TickData>> tick_cache_;
-    bool auction_tick_logged_ = false;
-    int continuous_tick_logged_ = 0;
-    mutable std::mutex cache_mutex_;
+    // 缓存（快照按代码分槽，seqlock 无锁读写）
+    SnapshotStore snapshot_store_;
+    TickHistory tick_history_;           // 订阅证券的近期 tick（环形缓冲，connect 时预分配）
+    AuctionTracker auction_tracker_;     // 逐笔累计的集合竞价成交（与快照推送时机无关）
+    std::unique_ptr<SeqLock<LimitUpQueue>[]> bid_queues_;  // 买一委托队列，按 ID 下标
+    std::vector<int64_t> high_limit_raw_;  // 涨停价（TDF 原始单位），仅行情回调线程访问
+    std::vector<double> limit_ratio_;      // 涨跌幅比例缓存（0 表示未判断），仅行情回调线程访问
+    std::vector<double> price_batch_;      // 一批快照的基础价格与涨跌停价（元），仅行情回调线程访问
+    
+    // 行情更新推送：回调线程无锁遍历槽位；队列对象由 update_queue_owners_ 持有到析构，
+    // 取消订阅只清空槽位，避免回调线程访问已释放的队列
+    static const size_t kMaxUpdateListeners = 8;
+    std::atomic<MarketUpdateQueue*> update_listeners_[kMaxUpdateListeners];
+    std::vector<std::shared_ptr<MarketUpdateQueue>> update_queue_owners_;
+    std::mutex update_listener_mutex_;
+    std::unique_ptr<MarketRecorder> recorder_;  // 原始行情记录（可选，connect 之前设置）
+    bool auction_tick_logged_ = false;   // 仅行情回调线程访问
+    int continuous_tick_logged_ = 0;     // 仅行情回调线程访问
     
     // 回调（静态）
     static void OnDataReceived(THANDLE hTdf, TDF_MSG* pMsgHead);
@@ -64,9 +86,10 @@ private:
     // 实例处理
     void HandleMarketData(TDF_MSG* pMsgHead);
     void HandleTransactionData(TDF_MSG* pMsgHead);  // 新加：处理逐笔
+    void HandleOrderQueue(TDF_MSG* pMsgHead);       // 委托队列（买一封单深度）
     void HandleSystemMessage(TDF_MSG* pSysMsg);
     
-    // 辅助：从 CSV 加载订阅列表
+    // 辅助：从 CSV 加载订阅列表（同时注册证券 ID，填充 subscribed_ids_）
     std::string GenerateSubscriptionList(const std::string& csv_path);
     
 public:
@@ -75,6 +98,9 @@ public:
     
     /// @brief 设置 CSV 配置文件路径（在 connect 之前调用）
     void set_csv_path(const std::string& csv_path) { csv_path_ = csv_path; }
+
+    /// @brief 设置每只订阅证券保留的历史 tick 条数（在 connect 之前调用，0 表示不保留）
+    void set_tick_history_capacity(size_t capacity) { tick_history_capacity_ = capacity; }
     
     /// @brief 设置逐笔成交回调（在 connect 之前调用）
     /// @param callback 每收到一笔成交数据时调用的函数
@@ -82,6 +108,18 @@ public:
         transaction_callback_ = std::move(callback); 
     }
     
+    /// @brief 启用原始行情记录（在 connect 之前调用）
+    /// @param dir 日志目录（须已存在），按日写入 md_YYYYMMDD.bin
+    /// @param buffer_bytes 回调线程与写线程之间的环形缓冲大小
+    void enable_recording(const std::string& dir, size_t buffer_bytes) {
+        recorder_.reset(new MarketRecorder(dir, buffer_bytes));
+    }
+    
+    /// @brief 行情记录统计（未启用时全为 0）
+    MarketRecorder::Stats recording_stats() const {
+        return recorder_ ? recorder_->stats() : MarketRecorder::Stats();
+    }
+    
     bool connect(const std::string& host, int port,
                  const std::string& user = "", 
                  const std::string& password = "") override;
@@ -90,9 +128,18 @@ public:
     
     bool is_connected() const override;
     
-    MarketSnapshot get_snapshot(const std::string& symbol) override;
+    using IMarketDataApi::get_snapshot;
+    using IMarketDataApi::get_limits;
+
+    MarketSnapshot get_snapshot(InstrumentId id) override;
+    
+    std::pair<double, double> get_limits(InstrumentId id) override;
+    
+    bool get_limit_up_queue(InstrumentId id, LimitUpQueue& out) override;
+    
+    std::shared_ptr<MarketUpdateQueue> subscribe_updates(const std::vector<InstrumentId>& ids) override;
     
-    std::pair<double, double> get_limits(const std::string& symbol) override;
+    void unsubscribe_updates(const std::shared_ptr<MarketUpdateQueue>& queue) override;
     
     std::pair<double, double> get_auction_data(
         const std::string& symbol,
@@ -0,0 +1,55 @@
+#include "AuctionTracker.h"
+
+void AuctionTracker::reset(size_t capacity) {
+    slots_.reset(capacity > 0 ? new SeqLock<AuctionStats>[capacity * 2] : nullptr);
+    capacity_ = capacity;
+}
+
+bool AuctionTracker::classify(int hhmmss, AuctionSession& session) {
+    if (hhmmss >= 91500 && hhmmss < 93000) {
+        session = AuctionSession::OPEN;
+        return true;
+    }
+    if (hhmmss >= 145700) {
+        session = AuctionSession::CLOSE;
+        return true;
+    }
+    return false;
+}
+
+void AuctionTracker::on_trade(InstrumentId id, int hhmmss, double price,
+                              int64_t volume, int64_t amount) {
+    if (id < 0 || static_cast<size_t>(id) >= capacity_ || volume <= 0) {
+        return;
+    }
+    AuctionSession session;
+    if (!classify(hhmmss, session)) {
+        return;
+    }
+
+    SeqLock<AuctionStats>& slot = slots_[static_cast<size_t>(id) * 2 + static_cast<size_t>(session)];
+    // 单写端：读取自己上次写入的值不会与其他写端冲突
+    AuctionStats stats = slot.load();
+    if (stats.first_time == 0) {
+        stats.first_time = hhmmss;
+    }
+    stats.last_time = hhmmss;
+    stats.price = price;
+    stats.volume += volume;
+    stats.amount += amount;
+    stats.trades += 1;
+    slot.store(stats);
+}
+
+bool AuctionTracker::load(InstrumentId id, AuctionSession session, AuctionStats& out) const {
+    if (id < 0 || static_cast<size_t>(id) >= capacity_) {
+        return false;
+    }
+    const SeqLock<AuctionStats>& slot =
+        slots_[static_cast<size_t>(id) * 2 + static_cast<size_t>(session)];
+    if (slot.version() == 0) {
+        return false;
+    }
+    out = slot.load();
+    return out.trades > 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "InstrumentRegistry.h"
+#include "SeqLock.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// @brief 集合竞价时段
+enum class AuctionSession {
+    OPEN = 0,   ///< 开盘集合竞价（09:15-09:30 前的撮合成交）
+    CLOSE = 1,  ///< 收盘集合竞价（14:57 之后的撮合成交）
+};
+
+/// @brief 单只证券在某个集合竞价时段的成交累计
+struct AuctionStats {
+    int first_time;   ///< 首笔成交时间 HHMMSS（0 表示尚无成交）
+    int last_time;    ///< 末笔成交时间 HHMMSS
+    double price;     ///< 撮合价格（末笔成交价）
+    int64_t volume;   ///< 累计成交量（股）
+    int64_t amount;   ///< 累计成交金额（元）
+    int64_t trades;   ///< 成交笔数
+};
+
+/// @brief 集合竞价成交累计器：按 InstrumentId 下标，每个证券/时段一个 seqlock 槽位
+///
+/// - 逐笔成交回调线程调用 on_trade 累加（单写端），每笔 O(1)、无内存分配；
+/// - 读端 load 为常数时间无锁读取，结果与快照推送时机无关。
+class AuctionTracker {
+public:
+    AuctionTracker() = default;
+    AuctionTracker(const AuctionTracker&) = delete;
+    AuctionTracker& operator=(const AuctionTracker&) = delete;
+
+    /// @brief 预分配槽位（必须在行情回调开始前调用）
+    void reset(size_t capacity);
+
+    /// @brief 按成交时间判定所属集合竞价时段
+    /// @return 连续竞价时段的成交返回 false
+    static bool classify(int hhmmss, AuctionSession& session);
+
+    /// @brief 累加一笔成交（仅逐笔回调线程调用）；非集合竞价时段的成交忽略
+    void on_trade(InstrumentId id, int hhmmss, double price, int64_t volume, int64_t amount);
+
+    /// @brief 读取累计结果；无成交或 ID 越界时返回 false
+    bool load(InstrumentId id, AuctionSession session, AuctionStats& out) const;
+
+private:
+    std::unique_ptr<SeqLock<AuctionStats>[]> slots_;  ///< [id * 2 + session]
+    size_t capacity_ = 0;
+};
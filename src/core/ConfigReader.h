@@ -119,6 +119,75 @@ public:
         return "";
     }
     
+    /// @brief 获取异步委托开关（trading.async_order，1=SECITPDK_OrderEntrust_ASync）
+    int get_trading_async_order(int default_val = 0) const {
+        size_t trading_pos = content_.find("\"trading\"");
+        if (trading_pos == std::string::npos) return default_val;
+        
+        size_t key_pos = content_.find("\"async_order\"", trading_pos);
+        size_t next_section = content_.find("\"market\"", trading_pos);
+        
+        if (key_pos != std::string::npos && 
+            (next_section == std::string::npos || key_pos < next_section)) {
+            return extract_int("async_order");
+        }
+        return default_val;
+    }
+    
+    /// @brief 获取持仓对账周期（trading.position_reconcile_sec，秒，<=0 表示不对账）
+    int get_trading_position_reconcile_sec(int default_val = 60) const {
+        size_t trading_pos = content_.find("\"trading\"");
+        if (trading_pos == std::string::npos) return default_val;
+        
+        size_t key_pos = content_.find("\"position_reconcile_sec\"", trading_pos);
+        size_t next_section = content_.find("\"market\"", trading_pos);
+        
+        if (key_pos != std::string::npos && 
+            (next_section == std::string::npos || key_pos < next_section)) {
+            return extract_int("position_reconcile_sec");
+        }
+        return default_val;
+    }
+    
+    /// @brief 获取查询结果共享窗口（trading.query_freshness_ms，毫秒，0 表示只合并进行中的查询）
+    int get_trading_query_freshness_ms(int default_val = 200) const {
+        size_t trading_pos = content_.find("\"trading\"");
+        if (trading_pos == std::string::npos) return default_val;
+        
+        size_t key_pos = content_.find("\"query_freshness_ms\"", trading_pos);
+        size_t next_section = content_.find("\"market\"", trading_pos);
+        
+        if (key_pos != std::string::npos && 
+            (next_section == std::string::npos || key_pos < next_section)) {
+            return extract_int("query_freshness_ms");
+        }
+        return default_val;
+    }
+    
+    /// @brief 获取 trading 段的整数参数，缺省时返回 default_val
+    /// - 委托限流（速率单位：笔/秒，<=0 表示不限）：order_rate / order_burst 为每个资金账号，
+    ///   order_rate_sh / order_burst_sh、order_rate_sz / order_burst_sz 为每个账号在该交易所；
+    ///   撤单另设一组令牌桶：cancel_rate / cancel_burst、cancel_rate_sh / cancel_burst_sh、
+    ///   cancel_rate_sz / cancel_burst_sz，按所撤订单的账号/交易所计
+    /// - 模拟撮合（仅 SELL_BUILD_SIM 编译时生效）：sim=1 使用模拟撮合替代柜台，
+    ///   sim_ack_us / sim_fill_us 为确认延迟、成交推送延迟（微秒）
+    int get_trading_int(const std::string& key, int default_val) const {
+        size_t trading_pos = content_.find("\"trading\"");
+        if (trading_pos == std::string::npos) return default_val;
+        
+        size_t key_pos = content_.find("\"" + key + "\"", trading_pos);
+        size_t next_section = content_.find("\"market\"", trading_pos);
+        
+        if (key_pos != std::string::npos && 
+            (next_section == std::string::npos || key_pos < next_section)) {
+            return extract_int(key);
+        }
+        return default_val;
+    }
+    
+    /// @brief 获取模拟撮合的持仓文件（trading.sim_positions，CSV：证券代码,数量）
+    std::string get_trading_sim_positions() const { return extract_value("sim_positions"); }
+    
     /// @brief 获取配置段名称
     std::string get_config_section() const { return extract_value("config_section"); }
     
@@ -213,6 +282,24 @@ public:
         return "";
     }
     
+    /// @brief 获取原始行情记录目录（market.record_dir，空表示不记录）
+    std::string get_market_record_dir() const { return extract_value("record_dir"); }
+    
+    /// @brief 获取原始行情记录缓冲大小（market.record_buffer_mb，MB）
+    int get_market_record_buffer_mb(int default_val = 64) const {
+        size_t market_pos = content_.find("\"market\"");
+        if (market_pos == std::string::npos) return default_val;
+        
+        size_t key_pos = content_.find("\"record_buffer_mb\"", market_pos);
+        size_t next_section = content_.find("\"strategy\"", market_pos);
+        
+        if (key_pos != std::string::npos && 
+            (next_section == std::string::npos || key_pos < next_section)) {
+            return extract_int("record_buffer_mb");
+        }
+        return default_val;
+    }
+    
     /// @brief 获取 CSV 路径
     std::string get_csv_path() const { 
         size_t strategy_pos = content_.find("\"strategy\"");
@@ -12,7 +12,8 @@ bool CsvConfig::load_from_file(const std::string& csv_path) {
         return false;
     }
     
-    stocks_.clear();
+    clear();
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
     
     std::string line;
     bool is_header = true;
@@ -81,7 +82,15 @@ bool CsvConfig::load_from_file(const std::string& csv_path) {
             params.open_price = 0.0;
             params.call_back = 0;
             
-            stocks_[params.symbol] = params;
+            params.id = registry.intern(params.symbol);
+            if (params.id == kInvalidInstrument) {
+                std::cerr << "Invalid symbol in CSV: " << params.symbol << std::endl;
+                continue;
+            }
+            if (!stocks_.contains(params.id)) {
+                ids_.push_back(params.id);
+            }
+            stocks_[params.id] = params;
             
             // 记录未知列（只警告一次）
             if (!warned_unknown && header_index.size() > 0 && fields.size() > header_index.size()) {
@@ -101,26 +110,26 @@ bool CsvConfig::load_from_file(const std::string& csv_path) {
 }
 
 StockParams* CsvConfig::get_stock(const std::string& symbol) {
-    auto it = stocks_.find(symbol);
-    if (it != stocks_.end()) {
-        return &it->second;
-    }
-    return nullptr;
+    return stocks_.find(InstrumentRegistry::instance().find(symbol));
 }
 
 const StockParams* CsvConfig::get_stock(const std::string& symbol) const {
-    auto it = stocks_.find(symbol);
-    if (it != stocks_.end()) {
-        return &it->second;
-    }
-    return nullptr;
+    return stocks_.find(InstrumentRegistry::instance().find(symbol));
+}
+
+StockParams* CsvConfig::get_stock(InstrumentId id) {
+    return stocks_.find(id);
+}
+
+const StockParams* CsvConfig::get_stock(InstrumentId id) const {
+    return stocks_.find(id);
 }
 
 std::vector<std::string> CsvConfig::get_all_symbols() const {
     std::vector<std::string> symbols;
-    symbols.reserve(stocks_.size());
-    for (const auto& pair : stocks_) {
-        symbols.push_back(pair.first);
+    symbols.reserve(ids_.size());
+    for (InstrumentId id : ids_) {
+        symbols.push_back(stocks_.find(id)->symbol);
     }
     return symbols;
 }
@@ -1,13 +1,16 @@
 #pragma once
 
+#include "InstrumentRegistry.h"
+#include "Order.h"
+
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 /// @brief CSV配置中单个股票的参数
 struct StockParams {
     std::string shortname;      // 股票简称
     std::string symbol;         // 股票代码（带.SH/.SZ后缀）
+    InstrumentId id = kInvalidInstrument;  // 证券 ID（加载时注册）
     std::string trading_date;   // 交易日期 YYYY-MM-DD
     
     // 持仓信息
@@ -28,11 +31,10 @@ struct StockParams {
     int64_t sold_vol = 0;       // 已卖数量
     double jjamt = 0.0;         // 集合竞价金额
     double open_price = 0.0;    // 开盘价
-    std::string remark;         // 订单备注
+    OrderTag order_tag = 0;     // 最近一次委托的订单标签
     int call_back = 0;          // 撤单标志
     int return1_sell = 0;       // 竞价阶段return1卖出标志
     int64_t total_sell = 0;     // 总卖出数量（竞价策略用）
-    std::string userOrderId;    // 用户订单ID
     double dt_price = 0.0;      // 跌停价
     int limit_sell = 0;         // 涨停未封板半仓卖出标志
 };
@@ -53,18 +55,26 @@ public:
     StockParams* get_stock(const std::string& symbol);
     const StockParams* get_stock(const std::string& symbol) const;
     
+    /// @brief 按证券 ID 获取股票参数（O(1)）
+    StockParams* get_stock(InstrumentId id);
+    const StockParams* get_stock(InstrumentId id) const;
+    
     /// @brief 获取所有股票代码列表
     std::vector<std::string> get_all_symbols() const;
     
+    /// @brief 获取所有证券 ID（按CSV顺序）
+    const std::vector<InstrumentId>& ids() const { return ids_; }
+    
     /// @brief 获取股票数量
     size_t size() const { return stocks_.size(); }
     
     /// @brief 清空配置
-    void clear() { stocks_.clear(); }
+    void clear() { stocks_.clear(); ids_.clear(); }
     
 private:
-    // symbol -> StockParams
-    std::unordered_map<std::string, StockParams> stocks_;
+    // InstrumentId -> StockParams
+    InstrumentMap<StockParams> stocks_;
+    std::vector<InstrumentId> ids_;
     
     /// @brief 解析单行CSV数据
     std::vector<std::string> parse_line(const std::string& line);
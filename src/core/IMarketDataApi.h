@@ -1,5 +1,8 @@
 #pragma once
+#include "InstrumentRegistry.h"
 #include "MarketData.h"
+#include "MarketUpdateQueue.h"
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
@@ -25,21 +28,58 @@ public:
     /// @brief 是否已连接
     virtual bool is_connected() const = 0;
     
-    /// @brief 获取行情快照
+    /// @brief 获取行情快照（按证券 ID，热路径使用）
+    /// @param id InstrumentRegistry 分配的证券 ID
+    /// @return 行情快照
+    virtual MarketSnapshot get_snapshot(InstrumentId id) = 0;
+    
+    /// @brief 获取涨跌停价（按证券 ID）
+    /// @param id InstrumentRegistry 分配的证券 ID
+    /// @return 涨停价、跌停价
+    virtual std::pair<double, double> get_limits(InstrumentId id) = 0;
+    
+    /// @brief 获取行情快照（字符串代码适配，内部转为 ID）
     /// @param symbol 股票代码
     /// @return 行情快照
-    virtual MarketSnapshot get_snapshot(const std::string& symbol) = 0;
+    virtual MarketSnapshot get_snapshot(const std::string& symbol) {
+        return get_snapshot(InstrumentRegistry::instance().find(symbol));
+    }
     
-    /// @brief 获取涨跌停价
+    /// @brief 获取涨跌停价（字符串代码适配，内部转为 ID）
     /// @param symbol 股票代码
     /// @return 涨停价、跌停价
-    virtual std::pair<double, double> get_limits(const std::string& symbol) = 0;
+    virtual std::pair<double, double> get_limits(const std::string& symbol) {
+        return get_limits(InstrumentRegistry::instance().find(symbol));
+    }
+    
+    /// @brief 获取买一委托队列（涨停封单深度，可选扩展）
+    /// @param id InstrumentRegistry 分配的证券 ID
+    /// @param out 最近一次买一队列；sealed 表示该价位为涨停价
+    /// @return 行情源不支持或尚未收到队列时返回 false
+    virtual bool get_limit_up_queue(InstrumentId id, LimitUpQueue& out) {
+        (void)id;
+        (void)out;
+        return false;
+    }
+    
+    /// @brief 订阅行情更新推送（可选扩展）
+    /// @param ids 关注的证券；之后可通过返回队列的 watch/unwatch 调整
+    /// @return 更新队列（由订阅者线程 drain/wait_until）；行情源不支持推送时返回空，调用方继续轮询
+    virtual std::shared_ptr<MarketUpdateQueue> subscribe_updates(const std::vector<InstrumentId>& ids) {
+        (void)ids;
+        return nullptr;
+    }
+    
+    /// @brief 取消行情更新推送
+    virtual void unsubscribe_updates(const std::shared_ptr<MarketUpdateQueue>& queue) {
+        (void)queue;
+    }
     
     /// @brief 获取集合竞价数据
     /// @param symbol 股票代码
     /// @param date 日期 YYYYMMDD格式
     /// @param end_time 截止时间 "HHMMSS" 或 "HHMMSSmmm" 格式，如 "092700" 或 "092700000"
-    /// @return 开盘价、集合竞价成交金额
+    /// @return 集合竞价撮合价（开盘竞价即开盘价）、集合竞价成交金额
     virtual std::pair<double, double> get_auction_data(
         const std::string& symbol,
         const std::string& date,
@@ -2,8 +2,10 @@
 #include "Order.h"
 #include "MarketData.h"
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /// @brief 交易回调接口（对应 Python 的 XtQuantTraderCallback）
@@ -56,18 +58,159 @@ public:
     /// @return 委托结果（包含 order_id）
     virtual std::string place_order(const OrderRequest& req) = 0;
 
+    /// @brief 批量下单
+    /// @param reqs 委托请求列表
+    /// @return 与 reqs 一一对应的订单 ID，失败的腿为空字符串
+    /// 默认逐笔调用 place_order；支持批量委托的柜台可覆盖为一次往返
+    virtual std::vector<std::string> place_orders(const std::vector<OrderRequest>& reqs) {
+        std::vector<std::string> ids;
+        ids.reserve(reqs.size());
+        for (const auto& req : reqs) {
+            ids.push_back(place_order(req));
+        }
+        return ids;
+    }
+
     /// @brief 撤单（对应 cancel）
     /// @param order_id 订单系统 ID
     /// @return 是否成功
     virtual bool cancel_order(const std::string& order_id) = 0;
 
+    /// @brief 批量撤单
+    /// @param order_ids 订单 ID 列表
+    /// @return 与 order_ids 一一对应的撤单请求结果
+    /// 默认逐笔调用 cancel_order；支持批量撤单的柜台可覆盖
+    virtual std::vector<bool> cancel_orders(const std::vector<std::string>& order_ids) {
+        std::vector<bool> results;
+        results.reserve(order_ids.size());
+        for (const auto& order_id : order_ids) {
+            results.push_back(cancel_order(order_id));
+        }
+        return results;
+    }
+
     /// @brief 查询持仓（对应 get_trade_detail_data POSITION）
     /// @return 持仓列表
     virtual std::vector<Position> query_positions() = 0;
 
+    /// @brief 读取本地维护的持仓台账（不访问柜台，实现须线程安全）
+    /// @param out 持仓列表
+    /// @return 不支持或尚未建账时返回 false
+    virtual bool query_positions_local(std::vector<Position>& out) {
+        (void)out;
+        return false;
+    }
+
+    /// @brief 用柜台持仓对账本地台账
+    /// @return 存在偏差的证券数；不支持时返回 0
+    virtual size_t reconcile_positions() { return 0; }
+
     /// @brief 查询订单（对应 query_stock_orders）
     /// @return 订单列表
     virtual std::vector<OrderResult> query_orders() = 0;
+
+    /// @brief 按证券查询订单；默认实现为全量查询后过滤，柜台实现应改为过滤查询
+    virtual std::vector<OrderResult> query_orders(const std::string& symbol) {
+        std::vector<OrderResult> result;
+        for (auto& order : query_orders()) {
+            if (order.symbol == symbol) {
+                result.push_back(std::move(order));
+            }
+        }
+        return result;
+    }
+
+    /// @brief 查询单个订单；默认实现为全量查询后查找，未找到时 success=false
+    virtual OrderResult query_order(const std::string& order_id) {
+        for (auto& order : query_orders()) {
+            if (order.order_id == order_id) {
+                return order;
+            }
+        }
+        OrderResult result;
+        result.success = false;
+        result.err_msg = "Order not found";
+        return result;
+    }
+
+    /// @brief 读取本地订单簿中某证券的未终结订单，追加到 out（不访问柜台，实现须线程安全）
+    /// @return 不支持时返回 false
+    virtual bool query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) {
+        (void)instrument;
+        (void)out;
+        return false;
+    }
+
+    /// @brief 读取本地订单簿中标签键（策略 + 证券，见 order_tag_key）相同的订单（含已终结），追加到 out
+    /// 不访问柜台，实现须线程安全
+    /// @return 不支持时返回 false
+    virtual bool query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) {
+        (void)tag_key;
+        (void)out;
+        return false;
+    }
+
+    /// @brief 按标签键取订单（含已终结），结果与 keys 一一对应
+    /// 优先读本地订单簿；不支持时全量查询一次后按标签键分组
+    std::vector<std::vector<OrderResult>> query_orders_by_tags(const std::vector<uint32_t>& keys) {
+        std::vector<std::vector<OrderResult>> result(keys.size());
+        if (keys.empty() || query_orders_by_tag_local(keys[0], result[0])) {
+            for (size_t k = 1; k < keys.size(); ++k) {
+                query_orders_by_tag_local(keys[k], result[k]);
+            }
+            return result;
+        }
+        std::unordered_map<uint32_t, std::vector<size_t>> slots;
+        for (size_t k = 0; k < keys.size(); ++k) {
+            slots[keys[k]].push_back(k);
+        }
+        for (auto& order : query_orders()) {
+            auto it = order.tag != 0 ? slots.find(order_tag_key(order.tag)) : slots.end();
+            if (it == slots.end()) {
+                continue;
+            }
+            for (size_t k : it->second) {
+                result[k].push_back(order);
+            }
+        }
+        return result;
+    }
+
+    /// @brief 本地订单的资金账号与证券代码（撤单按所撤订单的账号/交易所计入委托限流）
+    /// @return 非本地订单或不支持时返回 false
+    virtual bool order_route(const std::string& order_id, std::string& account, std::string& symbol) {
+        (void)order_id;
+        (void)account;
+        (void)symbol;
+        return false;
+    }
+
+    // ========== 非阻塞接口：立即返回 future，结果在需要时再取 ==========
+    // 默认实现在调用线程同步执行并返回已就绪的 future；排队实现（QueuedTradingApi）覆盖为真正异步
+
+    virtual std::future<std::string> place_order_async(const OrderRequest& req) {
+        return ready_future(place_order(req));
+    }
+
+    virtual std::future<bool> cancel_order_async(const std::string& order_id) {
+        return ready_future(cancel_order(order_id));
+    }
+
+    virtual std::future<std::vector<Position>> query_positions_async() {
+        return ready_future(query_positions());
+    }
+
+    virtual std::future<std::vector<OrderResult>> query_orders_async() {
+        return ready_future(query_orders());
+    }
+
+protected:
+    template <typename T>
+    static std::future<T> ready_future(T value) {
+        std::promise<T> promise;
+        promise.set_value(std::move(value));
+        return promise.get_future();
+    }
 };
 
 using TradingApiPtr = std::shared_ptr<ITradingApi>;
@@ -0,0 +1,116 @@
+#include "InstrumentRegistry.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+const std::string kEmptySymbol;
+}
+
+const size_t InstrumentRegistry::kCapacity;  // std::min 等按引用使用时需要定义
+
+InstrumentRegistry& InstrumentRegistry::instance() {
+    static InstrumentRegistry registry;
+    return registry;
+}
+
+InstrumentRegistry::InstrumentRegistry()
+    : size_(0),
+      buckets_(new std::atomic<int32_t>[kBuckets]),
+      infos_(new InstrumentInfo[kCapacity]),
+      symbols_(new std::string[kCapacity]) {
+    for (size_t i = 0; i < kBuckets; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    std::memset(infos_.get(), 0, sizeof(InstrumentInfo) * kCapacity);
+}
+
+uint32_t InstrumentRegistry::hash_key(const char* symbol) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(InstrumentInfo::symbol) && symbol[i] != '\0'; ++i) {
+        h ^= static_cast<unsigned char>(symbol[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+InstrumentId InstrumentRegistry::probe(const char* symbol, size_t* empty_bucket) const {
+    size_t mask = kBuckets - 1;
+    size_t idx = hash_key(symbol) & mask;
+    for (size_t n = 0; n < kBuckets; ++n) {
+        int32_t slot = buckets_[idx].load(std::memory_order_acquire);
+        if (slot == 0) {
+            if (empty_bucket) {
+                *empty_bucket = idx;
+            }
+            return kInvalidInstrument;
+        }
+        const InstrumentInfo& info = infos_[static_cast<size_t>(slot - 1)];
+        if (std::strncmp(info.symbol, symbol, sizeof(info.symbol)) == 0) {
+            return slot - 1;
+        }
+        idx = (idx + 1) & mask;
+    }
+    return kInvalidInstrument;
+}
+
+InstrumentId InstrumentRegistry::find(const char* symbol) const {
+    if (!symbol || symbol[0] == '\0') {
+        return kInvalidInstrument;
+    }
+    return probe(symbol, nullptr);
+}
+
+InstrumentId InstrumentRegistry::intern(const std::string& symbol) {
+    if (symbol.empty() || symbol.size() >= sizeof(InstrumentInfo::symbol)) {
+        return kInvalidInstrument;
+    }
+
+    InstrumentId id = find(symbol.c_str());
+    if (id != kInvalidInstrument) {
+        return id;
+    }
+
+    std::lock_guard<std::mutex> lock(intern_mutex_);
+    size_t bucket = 0;
+    id = probe(symbol.c_str(), &bucket);
+    if (id != kInvalidInstrument) {
+        return id;
+    }
+
+    size_t next = static_cast<size_t>(size_.load(std::memory_order_relaxed));
+    if (next >= kCapacity) {
+        std::cerr << "[Instrument] registry full, drop " << symbol << std::endl;
+        return kInvalidInstrument;
+    }
+
+    InstrumentInfo& info = infos_[next];
+    std::strncpy(info.symbol, symbol.c_str(), sizeof(info.symbol) - 1);
+    size_t dot = symbol.find('.');
+    std::string code = symbol.substr(0, dot);
+    std::strncpy(info.code, code.c_str(), sizeof(info.code) - 1);
+    if (dot != std::string::npos) {
+        std::strncpy(info.market, symbol.c_str() + dot + 1, sizeof(info.market) - 1);
+    }
+    symbols_[next] = symbol;
+
+    // 先发布 size（按 ID 访问可见），再发布哈希桶（按代码查找可见）
+    size_.store(static_cast<int32_t>(next + 1), std::memory_order_release);
+    buckets_[bucket].store(static_cast<int32_t>(next + 1), std::memory_order_release);
+    return static_cast<InstrumentId>(next);
+}
+
+const std::string& InstrumentRegistry::symbol(InstrumentId id) const {
+    if (!valid(id)) {
+        return kEmptySymbol;
+    }
+    return symbols_[static_cast<size_t>(id)];
+}
+
+const InstrumentInfo* InstrumentRegistry::info(InstrumentId id) const {
+    if (!valid(id)) {
+        return nullptr;
+    }
+    return &infos_[static_cast<size_t>(id)];
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief 证券代码的紧凑整数 ID（0 起连续编号）
+using InstrumentId = int32_t;
+static const InstrumentId kInvalidInstrument = -1;
+
+/// @brief 证券静态信息（intern 时一次性解析）
+struct InstrumentInfo {
+    char symbol[16];   ///< 完整代码，如 600000.SH
+    char code[8];      ///< 6 位证券代码，如 600000
+    char market[4];    ///< 交易所，SH / SZ（无后缀时为空）
+};
+
+/// @brief 证券代码注册表：把 "600000.SH" 形式的代码 intern 成连续整数 ID
+///
+/// - 启动时由 CsvConfig / 行情订阅列表批量注册，运行中遇到新代码也可追加；
+/// - 注册在互斥锁内串行执行；查找与按 ID 取代码完全无锁，可在行情回调中使用；
+/// - ID 一经分配永不回收，容量固定为 kCapacity。
+class InstrumentRegistry {
+public:
+    static const size_t kCapacity = 16384;
+
+    /// @brief 进程内唯一实例
+    static InstrumentRegistry& instance();
+
+    /// @brief 注册代码，已存在时返回原 ID
+    /// @return ID；代码非法或容量已满返回 kInvalidInstrument
+    InstrumentId intern(const std::string& symbol);
+
+    /// @brief 查找代码（无锁，不分配内存）
+    InstrumentId find(const char* symbol) const;
+    InstrumentId find(const std::string& symbol) const { return find(symbol.c_str()); }
+
+    /// @brief 按 ID 取完整代码；ID 非法时返回空串
+    const std::string& symbol(InstrumentId id) const;
+
+    /// @brief 按 ID 取静态信息；ID 非法时返回 nullptr
+    const InstrumentInfo* info(InstrumentId id) const;
+
+    /// @brief 已注册数量（合法 ID 范围为 [0, size)）
+    size_t size() const { return static_cast<size_t>(size_.load(std::memory_order_acquire)); }
+
+    bool valid(InstrumentId id) const {
+        return id >= 0 && static_cast<size_t>(id) < size();
+    }
+
+private:
+    InstrumentRegistry();
+    InstrumentRegistry(const InstrumentRegistry&) = delete;
+    InstrumentRegistry& operator=(const InstrumentRegistry&) = delete;
+
+    static const size_t kBuckets = kCapacity * 2;  // 2 的幂，负载因子 <= 0.5
+
+    static uint32_t hash_key(const char* symbol);
+    InstrumentId probe(const char* symbol, size_t* empty_bucket) const;
+
+    std::mutex intern_mutex_;
+    std::atomic<int32_t> size_;
+    std::unique_ptr<std::atomic<int32_t>[]> buckets_;  // 存 id + 1，0 表示空
+    std::unique_ptr<InstrumentInfo[]> infos_;
+    std::unique_ptr<std::string[]> symbols_;
+};
+
+/// @brief 以 InstrumentId 为下标的稠密表（替代 std::map<std::string, T>）
+///
+/// 非线程安全，由持有者自行加锁。遍历顺序为 ID 升序（即注册顺序）。
+template <typename T>
+class InstrumentMap {
+public:
+    T* find(InstrumentId id) {
+        return contains(id) ? &values_[static_cast<size_t>(id)] : nullptr;
+    }
+
+    const T* find(InstrumentId id) const {
+        return contains(id) ? &values_[static_cast<size_t>(id)] : nullptr;
+    }
+
+    bool contains(InstrumentId id) const {
+        return id >= 0 && static_cast<size_t>(id) < present_.size() && present_[static_cast<size_t>(id)];
+    }
+
+    /// @brief 取值，不存在时插入默认值；id 必须合法
+    T& operator[](InstrumentId id) {
+        size_t idx = static_cast<size_t>(id);
+        if (idx >= values_.size()) {
+            values_.resize(idx + 1);
+            present_.resize(idx + 1, 0);
+        }
+        if (!present_[idx]) {
+            present_[idx] = 1;
+            values_[idx] = T();
+            ++count_;
+        }
+        return values_[idx];
+    }
+
+    void erase(InstrumentId id) {
+        if (contains(id)) {
+            present_[static_cast<size_t>(id)] = 0;
+            values_[static_cast<size_t>(id)] = T();
+            --count_;
+        }
+    }
+
+    void clear() {
+        values_.clear();
+        present_.clear();
+        count_ = 0;
+    }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// @brief 按 ID 升序遍历：f(InstrumentId, T&)
+    template <typename F>
+    void for_each(F f) {
+        for (size_t i = 0; i < values_.size(); ++i) {
+            if (present_[i]) {
+                f(static_cast<InstrumentId>(i), values_[i]);
+            }
+        }
+    }
+
+    template <typename F>
+    void for_each(F f) const {
+        for (size_t i = 0; i < values_.size(); ++i) {
+            if (present_[i]) {
+                f(static_cast<InstrumentId>(i), values_[i]);
+            }
+        }
+    }
+
+private:
+    std::vector<T> values_;
+    std::vector<uint8_t> present_;
+    size_t count_ = 0;
+};
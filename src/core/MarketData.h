@@ -1,10 +1,20 @@
 #pragma once
+#include "InstrumentRegistry.h"
 #include <string>
 #include <cstdint>
 
-/// @brief 市场行情快照（扩展版，包含五档盘口）
+/// @brief 盘口档数
+static const int kDepthLevels = 10;
+
+/// @brief 定点价格倍数（与 TDF 原始价格单位一致：元 × 10000）
+static const int64_t kPriceScale = 10000;
+
+/// @brief 市场行情快照（十档盘口，可平凡拷贝）
+///
+/// 盘口按数组连续存放，价格为定点整数（元 × kPriceScale），0 档为买一/卖一；
+/// 不含 std::string，证券代码通过 instrument 从 InstrumentRegistry 取得。
 struct MarketSnapshot {
-    std::string symbol;
+    InstrumentId instrument = kInvalidInstrument;
     int timestamp = 0;           // 时间戳 (HHMMSSmmm格式)
     
     // 基础价格
@@ -21,34 +31,63 @@ struct MarketSnapshot {
     // 成交量和成交额
     int64_t volume = 0;          // 成交量
     int64_t turnover = 0;        // 成交额
+    int64_t num_trades = 0;      // 成交笔数
     
-    // 五档买盘
-    double bid_price1 = 0.0;
-    double bid_price2 = 0.0;
-    double bid_price3 = 0.0;
-    double bid_price4 = 0.0;
-    double bid_price5 = 0.0;
-    
-    int64_t bid_volume1 = 0;
-    int64_t bid_volume2 = 0;
-    int64_t bid_volume3 = 0;
-    int64_t bid_volume4 = 0;
-    int64_t bid_volume5 = 0;
-    
-    // 五档卖盘
-    double ask_price1 = 0.0;
-    double ask_price2 = 0.0;
-    double ask_price3 = 0.0;
-    double ask_price4 = 0.0;
-    double ask_price5 = 0.0;
-    
-    int64_t ask_volume1 = 0;
-    int64_t ask_volume2 = 0;
-    int64_t ask_volume3 = 0;
-    int64_t ask_volume4 = 0;
-    int64_t ask_volume5 = 0;
+    // 十档盘口（定点价格 / 委托量）
+    int64_t bid_px[kDepthLevels] = {};
+    int64_t bid_qty[kDepthLevels] = {};
+    int64_t ask_px[kDepthLevels] = {};
+    int64_t ask_qty[kDepthLevels] = {};
+    
+    // 全市场委托汇总
+    int64_t total_bid_volume = 0;  // 委托买入总量
+    int64_t total_ask_volume = 0;  // 委托卖出总量
+    int64_t weighted_avg_bid_px = 0;  // 加权平均委买价（定点）
+    int64_t weighted_avg_ask_px = 0;  // 加权平均委卖价（定点）
     
     bool valid = false;
+    
+    /// @brief 证券代码（如 600000.SH）
+    const std::string& symbol() const {
+        return InstrumentRegistry::instance().symbol(instrument);
+    }
+    
+    /// @brief 第 level 档买价（元），level 从 0 开始，0 为买一
+    double bid_price(int level) const { return static_cast<double>(bid_px[level]) / kPriceScale; }
+    /// @brief 第 level 档卖价（元），level 从 0 开始，0 为卖一
+    double ask_price(int level) const { return static_cast<double>(ask_px[level]) / kPriceScale; }
+    /// @brief 第 level 档买量
+    int64_t bid_volume(int level) const { return bid_qty[level]; }
+    /// @brief 第 level 档卖量
+    int64_t ask_volume(int level) const { return ask_qty[level]; }
+    
+    /// @brief 前 levels 档卖盘累计委托量（可见卖方流动性）
+    int64_t ask_depth(int levels = kDepthLevels) const {
+        int64_t sum = 0;
+        for (int i = 0; i < levels && i < kDepthLevels; ++i) {
+            sum += ask_qty[i];
+        }
+        return sum;
+    }
+    
+    /// @brief 前 levels 档买盘累计委托量（可见买方流动性）
+    int64_t bid_depth(int levels = kDepthLevels) const {
+        int64_t sum = 0;
+        for (int i = 0; i < levels && i < kDepthLevels; ++i) {
+            sum += bid_qty[i];
+        }
+        return sum;
+    }
+};
+
+/// @brief 买一委托队列（来自行情委托队列推送，用于判断涨停封单强弱）
+struct LimitUpQueue {
+    int timestamp = 0;           // 时间戳 (HHMMSSmmm格式)
+    double price = 0.0;          // 买一队列价格
+    int64_t volume = 0;          // 队列明细累计委托量（明细不全时为下限）
+    int32_t orders = 0;          // 该价位总委托笔数
+    int32_t items = 0;           // 推送的明细笔数（<= orders）
+    bool sealed = false;         // 买一价格等于涨停价（封板中）
 };
 
 /// @brief 持仓信息（用于可用量校验）
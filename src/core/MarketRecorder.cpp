@@ -0,0 +1,310 @@
+#include "MarketRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 写线程空闲时的轮询间隔（回调线程不负责唤醒）
+const std::chrono::milliseconds kIdleWait(1);
+
+#ifndef _WIN32
+// 每次映射的文件块大小（同时是文件扩展步长）
+const uint64_t kMapChunk = 64ull << 20;
+#endif
+
+std::tm local_tm(std::time_t t) {
+    std::tm tm_val{};
+#ifdef _WIN32
+    localtime_s(&tm_val, &t);
+#else
+    localtime_r(&t, &tm_val);
+#endif
+    return tm_val;
+}
+
+bool file_exists(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    std::fclose(f);
+    return true;
+}
+
+}  // namespace
+
+const char MarketRecorder::kMagic[8] = {'M', 'D', 'J', 'R', 'N', 'L', '0', '1'};
+
+MarketRecorder::MarketRecorder(std::string dir, size_t buffer_bytes)
+    : dir_(std::move(dir)),
+      capacity_(1),
+      mask_(0),
+      head_(0),
+      tail_(0),
+      dropped_(0),
+      records_(0),
+      bytes_(0),
+      stopping_(false) {
+    while (capacity_ < buffer_bytes) {
+        capacity_ <<= 1;
+    }
+    mask_ = capacity_ - 1;
+    ring_.reset(new char[capacity_]);
+}
+
+MarketRecorder::~MarketRecorder() {
+    stop();
+}
+
+bool MarketRecorder::start() {
+    if (writer_.joinable()) {
+        return true;
+    }
+    if (!open_journal()) {
+        close_journal();
+        return false;
+    }
+    stopping_.store(false, std::memory_order_release);
+    writer_ = std::thread([this]() { writer_loop(); });
+    std::cout << "[REC] 行情记录: " << path_ << " buffer=" << (capacity_ >> 20) << "MB" << std::endl;
+    return true;
+}
+
+void MarketRecorder::stop() {
+    if (!writer_.joinable()) {
+        return;
+    }
+    stopping_.store(true, std::memory_order_release);
+    writer_.join();
+    close_journal();
+}
+
+int64_t MarketRecorder::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void MarketRecorder::record(int32_t data_type, int32_t server_time, const void* items,
+                            int32_t item_size, int32_t item_count, int64_t recv_ns) {
+    if (!items || item_size <= 0 || item_count <= 0) {
+        return;
+    }
+    size_t payload = static_cast<size_t>(item_size) * static_cast<size_t>(item_count);
+    size_t length = (sizeof(RecordHeader) + payload + 7) & ~static_cast<size_t>(7);
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (length > capacity_ || length > UINT32_MAX ||
+        tail + length - head_.load(std::memory_order_acquire) > capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    RecordHeader header;
+    header.length = static_cast<uint32_t>(length);
+    header.data_type = data_type;
+    header.item_size = item_size;
+    header.item_count = item_count;
+    header.server_time = server_time;
+    header.reserved = 0;
+    header.recv_ns = recv_ns;
+
+    static const char kPadding[8] = {};
+    copy_in(tail, &header, sizeof(header));
+    copy_in(tail + sizeof(header), items, payload);
+    copy_in(tail + sizeof(header) + payload, kPadding, length - sizeof(header) - payload);
+    tail_.store(tail + length, std::memory_order_release);
+}
+
+MarketRecorder::Stats MarketRecorder::stats() const {
+    Stats s;
+    s.records = records_.load(std::memory_order_relaxed);
+    s.bytes = bytes_.load(std::memory_order_relaxed);
+    s.dropped = dropped_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void MarketRecorder::copy_in(uint64_t pos, const void* src, size_t n) {
+    size_t off = static_cast<size_t>(pos & mask_);
+    size_t first = std::min(n, capacity_ - off);
+    std::memcpy(ring_.get() + off, src, first);
+    if (n > first) {
+        std::memcpy(ring_.get(), static_cast<const char*>(src) + first, n - first);
+    }
+}
+
+void MarketRecorder::writer_loop() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    while (true) {
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        if (head == tail) {
+            // 先读停止标志再复查缓冲，停止前已入队的记录全部写完
+            if (stopping_.load(std::memory_order_acquire) &&
+                tail_.load(std::memory_order_acquire) == head) {
+                break;
+            }
+            std::this_thread::sleep_for(kIdleWait);
+            continue;
+        }
+
+        if (std::time(nullptr) >= day_end_) {
+            close_journal();
+            open_journal();
+        }
+
+        while (head != tail) {
+            RecordHeader header;
+            size_t off = static_cast<size_t>(head & mask_);
+            size_t first = std::min(sizeof(header), capacity_ - off);
+            std::memcpy(&header, ring_.get() + off, first);
+            if (first < sizeof(header)) {
+                std::memcpy(reinterpret_cast<char*>(&header) + first, ring_.get(), sizeof(header) - first);
+            }
+
+            size_t length = header.length;
+            size_t span = std::min(length, capacity_ - off);
+            uint64_t start = pos_;
+            bool ok = append(ring_.get() + off, span) && (span == length || append(ring_.get(), length - span));
+            if (ok) {
+                records_.store(records_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                bytes_.store(bytes_.load(std::memory_order_relaxed) + length, std::memory_order_relaxed);
+            } else {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                if (journal_open()) {
+                    // 停止记录：日志截止到上一条完整记录，跨日前的记录都计入丢弃
+                    std::cerr << "[REC] 写行情日志失败，停止记录: " << path_ << std::endl;
+                    pos_ = start;
+                    close_journal();
+                }
+            }
+            head += length;
+            head_.store(head, std::memory_order_release);
+        }
+    }
+}
+
+bool MarketRecorder::open_journal() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm_val = local_tm(now);
+    char date[16];
+    std::strftime(date, sizeof(date), "%Y%m%d", &tm_val);
+
+    tm_val.tm_mday += 1;
+    tm_val.tm_hour = 0;
+    tm_val.tm_min = 0;
+    tm_val.tm_sec = 0;
+    tm_val.tm_isdst = -1;
+    day_end_ = std::mktime(&tm_val);
+
+    // 同一天重启时另起分段，不改写已有日志
+    std::string base = dir_ + "/md_" + date;
+    path_ = base + ".bin";
+    for (int seg = 1; file_exists(path_); ++seg) {
+        path_ = base + "." + std::to_string(seg) + ".bin";
+    }
+
+    pos_ = 0;
+#ifdef _WIN32
+    file_ = std::fopen(path_.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "[REC] 无法创建行情日志: " << path_ << std::endl;
+        return false;
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+#else
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd_ < 0) {
+        std::cerr << "[REC] 无法创建行情日志: " << path_ << std::endl;
+        return false;
+    }
+#endif
+
+    FileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.record_header = sizeof(RecordHeader);
+    return append(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+bool MarketRecorder::append(const char* data, size_t n) {
+#ifdef _WIN32
+    if (!file_ || std::fwrite(data, 1, n, file_) != n) {
+        return false;
+    }
+    pos_ += n;
+    return true;
+#else
+    if (fd_ < 0) {
+        return false;
+    }
+    while (n > 0) {
+        if (!map_ || pos_ >= map_offset_ + kMapChunk) {
+            // 映射下一块：先分配磁盘空间，再映射。只用 ftruncate 扩展得到的是稀疏文件，
+            // 磁盘满时要到写映射内存才失败（SIGBUS），这里提前以返回值报告
+            if (map_) {
+                ::munmap(map_, kMapChunk);
+                map_ = nullptr;
+            }
+            map_offset_ = pos_ & ~(kMapChunk - 1);
+            int err = ::posix_fallocate(fd_, static_cast<off_t>(map_offset_), static_cast<off_t>(kMapChunk));
+            if (err != 0) {
+                std::cerr << "[REC] 行情日志分配空间失败: " << path_ << " (" << std::strerror(err) << ")"
+                          << std::endl;
+                return false;
+            }
+            void* addr = ::mmap(nullptr, kMapChunk, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                                static_cast<off_t>(map_offset_));
+            if (addr == MAP_FAILED) {
+                std::cerr << "[REC] mmap 失败: " << path_ << std::endl;
+                return false;
+            }
+            map_ = static_cast<char*>(addr);
+        }
+        size_t room = static_cast<size_t>(map_offset_ + kMapChunk - pos_);
+        size_t k = std::min(n, room);
+        std::memcpy(map_ + (pos_ - map_offset_), data, k);
+        pos_ += k;
+        data += k;
+        n -= k;
+    }
+    return true;
+#endif
+}
+
+bool MarketRecorder::journal_open() const {
+#ifdef _WIN32
+    return file_ != nullptr;
+#else
+    return fd_ >= 0;
+#endif
+}
+
+void MarketRecorder::close_journal() {
+#ifdef _WIN32
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+#else
+    if (map_) {
+        ::munmap(map_, kMapChunk);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        // 截掉最后一块中未写入的部分
+        if (::ftruncate(fd_, static_cast<off_t>(pos_)) != 0) {
+            std::cerr << "[REC] 截断行情日志失败: " << path_ << std::endl;
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+
+/// @brief 行情原始数据记录器：把行情回调收到的原始结构体追加写入按日分文件的二进制日志，供离线回放与性能分析
+///
+/// - 回调线程（单写）只把记录头 + 原始数据拷入预分配的环形缓冲，无锁、不分配内存、不做系统调用；
+///   缓冲满时丢弃该条并计数，绝不阻塞回调；
+/// - 独立写线程取出记录追加到日志文件：POSIX 下按块预分配磁盘空间后 mmap 写入，Windows 下退化为带缓冲的 fwrite；
+/// - 写文件失败（如磁盘空间不足）时关闭日志、停止记录，文件截止到最后一条完整记录，
+///   之后的记录丢弃并计数，跨日时再尝试打开新日志；
+/// - 日志文件为 <dir>/md_YYYYMMDD.bin（当日已存在时依次为 md_YYYYMMDD.1.bin ...），跨日自动切换。
+///
+/// 文件格式（小端，按 8 字节对齐）：FileHeader，之后为连续的 RecordHeader + item_count 个原始结构体；
+/// 进程异常退出时文件末尾可能残留零填充，length 为 0 即表示日志结束。
+class MarketRecorder {
+public:
+    /// @brief 文件头
+    struct FileHeader {
+        char magic[8];            // "MDJRNL01"
+        uint32_t version;         // 1
+        uint32_t record_header;   // sizeof(RecordHeader)
+    };
+
+    /// @brief 记录头（其后紧跟 item_count 个 item_size 字节的原始结构体）
+    struct RecordHeader {
+        uint32_t length;          // 记录总长（含记录头与对齐填充）
+        int32_t data_type;        // 行情源的数据类型（TDF: MSG_DATA_MARKET / MSG_DATA_TRANSACTION / ...）
+        int32_t item_size;        // 单个结构体字节数
+        int32_t item_count;       // 结构体个数
+        int32_t server_time;      // 行情服务器时间 HHMMSSmmm
+        int32_t reserved;
+        int64_t recv_ns;          // 本地接收时间（Unix 纳秒）
+    };
+
+    /// @brief 记录统计
+    struct Stats {
+        uint64_t records = 0;     // 已写入日志的记录数
+        uint64_t bytes = 0;       // 已写入日志的字节数
+        uint64_t dropped = 0;     // 缓冲满或写文件失败丢弃的记录数
+    };
+
+    static const char kMagic[8];
+    static const uint32_t kVersion = 1;
+
+    /// @param dir 日志目录（须已存在）
+    /// @param buffer_bytes 环形缓冲大小，向上取 2 的幂
+    MarketRecorder(std::string dir, size_t buffer_bytes);
+    ~MarketRecorder();
+
+    MarketRecorder(const MarketRecorder&) = delete;
+    MarketRecorder& operator=(const MarketRecorder&) = delete;
+
+    /// @brief 打开当日日志并启动写线程
+    bool start();
+
+    /// @brief 写完缓冲中已有的记录后关闭日志（可重复调用）
+    void stop();
+
+    /// @brief 当前本地时间（Unix 纳秒），回调入口处取接收时间用
+    static int64_t now_ns();
+
+    /// @brief 追加一条记录（仅行情回调线程调用）
+    void record(int32_t data_type, int32_t server_time, const void* items,
+                int32_t item_size, int32_t item_count, int64_t recv_ns);
+
+    Stats stats() const;
+
+    /// @brief 当前日志文件路径（写线程未运行时调用）
+    const std::string& path() const { return path_; }
+
+private:
+    void copy_in(uint64_t pos, const void* src, size_t n);
+    void writer_loop();
+
+    // 日志文件（仅写线程访问）
+    bool open_journal();
+    bool append(const char* data, size_t n);
+    bool journal_open() const;
+    void close_journal();
+
+    std::string dir_;
+    std::string path_;
+    std::time_t day_end_ = 0;     // 当前日志对应日期的结束时刻
+
+    std::unique_ptr<char[]> ring_;
+    size_t capacity_;
+    size_t mask_;
+    // head_ 与 tail_ 由不同线程写，用填充隔开到不同缓存行（不用 alignas，避免超对齐类型的 new）
+    std::atomic<uint64_t> head_;                // 写线程位置
+    char head_pad_[64];
+    std::atomic<uint64_t> tail_;                // 回调线程位置
+    char tail_pad_[64];
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> records_;
+    std::atomic<uint64_t> bytes_;
+
+    std::atomic<bool> stopping_;
+    std::thread writer_;
+
+#ifdef _WIN32
+    std::FILE* file_ = nullptr;
+#else
+    int fd_ = -1;
+    char* map_ = nullptr;          // 当前映射块
+    uint64_t map_offset_ = 0;      // 映射块在文件中的偏移
+#endif
+    uint64_t pos_ = 0;             // 日志写入位置
+};
@@ -0,0 +1,97 @@
+#include "MarketUpdateQueue.h"
+
+namespace {
+size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+}
+
+MarketUpdateQueue::MarketUpdateQueue(size_t capacity)
+    : capacity_(capacity),
+      // 未取走的通知每个证券至多一条，取走过程中可能再各入队一条，2 倍容量即不会覆盖
+      mask_(round_up_pow2(capacity > 0 ? capacity * 2 : 2) - 1),
+      watched_(new std::atomic<uint8_t>[capacity]),
+      pending_(new std::atomic<uint8_t>[capacity]),
+      ring_(new MarketUpdate[mask_ + 1]),
+      head_(0),
+      tail_(0),
+      parked_(false) {
+    for (size_t i = 0; i < capacity_; ++i) {
+        watched_[i].store(0, std::memory_order_relaxed);
+        pending_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MarketUpdateQueue::watch(InstrumentId id) {
+    if (in_range(id)) {
+        watched_[static_cast<size_t>(id)].store(1, std::memory_order_relaxed);
+    }
+}
+
+void MarketUpdateQueue::unwatch(InstrumentId id) {
+    if (in_range(id)) {
+        watched_[static_cast<size_t>(id)].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MarketUpdateQueue::unwatch_all() {
+    for (size_t i = 0; i < capacity_; ++i) {
+        watched_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool MarketUpdateQueue::watching(InstrumentId id) const {
+    return in_range(id) && watched_[static_cast<size_t>(id)].load(std::memory_order_relaxed) != 0;
+}
+
+void MarketUpdateQueue::publish(InstrumentId id, uint64_t seq) {
+    if (!watching(id)) {
+        return;
+    }
+    // 已在队列中：读端取走后会读到最新快照，无需重复入队
+    if (pending_[static_cast<size_t>(id)].exchange(1) != 0) {
+        return;
+    }
+
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    ring_[tail & mask_] = MarketUpdate{id, seq};
+    tail_.store(tail + 1);
+
+    // 与 wait_until 中 parked_ 置位后再检查队列的顺序配对，保证不丢唤醒
+    if (parked_.load()) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+}
+
+size_t MarketUpdateQueue::drain(std::vector<MarketUpdate>& out) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    for (uint64_t i = head; i < tail; ++i) {
+        const MarketUpdate& update = ring_[i & mask_];
+        // 先清除待处理标记再交给读端读取快照，之后的写入会重新入队
+        pending_[static_cast<size_t>(update.id)].store(0);
+        out.push_back(update);
+    }
+    head_.store(tail, std::memory_order_release);
+    return static_cast<size_t>(tail - head);
+}
+
+bool MarketUpdateQueue::empty() const {
+    return head_.load(std::memory_order_relaxed) == tail_.load();
+}
+
+bool MarketUpdateQueue::wait_until(std::chrono::steady_clock::time_point deadline) {
+    if (!empty()) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    parked_.store(true);
+    bool ready = wake_cv_.wait_until(lock, deadline, [this]() { return !empty(); });
+    parked_.store(false);
+    return ready;
+}
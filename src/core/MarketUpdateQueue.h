@@ -0,0 +1,66 @@
+#pragma once
+#include "InstrumentRegistry.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// @brief 行情更新通知：证券 ID + 快照版本号
+struct MarketUpdate {
+    InstrumentId id;
+    uint64_t seq;  ///< 快照槽位版本号（每次写入递增）
+};
+
+/// @brief 单订阅者的行情更新队列（行情回调线程单写、模块线程单读）
+///
+/// - 按证券合并：同一证券在被取走之前只排队一次，读端取到通知后再读最新快照，
+///   因此环形缓冲按证券数预分配即不会溢出；
+/// - 写端无锁，只有读端处于等待状态时才加锁唤醒；
+/// - 回调线程只做入队，不执行任何模块代码。
+class MarketUpdateQueue {
+public:
+    explicit MarketUpdateQueue(size_t capacity = InstrumentRegistry::kCapacity);
+    MarketUpdateQueue(const MarketUpdateQueue&) = delete;
+    MarketUpdateQueue& operator=(const MarketUpdateQueue&) = delete;
+
+    /// @brief 关注 / 取消关注某只证券（任意线程）
+    void watch(InstrumentId id);
+    void unwatch(InstrumentId id);
+    void unwatch_all();
+    bool watching(InstrumentId id) const;
+
+    /// @brief 发布一次更新（仅行情回调线程调用）；未关注或已在队列中时直接返回
+    void publish(InstrumentId id, uint64_t seq);
+
+    /// @brief 取出全部待处理通知（仅订阅者线程调用）
+    /// @return 取出的条数
+    size_t drain(std::vector<MarketUpdate>& out);
+
+    /// @brief 等待直到有通知或到达截止时间（仅订阅者线程调用）
+    /// @return 有待处理通知时返回 true
+    bool wait_until(std::chrono::steady_clock::time_point deadline);
+
+    bool empty() const;
+
+private:
+    bool in_range(InstrumentId id) const {
+        return id >= 0 && static_cast<size_t>(id) < capacity_;
+    }
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<std::atomic<uint8_t>[]> watched_;
+    std::unique_ptr<std::atomic<uint8_t>[]> pending_;  ///< 已入队未取走
+    std::unique_ptr<MarketUpdate[]> ring_;
+    std::atomic<uint64_t> head_;  ///< 读端位置
+    std::atomic<uint64_t> tail_;  ///< 写端位置
+
+    std::atomic<bool> parked_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+};
@@ -1,7 +1,55 @@
 #pragma once
+#include "InstrumentRegistry.h"
+#include <atomic>
 #include <string>
 #include <cstdint>
 
+/// @brief 策略编号：写入订单标签，回报按此路由到模块（0 表示未标记）
+namespace StrategyIds {
+constexpr uint16_t kNone = 0;
+constexpr uint16_t kQh2hSell = 1;
+constexpr uint16_t kQh2hBaseCancel = 2;
+constexpr uint16_t kPreOpenSell = 3;     // 盘前卖出
+constexpr uint16_t kIntradaySell = 4;    // 盘中卖出
+constexpr uint16_t kCloseSell = 5;       // 收盘卖出
+constexpr uint16_t kMaxStrategies = 64;
+}
+
+/// @brief 订单标签：策略编号(8 位) | 证券 ID(24 位) | 序号(32 位)，0 表示无标签
+///
+/// 下单时写入 OrderRequest::tag，本地订单的委托/成交/撤单回报与查询结果原样带回；
+/// 策略按 order_tag_key（策略 + 证券）做整数匹配，不再拼接和比较备注字符串。
+using OrderTag = uint64_t;
+
+inline OrderTag make_order_tag(uint16_t strategy, InstrumentId instrument, uint32_t seq) {
+    return (static_cast<uint64_t>(strategy & 0xFFu) << 56) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(instrument) & 0xFFFFFFu) << 32) | seq;
+}
+
+/// @brief 生成带进程内递增序号的标签
+inline OrderTag next_order_tag(uint16_t strategy, InstrumentId instrument) {
+    static std::atomic<uint32_t> seq{0};
+    return make_order_tag(strategy, instrument, seq.fetch_add(1, std::memory_order_relaxed) + 1);
+}
+
+inline uint16_t order_tag_strategy(OrderTag tag) {
+    return static_cast<uint16_t>(tag >> 56);
+}
+
+inline InstrumentId order_tag_instrument(OrderTag tag) {
+    uint32_t id = static_cast<uint32_t>(tag >> 32) & 0xFFFFFFu;
+    return id == 0xFFFFFFu ? kInvalidInstrument : static_cast<InstrumentId>(id);
+}
+
+inline uint32_t order_tag_seq(OrderTag tag) {
+    return static_cast<uint32_t>(tag);
+}
+
+/// @brief 策略 + 证券（忽略序号），同一策略同一证券的订单键相同
+inline uint32_t order_tag_key(OrderTag tag) {
+    return static_cast<uint32_t>(tag >> 32);
+}
+
 /// @brief 委托请求结构体（对接交易 API 的输入）
 enum class OrderSide {
     Buy = 0,
@@ -11,12 +59,14 @@ enum class OrderSide {
 struct OrderRequest {
     std::string account_id;
     std::string symbol;     // e.g. "000001.SZ"
+    InstrumentId instrument = kInvalidInstrument; // 证券 ID；symbol 为空时由此解析
     OrderSide side = OrderSide::Sell;
     double price = 0.0;     // limit price; ignored if is_market==true
     int64_t volume = 0;     // >=0
     bool is_market = false;
     int order_type = -1;    // <0 uses default mapping (limit/market)
     std::string remark;     // 用于撤单与回溯跟踪
+    OrderTag tag = 0;       // 订单标签（策略/证券/序号，回报路由与撤单匹配用）
 };
 
 /// @brief 委托结果（下单后返回）
@@ -35,6 +85,7 @@ struct OrderResult {
     int order_type = -1;    // SDK order type
     int entrust_type = -1;  // SDK entrust type
     bool is_local = false;  // true=本进程下单；false=外部订单/无法关联本地ID
+    OrderTag tag = 0;       // 订单标签（仅本地订单）
     
     // 订单状态
     enum class Status {
@@ -47,3 +98,64 @@ struct OrderResult {
     };
     Status status = Status::UNKNOWN;
 };
+
+/// @brief 本地订单状态机
+///
+/// PENDING → ACCEPTED → PARTIAL → FILLED，任一非终态可进入 CANCEL_PENDING / CANCELLED / REJECTED；
+/// FILLED / CANCELLED / REJECTED 为终态，之后到达的推送一律丢弃。
+enum class OrderState : uint8_t {
+    PENDING = 0,        // 已发出，柜台未确认
+    ACCEPTED = 1,       // 柜台已确认
+    PARTIAL = 2,        // 部分成交
+    FILLED = 3,         // 全部成交
+    CANCEL_PENDING = 4, // 撤单已发出
+    CANCELLED = 5,      // 已撤单
+    REJECTED = 6        // 废单/拒单
+};
+
+inline bool is_terminal(OrderState state) {
+    return state == OrderState::FILLED || state == OrderState::CANCELLED || state == OrderState::REJECTED;
+}
+
+/// @brief 状态迁移是否合法（同状态迁移视为不合法，由调用方忽略）
+inline bool is_valid_transition(OrderState from, OrderState to) {
+    if (from == to || is_terminal(from)) {
+        return false;
+    }
+    switch (to) {
+        case OrderState::PENDING:
+            return false;
+        case OrderState::ACCEPTED:
+            return from == OrderState::PENDING;
+        case OrderState::PARTIAL:
+            return true;
+        case OrderState::FILLED:
+        case OrderState::CANCEL_PENDING:
+        case OrderState::CANCELLED:
+            return true;
+        case OrderState::REJECTED:
+            // 已有成交的订单不会整体废单（撤单被拒不改变委托状态）
+            return from == OrderState::PENDING || from == OrderState::ACCEPTED ||
+                   from == OrderState::CANCEL_PENDING;
+    }
+    return false;
+}
+
+/// @brief 状态机状态映射到对外的 OrderResult::Status
+inline OrderResult::Status to_result_status(OrderState state) {
+    switch (state) {
+        case OrderState::PENDING:
+        case OrderState::ACCEPTED:
+            return OrderResult::Status::SUBMITTED;
+        case OrderState::PARTIAL:
+            return OrderResult::Status::PARTIAL;
+        case OrderState::FILLED:
+            return OrderResult::Status::FILLED;
+        case OrderState::CANCEL_PENDING:
+        case OrderState::CANCELLED:
+            return OrderResult::Status::CANCELLED;
+        case OrderState::REJECTED:
+            return OrderResult::Status::REJECTED;
+    }
+    return OrderResult::Status::UNKNOWN;
+}
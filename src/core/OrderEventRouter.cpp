@@ -0,0 +1,92 @@
+#include "OrderEventRouter.h"
+
+#include <thread>
+
+namespace {
+// 队列空时先让出 CPU 若干次再休眠，回报密集时不必每条都唤醒
+constexpr int kSpinBeforeSleep = 64;
+constexpr int kSleepTimeoutMs = 200;
+}  // namespace
+
+OrderEventRouter::OrderEventRouter(size_t capacity)
+    : ring_(capacity), handlers_(StrategyIds::kMaxStrategies) {}
+
+void OrderEventRouter::subscribe(uint16_t strategy_id, Handler handler) {
+    if (strategy_id == StrategyIds::kNone || strategy_id >= handlers_.size()) {
+        return;
+    }
+    handlers_[strategy_id] = std::move(handler);
+}
+
+void OrderEventRouter::subscribe_external(Handler handler) {
+    external_ = std::move(handler);
+}
+
+void OrderEventRouter::publish(const OrderResult& result, int notify_type) {
+    Event ev;
+    ev.result = result;
+    ev.type = notify_type;
+    ev.published = std::chrono::steady_clock::now();
+    if (!ring_.try_push(std::move(ev))) {
+        full_waits_.fetch_add(1, std::memory_order_relaxed);
+        while (!ring_.try_push(std::move(ev))) {
+            std::this_thread::yield();
+        }
+    }
+    // 与 run 中的栅栏配对：要么分发线程看到新回报，要么这里看到它在休眠
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load()) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+}
+
+void OrderEventRouter::run(const std::atomic<bool>& stop) {
+    Event ev;
+    int idle = 0;
+    while (true) {
+        if (ring_.try_pop(ev)) {
+            idle = 0;
+            dispatch(ev);
+            continue;
+        }
+        if (stop.load()) {
+            break;
+        }
+        if (++idle < kSpinBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        sleeping_.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring_.empty()) {
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(kSleepTimeoutMs));
+        }
+        sleeping_.store(false);
+        idle = 0;
+    }
+}
+
+void OrderEventRouter::dispatch(const Event& ev) {
+    uint64_t wait_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - ev.published).count());
+    ++stats_.count;
+    stats_.total_us += wait_us;
+    if (wait_us > stats_.max_us) {
+        stats_.max_us = wait_us;
+    }
+
+    uint16_t id = order_tag_strategy(ev.result.tag);
+    if (id != StrategyIds::kNone && id < handlers_.size() && handlers_[id]) {
+        handlers_[id](ev.result, ev.type);
+    } else if (!ev.result.is_local && external_) {
+        external_(ev.result, ev.type);
+    }
+}
+
+OrderEventRouter::Stats OrderEventRouter::stats() const {
+    Stats stats = stats_;
+    stats.full_waits = full_waits_.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "MpscRing.h"
+#include "Order.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/// @brief 委托回报分发器：交易回调线程无锁写入有界环形队列，分发线程按策略编号路由到模块
+///
+/// - 模块用下单时写入订单标签的策略编号注册处理函数；
+/// - 外部订单（非本进程下单）交给 subscribe_external 注册的处理函数；
+/// - 队列满时回调线程让出 CPU 重试，不丢回报。
+class OrderEventRouter {
+public:
+    using Handler = std::function<void(const OrderResult&, int)>;
+
+    /// @brief 分发时延统计（publish → 处理函数开始执行）
+    struct Stats {
+        uint64_t count = 0;
+        uint64_t total_us = 0;
+        uint64_t max_us = 0;
+        uint64_t full_waits = 0;    // publish 遇到队列满的次数
+    };
+
+    explicit OrderEventRouter(size_t capacity = 4096);
+
+    OrderEventRouter(const OrderEventRouter&) = delete;
+    OrderEventRouter& operator=(const OrderEventRouter&) = delete;
+
+    /// @brief 注册策略的回报处理函数（须在 run 之前调用）
+    void subscribe(uint16_t strategy_id, Handler handler);
+
+    /// @brief 注册外部订单的回报处理函数（须在 run 之前调用）
+    void subscribe_external(Handler handler);
+
+    /// @brief 写入一条回报（任意线程）
+    void publish(const OrderResult& result, int notify_type);
+
+    /// @brief 分发循环；stop 置位后处理完队列中剩余回报再返回
+    void run(const std::atomic<bool>& stop);
+
+    /// @brief 分发时延统计快照（run 返回后调用）
+    Stats stats() const;
+
+private:
+    struct Event {
+        OrderResult result;
+        int type = 0;
+        std::chrono::steady_clock::time_point published;
+    };
+
+    void dispatch(const Event& ev);
+
+    MpscRing<Event> ring_;
+    std::vector<Handler> handlers_;
+    Handler external_;
+
+    std::atomic<bool> sleeping_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    Stats stats_;
+    std::atomic<uint64_t> full_waits_{0};
+};
@@ -0,0 +1,206 @@
+#include "OrderStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+void remove_index(std::vector<uint32_t>& list, uint32_t idx) {
+    auto it = std::find(list.begin(), list.end(), idx);
+    if (it != list.end()) {
+        list.erase(it);
+    }
+}
+
+void reset_record(OrderRecord& rec) {
+    rec.order_id[0] = '\0';
+    rec.instrument = kInvalidInstrument;
+    rec.sys_id = 0;
+    rec.kfsbdbh = 0;
+    rec.batch_no = 0;
+    rec.volume = 0;
+    rec.price = 0.0;
+    rec.filled_volume = 0;
+    rec.filled_price = 0.0;
+    rec.last_fill_price = 0.0;
+    rec.state.store(OrderState::PENDING, std::memory_order_relaxed);
+    rec.version = 0;
+    rec.side = -1;
+    rec.order_type = -1;
+    rec.entrust_type = -1;
+    rec.remark[0] = '\0';
+    rec.tag = 0;
+    rec.live = false;
+    rec.live_pos = 0;
+    rec.slot = 0;
+}
+
+void copy_field(char* dst, size_t size, const std::string& src) {
+    size_t n = std::min(size - 1, src.size());
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+}  // namespace
+
+OrderRecord& OrderStore::create(const std::string& order_id, InstrumentId instrument, OrderTag tag,
+                                const std::string& remark) {
+    uint32_t idx;
+    if (!free_.empty()) {
+        idx = free_.back();
+        free_.pop_back();
+    } else {
+        idx = next_++;
+        if ((idx >> kChunkShift) >= chunks_.size()) {
+            chunks_.emplace_back(new OrderRecord[kChunkSize]);
+        }
+    }
+
+    OrderRecord& rec = at(idx);
+    reset_record(rec);
+    rec.slot = idx;
+    rec.instrument = instrument;
+    rec.tag = tag;
+    copy_field(rec.order_id, sizeof(rec.order_id), order_id);
+    copy_field(rec.remark, sizeof(rec.remark), remark);
+
+    by_local_[order_id] = idx;
+    if (tag != 0) {
+        by_tag_[order_tag_key(tag)].push_back(idx);
+    }
+    if (instrument != kInvalidInstrument) {
+        std::vector<uint32_t>& live = live_[instrument];
+        rec.live = true;
+        rec.live_pos = static_cast<uint32_t>(live.size());
+        live.push_back(idx);
+    }
+    return rec;
+}
+
+void OrderStore::erase(const std::string& order_id) {
+    auto it = by_local_.find(order_id);
+    if (it == by_local_.end()) {
+        return;
+    }
+    uint32_t idx = it->second;
+    OrderRecord& rec = at(idx);
+
+    retire(rec);
+    if (rec.sys_id != 0) {
+        by_sys_id_.erase(rec.sys_id);
+    }
+    if (rec.kfsbdbh != 0) {
+        by_kfsbdbh_.erase(rec.kfsbdbh);
+    }
+    if (rec.batch_no != 0) {
+        auto b = by_batch_.find(rec.batch_no);
+        if (b != by_batch_.end()) {
+            remove_index(b->second, idx);
+            if (b->second.empty()) {
+                by_batch_.erase(b);
+            }
+        }
+    }
+    if (rec.tag != 0) {
+        auto t = by_tag_.find(order_tag_key(rec.tag));
+        if (t != by_tag_.end()) {
+            remove_index(t->second, idx);
+            if (t->second.empty()) {
+                by_tag_.erase(t);
+            }
+        }
+    }
+    by_local_.erase(it);
+    reset_record(rec);
+    free_.push_back(idx);
+}
+
+OrderRecord* OrderStore::find(const std::string& order_id) {
+    auto it = by_local_.find(order_id);
+    return it != by_local_.end() ? &at(it->second) : nullptr;
+}
+
+OrderRecord* OrderStore::find_by_sys_id(int64_t sys_id) {
+    auto it = by_sys_id_.find(sys_id);
+    return it != by_sys_id_.end() ? &at(it->second) : nullptr;
+}
+
+OrderRecord* OrderStore::find_by_kfsbdbh(int64_t kfsbdbh) {
+    auto it = by_kfsbdbh_.find(kfsbdbh);
+    return it != by_kfsbdbh_.end() ? &at(it->second) : nullptr;
+}
+
+void OrderStore::bind_sys_id(OrderRecord& rec, int64_t sys_id) {
+    if (sys_id == 0 || rec.sys_id == sys_id) {
+        return;
+    }
+    if (rec.sys_id != 0) {
+        by_sys_id_.erase(rec.sys_id);
+    }
+    rec.sys_id = sys_id;
+    by_sys_id_[sys_id] = rec.slot;
+}
+
+void OrderStore::bind_kfsbdbh(OrderRecord& rec, int64_t kfsbdbh) {
+    if (kfsbdbh == 0 || rec.kfsbdbh == kfsbdbh) {
+        return;
+    }
+    if (rec.kfsbdbh != 0) {
+        by_kfsbdbh_.erase(rec.kfsbdbh);
+    }
+    rec.kfsbdbh = kfsbdbh;
+    by_kfsbdbh_[kfsbdbh] = rec.slot;
+}
+
+void OrderStore::bind_batch(OrderRecord& rec, int64_t batch_no) {
+    if (batch_no == 0 || rec.batch_no != 0) {
+        return;
+    }
+    rec.batch_no = batch_no;
+    by_batch_[batch_no].push_back(rec.slot);
+}
+
+void OrderStore::retire(OrderRecord& rec) {
+    if (!rec.live) {
+        return;
+    }
+    std::vector<uint32_t>* live = live_.find(rec.instrument);
+    if (live && rec.live_pos < live->size()) {
+        // 与末尾交换后弹出，O(1)
+        uint32_t last = live->back();
+        (*live)[rec.live_pos] = last;
+        at(last).live_pos = rec.live_pos;
+        live->pop_back();
+    }
+    rec.live = false;
+}
+
+void OrderStore::live_orders(InstrumentId instrument, std::vector<const OrderRecord*>& out) const {
+    const std::vector<uint32_t>* live = live_.find(instrument);
+    if (!live) {
+        return;
+    }
+    for (uint32_t idx : *live) {
+        out.push_back(&at(idx));
+    }
+}
+
+void OrderStore::find_by_tag(uint32_t tag_key, std::vector<const OrderRecord*>& out) const {
+    auto it = by_tag_.find(tag_key);
+    if (it == by_tag_.end()) {
+        return;
+    }
+    for (uint32_t idx : it->second) {
+        out.push_back(&at(idx));
+    }
+}
+
+void OrderStore::find_by_batch(int64_t batch_no, std::vector<OrderRecord*>& out) {
+    auto it = by_batch_.find(batch_no);
+    if (it == by_batch_.end()) {
+        return;
+    }
+    for (uint32_t idx : it->second) {
+        out.push_back(&at(idx));
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "InstrumentRegistry.h"
+#include "Order.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief 本地订单记录（定长，存放在 OrderStore 的分块数组中）
+struct OrderRecord {
+    char order_id[24] = {};          // 本地订单 ID
+    InstrumentId instrument = kInvalidInstrument;
+    int64_t sys_id = 0;              // 柜台委托号，0 表示尚未确认
+    int64_t kfsbdbh = 0;             // 开发商本地编号（异步下单），0 表示同步下单
+    int64_t batch_no = 0;            // 委托批次号（批量下单），0 表示单笔下单
+    int64_t volume = 0;
+    double price = 0.0;
+    int64_t filled_volume = 0;
+    double filled_price = 0.0;
+    double last_fill_price = 0.0;
+    std::atomic<OrderState> state{OrderState::PENDING}; // 状态（持有记录指针时可无锁读取）
+    uint64_t version = 0;            // 已生效的状态/成交更新次数，单调递增
+    int side = -1;                   // 0=Buy, 1=Sell
+    int order_type = -1;
+    int entrust_type = -1;
+    char remark[128] = {};           // 备注（策略标签）
+    OrderTag tag = 0;                // 订单标签
+    bool live = false;               // 是否在所属证券的活动订单列表中
+    uint32_t live_pos = 0;           // 在活动订单列表中的下标
+    uint32_t slot = 0;               // 在 OrderStore 中的槽位
+
+    /// @brief 按状态机迁移状态；非法迁移（含终态之后的迟到推送）返回 false 且不修改
+    bool transition(OrderState to) {
+        OrderState from = state.load(std::memory_order_relaxed);
+        if (!is_valid_transition(from, to)) {
+            return false;
+        }
+        state.store(to, std::memory_order_release);
+        ++version;
+        return true;
+    }
+
+    /// @brief 应用累计成交量；只接受比当前更大的累计值，重复或乱序的成交推送被丢弃
+    ///
+    /// 成交是既成事实：终态之后（如撤单推送先于成交推送到达）的更大累计值同样接受，
+    /// 状态不变，由调用方按迟到成交记账（PositionLedger::on_late_fill）。
+    bool apply_fill(int64_t total_qty, double total_amt, double match_price) {
+        if (total_qty <= filled_volume) {
+            return false;
+        }
+        filled_volume = total_qty;
+        filled_price = total_qty > 0 ? total_amt / total_qty : 0.0;
+        last_fill_price = match_price;
+        ++version;
+        return true;
+    }
+
+    /// @brief 证券代码（如 600000.SH）
+    const std::string& symbol() const {
+        return InstrumentRegistry::instance().symbol(instrument);
+    }
+};
+
+/// @brief 本地订单簿：定长记录分块存放，按本地 ID / 委托号 / 开发商本地编号 / 批次 / 标签哈希索引，
+/// 并按证券维护活动订单列表
+///
+/// - 记录地址在 erase 之前保持不变，可在持锁期间直接修改；
+/// - 本类不加锁，由调用方（SecTradingApi::orders_mutex_）保证互斥。
+class OrderStore {
+public:
+    OrderStore() = default;
+    OrderStore(const OrderStore&) = delete;
+    OrderStore& operator=(const OrderStore&) = delete;
+
+    /// @brief 新建订单记录并登记本地 ID、标签索引，加入所属证券的活动列表
+    OrderRecord& create(const std::string& order_id, InstrumentId instrument, OrderTag tag,
+                        const std::string& remark);
+
+    /// @brief 删除订单（仅用于下单失败回滚）
+    void erase(const std::string& order_id);
+
+    OrderRecord* find(const std::string& order_id);
+    OrderRecord* find_by_sys_id(int64_t sys_id);
+    OrderRecord* find_by_kfsbdbh(int64_t kfsbdbh);
+
+    /// @brief 登记柜台委托号 / 开发商本地编号 / 批次号
+    void bind_sys_id(OrderRecord& rec, int64_t sys_id);
+    void bind_kfsbdbh(OrderRecord& rec, int64_t kfsbdbh);
+    void bind_batch(OrderRecord& rec, int64_t batch_no);
+
+    /// @brief 订单进入终态后移出活动列表（可重复调用）
+    void retire(OrderRecord& rec);
+
+    /// @brief 某证券当前的活动订单
+    void live_orders(InstrumentId instrument, std::vector<const OrderRecord*>& out) const;
+
+    /// @brief 按标签键（策略 + 证券，见 order_tag_key）查找订单
+    void find_by_tag(uint32_t tag_key, std::vector<const OrderRecord*>& out) const;
+
+    /// @brief 按批次号查找订单
+    void find_by_batch(int64_t batch_no, std::vector<OrderRecord*>& out);
+
+    size_t size() const { return by_local_.size(); }
+
+private:
+    static const uint32_t kChunkShift = 10;
+    static const uint32_t kChunkSize = 1u << kChunkShift;
+
+    OrderRecord& at(uint32_t idx) { return chunks_[idx >> kChunkShift][idx & (kChunkSize - 1)]; }
+    const OrderRecord& at(uint32_t idx) const { return chunks_[idx >> kChunkShift][idx & (kChunkSize - 1)]; }
+
+    std::vector<std::unique_ptr<OrderRecord[]>> chunks_;
+    uint32_t next_ = 0;                     // 下一个未使用的槽位
+    std::vector<uint32_t> free_;            // 已回收的槽位
+
+    std::unordered_map<std::string, uint32_t> by_local_;
+    std::unordered_map<int64_t, uint32_t> by_sys_id_;
+    std::unordered_map<int64_t, uint32_t> by_kfsbdbh_;
+    std::unordered_map<int64_t, std::vector<uint32_t>> by_batch_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> by_tag_;
+    InstrumentMap<std::vector<uint32_t>> live_;
+};
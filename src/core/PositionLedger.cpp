@@ -0,0 +1,189 @@
+#include "PositionLedger.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+void describe_drift(const std::string& symbol, const Position& local, const Position& counter,
+                    std::vector<std::string>* drift) {
+    if (!drift) {
+        return;
+    }
+    std::ostringstream oss;
+    oss << symbol << " local(total=" << local.total << ", available=" << local.available
+        << ", frozen=" << local.frozen << ") counter(total=" << counter.total
+        << ", available=" << counter.available << ", frozen=" << counter.frozen << ")";
+    drift->push_back(oss.str());
+}
+
+}  // namespace
+
+void PositionLedger::seed(const std::vector<Position>& positions) {
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    std::lock_guard<std::mutex> lock(mutex_);
+    positions_.clear();
+    for (const auto& pos : positions) {
+        InstrumentId id = registry.intern(pos.symbol);
+        if (id != kInvalidInstrument) {
+            positions_[id] = pos;
+        }
+    }
+    seeded_ = true;
+}
+
+bool PositionLedger::seeded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return seeded_;
+}
+
+std::vector<Position> PositionLedger::snapshot() const {
+    std::vector<Position> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(positions_.size());
+    positions_.for_each([&](InstrumentId, const Position& pos) {
+        result.push_back(pos);
+    });
+    return result;
+}
+
+bool PositionLedger::get(InstrumentId id, Position& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Position* pos = positions_.find(id);
+    if (!pos) {
+        return false;
+    }
+    out = *pos;
+    return true;
+}
+
+void PositionLedger::on_order(InstrumentId id, int side, int64_t volume) {
+    if (side != 1 || volume <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Position* pos = positions_.find(id);
+    if (!pos) {
+        return;
+    }
+    int64_t qty = std::min(volume, pos->available);
+    pos->available -= qty;
+    pos->frozen += qty;
+    touch(id);
+}
+
+void PositionLedger::on_fill(InstrumentId id, int side, int64_t qty) {
+    if (qty <= 0 || id == kInvalidInstrument) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (side == 0) {
+        Position& pos = positions_[id];
+        if (pos.symbol.empty()) {
+            pos.symbol = InstrumentRegistry::instance().symbol(id);
+        }
+        pos.total += qty;
+        touch(id);
+        return;
+    }
+    Position* pos = positions_.find(id);
+    if (!pos) {
+        return;
+    }
+    int64_t from_frozen = std::min(qty, pos->frozen);
+    pos->frozen -= from_frozen;
+    pos->available = std::max<int64_t>(0, pos->available - (qty - from_frozen));
+    pos->total = std::max<int64_t>(0, pos->total - qty);
+    touch(id);
+}
+
+void PositionLedger::on_late_fill(InstrumentId id, int side, int64_t qty) {
+    if (side != 1) {
+        on_fill(id, side, qty);
+        return;
+    }
+    if (qty <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Position* pos = positions_.find(id);
+    if (!pos) {
+        return;
+    }
+    pos->available = std::max<int64_t>(0, pos->available - qty);
+    pos->total = std::max<int64_t>(0, pos->total - qty);
+    touch(id);
+}
+
+void PositionLedger::on_release(InstrumentId id, int side, int64_t qty) {
+    if (side != 1 || qty <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Position* pos = positions_.find(id);
+    if (!pos) {
+        return;
+    }
+    int64_t released = std::min(qty, pos->frozen);
+    pos->frozen -= released;
+    pos->available += released;
+    touch(id);
+}
+
+uint64_t PositionLedger::version() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
+
+bool PositionLedger::changed_since(InstrumentId id, uint64_t since) const {
+    const uint64_t* changed = changed_.find(id);
+    return changed && *changed > since;
+}
+
+size_t PositionLedger::reconcile(const std::vector<Position>& counter, uint64_t since,
+                                 std::vector<std::string>* drift) {
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    InstrumentMap<Position> fresh;
+    for (const auto& pos : counter) {
+        InstrumentId id = registry.intern(pos.symbol);
+        if (id != kInvalidInstrument) {
+            fresh[id] = pos;
+        }
+    }
+
+    size_t drifted = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    InstrumentMap<Position> merged;
+    fresh.for_each([&](InstrumentId id, const Position& pos) {
+        const Position* local = positions_.find(id);
+        if (changed_since(id, since)) {
+            if (local) {
+                merged[id] = *local;  // 查询期间有推送：柜台结果已过时，保留本地
+            }
+            return;
+        }
+        merged[id] = pos;
+        Position empty;
+        empty.symbol = pos.symbol;
+        const Position& cmp = local ? *local : empty;
+        if (cmp.total != pos.total || cmp.available != pos.available || cmp.frozen != pos.frozen) {
+            ++drifted;
+            describe_drift(pos.symbol, cmp, pos, drift);
+        }
+    });
+    positions_.for_each([&](InstrumentId id, const Position& pos) {
+        if (fresh.contains(id)) {
+            return;
+        }
+        if (changed_since(id, since)) {
+            merged[id] = pos;
+        } else if (pos.total != 0 || pos.available != 0 || pos.frozen != 0) {
+            ++drifted;
+            Position empty;
+            describe_drift(pos.symbol, pos, empty, drift);
+        }
+    });
+    positions_ = std::move(merged);
+    seeded_ = true;
+    return drifted;
+}
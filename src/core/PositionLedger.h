@@ -0,0 +1,62 @@
+#pragma once
+#include "InstrumentRegistry.h"
+#include "MarketData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief 本地持仓台账：启动时用一次柜台持仓查询建账，之后由委托/成交/撤单推送增量维护
+///
+/// - 卖出委托：可用 → 冻结；卖出成交：冻结与总量减少；撤单/废单：剩余冻结退回可用；
+/// - 买入成交只增加总量（T+1，可用不变）；
+/// - 定期用柜台查询结果对账（reconcile），以柜台为准覆盖并报告偏差。
+class PositionLedger {
+public:
+    /// @brief 建账（覆盖现有台账）
+    void seed(const std::vector<Position>& positions);
+
+    /// @brief 是否已建账
+    bool seeded() const;
+
+    /// @brief 全部持仓快照
+    std::vector<Position> snapshot() const;
+
+    /// @brief 单只证券持仓；无记录时返回 false
+    bool get(InstrumentId id, Position& out) const;
+
+    /// @brief 新委托（side: 0=买, 1=卖）；卖出时冻结可用
+    void on_order(InstrumentId id, int side, int64_t volume);
+
+    /// @brief 成交增量
+    void on_fill(InstrumentId id, int side, int64_t qty);
+
+    /// @brief 终态订单的迟到成交：冻结已在撤单/废单时退回，卖出成交从可用与总量中扣除
+    void on_late_fill(InstrumentId id, int side, int64_t qty);
+
+    /// @brief 撤单/废单释放未成交部分
+    void on_release(InstrumentId id, int side, int64_t qty);
+
+    /// @brief 台账版本：每次增量更新递增，查询柜台持仓前记录，对账时传入
+    uint64_t version() const;
+
+    /// @brief 与柜台持仓对账并以柜台为准覆盖
+    ///
+    /// 查询期间有推送到达的证券（版本晚于 since）柜台结果已过时，保留本地台账、不计偏差。
+    /// @param since 查询柜台持仓前的 version()
+    /// @param drift 输出偏差描述（可为 nullptr）
+    /// @return 存在偏差的证券数
+    size_t reconcile(const std::vector<Position>& counter, uint64_t since, std::vector<std::string>* drift);
+
+private:
+    void touch(InstrumentId id) { changed_[id] = ++version_; }   // 需持有 mutex_
+    bool changed_since(InstrumentId id, uint64_t since) const;  // 需持有 mutex_
+
+    mutable std::mutex mutex_;
+    InstrumentMap<Position> positions_;
+    InstrumentMap<uint64_t> changed_;   // 各证券最近一次增量更新时的版本
+    uint64_t version_ = 0;
+    bool seeded_ = false;
+};
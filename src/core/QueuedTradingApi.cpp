@@ -1,7 +1,18 @@
 #include "QueuedTradingApi.h"
+#include "InstrumentRegistry.h"
 
 #include <utility>
 
+thread_local bool QueuedTradingApi::urgent_ = false;
+
+QueuedTradingApi::UrgentScope::UrgentScope() : prev_(urgent_) {
+    urgent_ = true;
+}
+
+QueuedTradingApi::UrgentScope::~UrgentScope() {
+    urgent_ = prev_;
+}
+
 QueuedTradingApi::QueuedTradingApi(std::shared_ptr<ITradingApi> inner)
     : inner_(std::move(inner)) {
     worker_ = std::thread([this]() { worker_loop(); });
@@ -13,33 +24,200 @@ QueuedTradingApi::~QueuedTradingApi() {
 
 bool QueuedTradingApi::connect(const std::string& host, int port,
                               const std::string& user, const std::string& password) {
-    return submit([this, host, port, user, password]() {
+    return submit(Lane::ORDER, [this, host, port, user, password]() {
         return inner_->connect(host, port, user, password);
     }).get();
 }
 
 void QueuedTradingApi::disconnect() {
-    submit([this]() { inner_->disconnect(); }).get();
+    submit(Lane::ORDER, [this]() { inner_->disconnect(); }).get();
 }
 
 bool QueuedTradingApi::is_connected() const {
-    return submit([this]() { return inner_->is_connected(); }).get();
+    return submit(Lane::ORDER, [this]() { return inner_->is_connected(); }).get();
+}
+
+template <typename T, typename Query>
+std::shared_future<T> QueuedTradingApi::share_query(Flight<T>& flight, Query query) {
+    std::lock_guard<std::mutex> lock(flight_mutex_);
+    // A query started before the last invalidation may not see the new order;
+    // only a query started under the current generation can be shared.
+    if (flight.result.valid() && flight.started == flight.generation) {
+        bool ready = flight.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        if (!ready ||
+            (flight.completed &&
+             std::chrono::steady_clock::now() - flight.completed_at <= query_freshness_)) {
+            ++coalesced_;
+            return flight.result;
+        }
+    }
+
+    uint64_t generation = ++flight.generation;
+    flight.started = generation;
+    flight.completed = false;
+    flight.result = submit(Lane::QUERY, [this, &flight, generation, query]() {
+        T result = query();
+        std::lock_guard<std::mutex> lock(flight_mutex_);
+        if (flight.generation == generation) {
+            flight.completed = true;
+            flight.completed_at = std::chrono::steady_clock::now();
+        }
+        return result;
+    }).share();
+    return flight.result;
+}
+
+void QueuedTradingApi::invalidate_orders_query() {
+    // A query already running may finish before the order reaches the counter;
+    // bumping the generation keeps it from being marked fresh.
+    std::lock_guard<std::mutex> lock(flight_mutex_);
+    ++orders_flight_.generation;
+    orders_flight_.completed = false;
+}
+
+void QueuedTradingApi::set_query_freshness(std::chrono::milliseconds window) {
+    std::lock_guard<std::mutex> lock(flight_mutex_);
+    query_freshness_ = window;
+}
+
+uint64_t QueuedTradingApi::coalesced_queries() const {
+    std::lock_guard<std::mutex> lock(flight_mutex_);
+    return coalesced_;
+}
+
+void QueuedTradingApi::set_rate_limiter(std::shared_ptr<RateLimiter> limiter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limiter_ = std::move(limiter);
+}
+
+std::vector<RateLimiter::Ticket> QueuedTradingApi::tickets_for(const std::vector<OrderRequest>& reqs) {
+    std::vector<RateLimiter::Ticket> tickets;
+    for (const auto& req : reqs) {
+        const std::string& symbol = req.symbol.empty()
+            ? InstrumentRegistry::instance().symbol(req.instrument) : req.symbol;
+        std::string exchange = RateLimiter::exchange_of(symbol);
+        bool merged = false;
+        for (auto& ticket : tickets) {
+            if (ticket.account == req.account_id && ticket.exchange == exchange) {
+                ++ticket.count;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            RateLimiter::Ticket ticket;
+            ticket.account = req.account_id;
+            ticket.exchange = exchange;
+            tickets.push_back(ticket);
+        }
+    }
+    return tickets;
+}
+
+std::vector<RateLimiter::Ticket> QueuedTradingApi::cancel_tickets(const std::vector<std::string>& order_ids) {
+    std::vector<OrderRequest> routes;
+    routes.reserve(order_ids.size());
+    for (const auto& order_id : order_ids) {
+        OrderRequest route;
+        if (inner_->order_route(order_id, route.account_id, route.symbol)) {
+            routes.push_back(route);
+        }
+    }
+    std::vector<RateLimiter::Ticket> tickets = tickets_for(routes);
+    for (auto& ticket : tickets) {
+        ticket.cancel = true;
+    }
+    return tickets;
 }
 
 std::string QueuedTradingApi::place_order(const OrderRequest& req) {
-    return submit([this, req]() { return inner_->place_order(req); }).get();
+    return place_order_async(req).get();
+}
+
+std::future<std::string> QueuedTradingApi::place_order_async(const OrderRequest& req) {
+    invalidate_orders_query();
+    return submit(Lane::ORDER, tickets_for(std::vector<OrderRequest>(1, req)),
+                  [this, req]() { return inner_->place_order(req); });
+}
+
+std::vector<std::string> QueuedTradingApi::place_orders(const std::vector<OrderRequest>& reqs) {
+    invalidate_orders_query();
+    return submit(Lane::ORDER, tickets_for(reqs),
+                  [this, reqs]() { return inner_->place_orders(reqs); }).get();
 }
 
 bool QueuedTradingApi::cancel_order(const std::string& order_id) {
-    return submit([this, order_id]() { return inner_->cancel_order(order_id); }).get();
+    return cancel_order_async(order_id).get();
+}
+
+std::future<bool> QueuedTradingApi::cancel_order_async(const std::string& order_id) {
+    invalidate_orders_query();
+    return submit(Lane::CANCEL, cancel_tickets(std::vector<std::string>(1, order_id)),
+                  [this, order_id]() { return inner_->cancel_order(order_id); });
+}
+
+std::vector<bool> QueuedTradingApi::cancel_orders(const std::vector<std::string>& order_ids) {
+    invalidate_orders_query();
+    return submit(Lane::CANCEL, cancel_tickets(order_ids),
+                  [this, order_ids]() { return inner_->cancel_orders(order_ids); }).get();
 }
 
 std::vector<Position> QueuedTradingApi::query_positions() {
-    return submit([this]() { return inner_->query_positions(); }).get();
+    // Served from the inner ledger without occupying the worker when available.
+    std::vector<Position> local;
+    if (inner_->query_positions_local(local)) {
+        return local;
+    }
+    return share_query(positions_flight_, [this]() { return inner_->query_positions(); }).get();
+}
+
+std::future<std::vector<Position>> QueuedTradingApi::query_positions_async() {
+    std::vector<Position> local;
+    if (inner_->query_positions_local(local)) {
+        return ready_future(std::move(local));
+    }
+    std::shared_future<std::vector<Position>> shared =
+        share_query(positions_flight_, [this]() { return inner_->query_positions(); });
+    return std::async(std::launch::deferred, [shared]() { return shared.get(); });
+}
+
+bool QueuedTradingApi::query_positions_local(std::vector<Position>& out) {
+    return inner_->query_positions_local(out);
+}
+
+size_t QueuedTradingApi::reconcile_positions() {
+    return submit(Lane::QUERY, [this]() { return inner_->reconcile_positions(); }).get();
 }
 
 std::vector<OrderResult> QueuedTradingApi::query_orders() {
-    return submit([this]() { return inner_->query_orders(); }).get();
+    return share_query(orders_flight_, [this]() { return inner_->query_orders(); }).get();
+}
+
+std::vector<OrderResult> QueuedTradingApi::query_orders(const std::string& symbol) {
+    return submit(Lane::QUERY, [this, symbol]() { return inner_->query_orders(symbol); }).get();
+}
+
+OrderResult QueuedTradingApi::query_order(const std::string& order_id) {
+    return submit(Lane::QUERY, [this, order_id]() { return inner_->query_order(order_id); }).get();
+}
+
+// Local order-book reads bypass the worker, like query_positions_local().
+bool QueuedTradingApi::query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) {
+    return inner_->query_live_orders_local(instrument, out);
+}
+
+bool QueuedTradingApi::query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) {
+    return inner_->query_orders_by_tag_local(tag_key, out);
+}
+
+bool QueuedTradingApi::order_route(const std::string& order_id, std::string& account, std::string& symbol) {
+    return inner_->order_route(order_id, account, symbol);
+}
+
+std::future<std::vector<OrderResult>> QueuedTradingApi::query_orders_async() {
+    std::shared_future<std::vector<OrderResult>> shared =
+        share_query(orders_flight_, [this]() { return inner_->query_orders(); });
+    return std::async(std::launch::deferred, [shared]() { return shared.get(); });
 }
 
 void QueuedTradingApi::shutdown() {
@@ -58,19 +236,94 @@ void QueuedTradingApi::shutdown() {
     }
 }
 
+QueuedTradingApi::LaneStats QueuedTradingApi::lane_stats(Lane lane) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_[static_cast<int>(lane)];
+}
+
+bool QueuedTradingApi::has_tasks() const {
+    for (int i = 0; i < kLaneCount; ++i) {
+        if (!lanes_[i].empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int QueuedTradingApi::pick_lane() {
+    // A lower lane passed over too many times is served first.
+    for (int i = kLaneCount - 1; i > 0; --i) {
+        if (!lanes_[i].empty() && skipped_[i] >= kStarvationLimit) {
+            skipped_[i] = 0;
+            return i;
+        }
+    }
+    int picked = -1;
+    for (int i = 0; i < kLaneCount; ++i) {
+        if (lanes_[i].empty()) {
+            continue;
+        }
+        if (picked < 0) {
+            picked = i;
+            skipped_[i] = 0;
+        } else {
+            ++skipped_[i];
+        }
+    }
+    return picked;
+}
+
+std::chrono::microseconds QueuedTradingApi::throttle(const Task& task) {
+    if (!limiter_ || task.tickets.empty()) {
+        return std::chrono::microseconds(0);
+    }
+    if (task.urgent) {
+        limiter_->charge(task.tickets);
+        return std::chrono::microseconds(0);
+    }
+    return limiter_->try_acquire(task.tickets);
+}
+
 void QueuedTradingApi::worker_loop() {
     while (true) {
-        std::function<void()> task;
+        Task task;
         {
             std::unique_lock<std::mutex> lock(mutex_);
-            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
-            if (stopping_ && tasks_.empty()) {
+            cv_.wait(lock, [this]() { return stopping_ || has_tasks(); });
+            if (stopping_ && !has_tasks()) {
                 break;
             }
-            task = std::move(tasks_.front());
-            tasks_.pop_front();
+            int lane = pick_lane();
+            std::chrono::microseconds wait = throttle(lanes_[lane].front());
+            if (wait.count() > 0) {
+                // Serve a task the limiter does not hold back while the order waits.
+                int other = -1;
+                for (int i = 0; i < kLaneCount; ++i) {
+                    if (i != lane && !lanes_[i].empty() &&
+                        (lanes_[i].front().tickets.empty() || lanes_[i].front().urgent)) {
+                        other = i;
+                        break;
+                    }
+                }
+                if (other < 0) {
+                    cv_.wait_for(lock, wait);
+                    continue;
+                }
+                lane = other;
+                throttle(lanes_[lane].front());  // only charges (urgent) or no-op
+            }
+            task = std::move(lanes_[lane].front());
+            lanes_[lane].pop_front();
+
+            uint64_t wait_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - task.enqueued).count());
+            LaneStats& stats = stats_[lane];
+            ++stats.count;
+            stats.total_wait_us += wait_us;
+            if (wait_us > stats.max_wait_us) {
+                stats.max_wait_us = wait_us;
+            }
         }
-        task();
+        task.run();
     }
 }
-
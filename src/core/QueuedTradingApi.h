@@ -1,8 +1,11 @@
 #pragma once
 
 #include "ITradingApi.h"
+#include "RateLimiter.h"
 
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <future>
@@ -14,9 +17,47 @@
 /// @brief Single-threaded wrapper for any ITradingApi implementation.
 ///
 /// All trading calls are executed on one worker thread to avoid SDK
-/// thread-safety issues when modules run concurrently.
+/// thread-safety issues when modules run concurrently. Calls are queued in
+/// three priority lanes (cancel > order > query); a lower lane that has been
+/// passed over kStarvationLimit times in a row is served next regardless.
+///
+/// query_positions()/query_orders() are single-flight: while a query of the
+/// same kind is queued or running, or has completed within the freshness
+/// window, later callers share its result instead of queueing another one.
+///
+/// With a RateLimiter attached, order entry and cancels are dispatched only
+/// when the limiter grants them; while one is held back, tasks that are not
+/// rate limited keep running. A cancel is charged to the cancel buckets of the
+/// account and exchange of the order it withdraws (looked up through
+/// ITradingApi::order_route), so a burst of order entry never delays a cancel;
+/// cancels of orders the inner api does not know, and queries, are not limited.
 class QueuedTradingApi final : public ITradingApi {
 public:
+    enum class Lane { CANCEL = 0, ORDER = 1, QUERY = 2 };
+    static const int kLaneCount = 3;
+    static const int kStarvationLimit = 8;
+
+    /// @brief Per-lane queue-wait statistics (enqueue -> start of execution).
+    struct LaneStats {
+        uint64_t count = 0;
+        uint64_t total_wait_us = 0;
+        uint64_t max_wait_us = 0;
+    };
+
+    /// @brief While alive, calls made from this thread are urgent: they are
+    /// queued at the front of the cancel lane and run before anything else.
+    /// The rate limiter is charged for them but never holds them back; the
+    /// overdraft is repaid by later calls.
+    class UrgentScope {
+    public:
+        UrgentScope();
+        ~UrgentScope();
+        UrgentScope(const UrgentScope&) = delete;
+        UrgentScope& operator=(const UrgentScope&) = delete;
+    private:
+        bool prev_;
+    };
+
     explicit QueuedTradingApi(std::shared_ptr<ITradingApi> inner);
     ~QueuedTradingApi() override;
 
@@ -29,15 +70,58 @@ public:
     bool is_connected() const override;
 
     std::string place_order(const OrderRequest& req) override;
+    std::vector<std::string> place_orders(const std::vector<OrderRequest>& reqs) override;
     bool cancel_order(const std::string& order_id) override;
+    std::vector<bool> cancel_orders(const std::vector<std::string>& order_ids) override;
     std::vector<Position> query_positions() override;
+    bool query_positions_local(std::vector<Position>& out) override;
+    size_t reconcile_positions() override;
     std::vector<OrderResult> query_orders() override;
+    std::vector<OrderResult> query_orders(const std::string& symbol) override;
+    OrderResult query_order(const std::string& order_id) override;
+    bool query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) override;
+    bool query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) override;
+    bool order_route(const std::string& order_id, std::string& account, std::string& symbol) override;
+
+    // Non-blocking variants: the call is queued and the future completes on the
+    // worker thread. The blocking methods above wait on these.
+    std::future<std::string> place_order_async(const OrderRequest& req) override;
+    std::future<bool> cancel_order_async(const std::string& order_id) override;
+    std::future<std::vector<Position>> query_positions_async() override;
+    std::future<std::vector<OrderResult>> query_orders_async() override;
+
+    /// @brief Snapshot of the queue-wait statistics of one lane.
+    LaneStats lane_stats(Lane lane) const;
+
+    /// @brief How long a completed query result is shared with later callers
+    /// (0 = only share queries still in flight). Placing or cancelling an
+    /// order discards a completed order-query result.
+    void set_query_freshness(std::chrono::milliseconds window);
+
+    /// @brief Number of query calls answered by a shared query instead of a new one.
+    uint64_t coalesced_queries() const;
+
+    /// @brief Attach the limiter consulted before each order entry (nullptr = unlimited).
+    void set_rate_limiter(std::shared_ptr<RateLimiter> limiter);
 
     void shutdown();
 
 private:
+    struct Task {
+        std::function<void()> run;
+        std::chrono::steady_clock::time_point enqueued;
+        std::vector<RateLimiter::Ticket> tickets;   // empty = not rate limited
+        bool urgent = false;                        // charged to the limiter but never held back
+    };
+
     template <typename Func>
-    auto submit(Func func) const -> std::future<decltype(func())> {
+    auto submit(Lane lane, Func func) const -> std::future<decltype(func())> {
+        return submit(lane, std::vector<RateLimiter::Ticket>(), std::move(func));
+    }
+
+    template <typename Func>
+    auto submit(Lane lane, std::vector<RateLimiter::Ticket> tickets, Func func) const
+        -> std::future<decltype(func())> {
         using ResultT = decltype(func());
         auto task = std::make_shared<std::packaged_task<ResultT()>>(std::move(func));
         auto future = task->get_future();
@@ -49,20 +133,60 @@ private:
                     std::runtime_error("QueuedTradingApi is stopping")));
                 return promise.get_future();
             }
-            tasks_.emplace_back([task]() { (*task)(); });
+            Task entry;
+            entry.run = [task]() { (*task)(); };
+            entry.enqueued = std::chrono::steady_clock::now();
+            entry.tickets = std::move(tickets);
+            entry.urgent = urgent_;
+            if (urgent_) {
+                lanes_[static_cast<int>(Lane::CANCEL)].push_front(std::move(entry));
+            } else {
+                lanes_[static_cast<int>(lane)].push_back(std::move(entry));
+            }
         }
         cv_.notify_one();
         return future;
     }
 
+    /// @brief The most recent query of one kind and when it completed.
+    template <typename T>
+    struct Flight {
+        std::shared_future<T> result;
+        uint64_t generation = 0;
+        uint64_t started = 0;       // generation `result` was started under
+        bool completed = false;     // finished successfully and not invalidated
+        std::chrono::steady_clock::time_point completed_at;
+    };
+
+    template <typename T, typename Query>
+    std::shared_future<T> share_query(Flight<T>& flight, Query query);
+
+    void invalidate_orders_query();
+
+    static std::vector<RateLimiter::Ticket> tickets_for(const std::vector<OrderRequest>& reqs);
+    std::vector<RateLimiter::Ticket> cancel_tickets(const std::vector<std::string>& order_ids);
+
+    bool has_tasks() const;
+    int pick_lane();
+    std::chrono::microseconds throttle(const Task& task);
     void worker_loop();
 
     std::shared_ptr<ITradingApi> inner_;
 
     mutable std::mutex mutex_;
     mutable std::condition_variable cv_;
-    mutable std::deque<std::function<void()>> tasks_;
+    mutable std::deque<Task> lanes_[kLaneCount];
+    int skipped_[kLaneCount] = {};
+    LaneStats stats_[kLaneCount];
     bool stopping_ = false;
     std::thread worker_;
-};
+    std::shared_ptr<RateLimiter> limiter_;
 
+    mutable std::mutex flight_mutex_;
+    Flight<std::vector<Position>> positions_flight_;
+    Flight<std::vector<OrderResult>> orders_flight_;
+    std::chrono::milliseconds query_freshness_{0};
+    uint64_t coalesced_ = 0;
+
+    static thread_local bool urgent_;
+};
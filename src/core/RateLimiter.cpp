@@ -0,0 +1,110 @@
+#include "RateLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+void RateLimiter::set_limit(Limit& limit, double rate_per_sec, int burst) {
+    limit.rate = rate_per_sec;
+    limit.burst = std::max(1, burst);
+}
+
+void RateLimiter::set_account_limit(double rate_per_sec, int burst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_limit(order_limits_.account, rate_per_sec, burst);
+}
+
+void RateLimiter::set_exchange_limit(const std::string& exchange, double rate_per_sec, int burst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_limit(order_limits_.exchange[exchange], rate_per_sec, burst);
+}
+
+void RateLimiter::set_cancel_limit(double rate_per_sec, int burst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_limit(cancel_limits_.account, rate_per_sec, burst);
+}
+
+void RateLimiter::set_cancel_exchange_limit(const std::string& exchange, double rate_per_sec, int burst) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_limit(cancel_limits_.exchange[exchange], rate_per_sec, burst);
+}
+
+RateLimiter::Bucket& RateLimiter::refill(const std::string& key, const Limit& limit,
+                                         std::chrono::steady_clock::time_point now) {
+    Bucket& bucket = buckets_[key];
+    if (!bucket.started) {
+        bucket.tokens = limit.burst;
+        bucket.started = true;
+    } else {
+        double elapsed = std::chrono::duration<double>(now - bucket.last).count();
+        bucket.tokens = std::min(limit.burst, bucket.tokens + elapsed * limit.rate);
+    }
+    bucket.last = now;
+    return bucket;
+}
+
+void RateLimiter::collect(const std::vector<Ticket>& tickets, std::unordered_map<std::string, double>& demand,
+                          std::unordered_map<std::string, Limit>& limits) const {
+    // 汇总每个桶的需求量（同一批次可能涉及同一账号的多个交易所）
+    for (const auto& ticket : tickets) {
+        if (ticket.count <= 0) {
+            continue;
+        }
+        const Limits& group = ticket.cancel ? cancel_limits_ : order_limits_;
+        std::string prefix = ticket.cancel ? "cancel|" : "";
+        if (group.account.rate > 0.0) {
+            std::string key = prefix + ticket.account;
+            demand[key] += ticket.count;
+            limits[key] = group.account;
+        }
+        auto it = group.exchange.find(ticket.exchange);
+        if (!ticket.exchange.empty() && it != group.exchange.end() && it->second.rate > 0.0) {
+            std::string key = prefix + ticket.account + "|" + ticket.exchange;
+            demand[key] += ticket.count;
+            limits[key] = it->second;
+        }
+    }
+}
+
+std::chrono::microseconds RateLimiter::try_acquire(const std::vector<Ticket>& tickets) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::string, double> demand;
+    std::unordered_map<std::string, Limit> limits;
+    collect(tickets, demand, limits);
+
+    double wait_sec = 0.0;
+    for (const auto& entry : demand) {
+        const Limit& limit = limits[entry.first];
+        Bucket& bucket = refill(entry.first, limit, now);
+        double need = std::min(entry.second, limit.burst);
+        if (bucket.tokens < need) {
+            wait_sec = std::max(wait_sec, (need - bucket.tokens) / limit.rate);
+        }
+    }
+    if (wait_sec > 0.0) {
+        return std::chrono::microseconds(std::max<int64_t>(1, static_cast<int64_t>(std::ceil(wait_sec * 1e6))));
+    }
+    for (const auto& entry : demand) {
+        buckets_[entry.first].tokens -= entry.second;
+    }
+    return std::chrono::microseconds(0);
+}
+
+void RateLimiter::charge(const std::vector<Ticket>& tickets) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::string, double> demand;
+    std::unordered_map<std::string, Limit> limits;
+    collect(tickets, demand, limits);
+    for (const auto& entry : demand) {
+        refill(entry.first, limits[entry.first], now).tokens -= entry.second;
+    }
+}
+
+std::string RateLimiter::exchange_of(const std::string& symbol) {
+    size_t dot = symbol.rfind('.');
+    if (dot == std::string::npos) {
+        return "";
+    }
+    return symbol.substr(dot + 1);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief 令牌桶限流器：按资金账号、按交易所分别限制委托速率，允许突发
+///
+/// - 每个账号一个桶（set_account_limit 对所有账号生效）；
+/// - 每个（账号, 交易所）一个桶（set_exchange_limit 按交易所配置）；
+/// - 撤单另有一组同样划分的桶（set_cancel_limit / set_cancel_exchange_limit），
+///   大量下单不会耗尽撤单的额度；
+/// - 一次申请需同时满足所涉及的全部桶，否则不扣令牌并返回需等待的时长；
+/// - 申请量超过桶容量时（批量委托），桶满即放行并透支，之后按速率偿还。
+class RateLimiter {
+public:
+    /// @brief 一次申请中的一项：某账号在某交易所的委托笔数
+    struct Ticket {
+        std::string account;
+        std::string exchange;   // "SH" / "SZ"；为空时只计入账号桶
+        int count = 1;
+        bool cancel = false;    // true 时计入撤单的桶
+    };
+
+    /// @brief 每个账号的速率（笔/秒）与突发容量；rate<=0 表示不限
+    void set_account_limit(double rate_per_sec, int burst);
+
+    /// @brief 某交易所（每个账号分别计）的速率与突发容量；rate<=0 表示不限
+    void set_exchange_limit(const std::string& exchange, double rate_per_sec, int burst);
+
+    /// @brief 撤单：每个账号的速率与突发容量；rate<=0 表示不限
+    void set_cancel_limit(double rate_per_sec, int burst);
+
+    /// @brief 撤单：某交易所（每个账号分别计）的速率与突发容量；rate<=0 表示不限
+    void set_cancel_exchange_limit(const std::string& exchange, double rate_per_sec, int burst);
+
+    /// @brief 申请令牌
+    /// @return 0 表示已扣除可立即发送；否则为还需等待的时长（未扣除）
+    std::chrono::microseconds try_acquire(const std::vector<Ticket>& tickets);
+
+    /// @brief 不等待直接扣除令牌（紧急撤单）；桶不足时透支，之后按速率偿还
+    void charge(const std::vector<Ticket>& tickets);
+
+    /// @brief 从证券代码（如 600000.SH）取交易所后缀
+    static std::string exchange_of(const std::string& symbol);
+
+private:
+    struct Limit {
+        double rate = 0.0;
+        double burst = 0.0;
+    };
+
+    struct Bucket {
+        double tokens = 0.0;
+        std::chrono::steady_clock::time_point last;
+        bool started = false;
+    };
+
+    Bucket& refill(const std::string& key, const Limit& limit, std::chrono::steady_clock::time_point now);
+
+    /// 汇总各桶的需求量及其限额（需持有 mutex_）
+    void collect(const std::vector<Ticket>& tickets, std::unordered_map<std::string, double>& demand,
+                 std::unordered_map<std::string, Limit>& limits) const;
+
+    /// 委托或撤单的一组限额
+    struct Limits {
+        Limit account;
+        std::unordered_map<std::string, Limit> exchange;
+    };
+
+    static void set_limit(Limit& limit, double rate_per_sec, int burst);
+
+    std::mutex mutex_;
+    Limits order_limits_;
+    Limits cancel_limits_;
+    std::unordered_map<std::string, Bucket> buckets_;
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+/// @brief 顺序锁（seqlock）槽位：单个 POD 值的无锁发布
+///
+/// 写端：序号置奇 -> 写数据 -> 序号置偶；读端读取前后序号一致且为偶数时数据有效。
+/// 读端从不阻塞写端，写端也不等待读端。数据按 64 位原子字逐字拷贝，避免数据竞争。
+/// T 必须是可平凡拷贝的类型（不能含 std::string 等）。
+template <typename T>
+class SeqLock {
+#if !defined(__GNUC__) || defined(__clang__) || (__GNUC__ >= 5)
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock 只能存放可平凡拷贝的类型");
+#endif
+
+public:
+    SeqLock() : seq_(0) {
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// @brief 写入新值（允许多个写端，写端之间互相串行）
+    void store(const T& value) {
+        uint64_t buf[kWords];
+        buf[kWords - 1] = 0;
+        std::memcpy(buf, &value, sizeof(T));
+
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((seq & 1) == 0 &&
+                seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+                break;
+            }
+            seq = seq_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /// @brief 尝试读取一次；读期间发生写入则返回 false
+    bool try_load(T& out) const {
+        uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        uint64_t buf[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, buf, sizeof(T));
+        return true;
+    }
+
+    /// @brief 读取一致的值（写端正在写时自旋重试）
+    T load() const {
+        T out;
+        unsigned spins = 0;
+        while (!try_load(out)) {
+            if (++spins % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        return out;
+    }
+
+    /// @brief 已完成的写入次数（可作为更新序号使用）
+    uint64_t version() const {
+        return seq_.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    static const size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> seq_;
+    std::atomic<uint64_t> words_[kWords];
+};
@@ -0,0 +1,34 @@
+#include "SnapshotStore.h"
+
+void SnapshotStore::reset(size_t capacity) {
+    slots_.reset(capacity > 0 ? new SeqLock<MarketSnapshot>[capacity] : nullptr);
+    capacity_ = capacity;
+}
+
+bool SnapshotStore::store(InstrumentId id, const MarketSnapshot& snap) {
+    if (id < 0 || static_cast<size_t>(id) >= capacity_) {
+        return false;
+    }
+    slots_[static_cast<size_t>(id)].store(snap);
+    return true;
+}
+
+bool SnapshotStore::load(InstrumentId id, MarketSnapshot& out) const {
+    if (id < 0 || static_cast<size_t>(id) >= capacity_) {
+        return false;
+    }
+    const SeqLock<MarketSnapshot>& slot = slots_[static_cast<size_t>(id)];
+    if (slot.version() == 0) {
+        return false;
+    }
+    out = slot.load();
+    out.instrument = id;
+    return true;
+}
+
+uint64_t SnapshotStore::version(InstrumentId id) const {
+    if (id < 0 || static_cast<size_t>(id) >= capacity_) {
+        return 0;
+    }
+    return slots_[static_cast<size_t>(id)].version();
+}
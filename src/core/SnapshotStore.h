@@ -0,0 +1,41 @@
+#pragma once
+#include "InstrumentRegistry.h"
+#include "MarketData.h"
+#include "SeqLock.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// @brief 行情快照存储：按 InstrumentId 下标的固定容量数组，每个证券一个 seqlock 槽位
+///
+/// - 容量在行情连接前按订阅列表一次性分配（reset），之后不再扩容；
+/// - 写端（行情回调线程）只写对应 ID 的槽位；
+/// - 读端（模块/策略线程）按 ID 直接定位、无锁读取，不会阻塞行情回调。
+class SnapshotStore {
+public:
+    SnapshotStore() = default;
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    /// @brief 预分配槽位（必须在行情回调开始前调用）
+    /// @param capacity 槽位数，ID >= capacity 的证券不缓存
+    void reset(size_t capacity);
+
+    /// @brief 写入快照（仅行情回调线程调用）
+    /// @return ID 超出容量时返回 false
+    bool store(InstrumentId id, const MarketSnapshot& snap);
+
+    /// @brief 读取快照（无锁）；未写入过时返回 false
+    bool load(InstrumentId id, MarketSnapshot& out) const;
+
+    /// @brief 槽位版本号（每次写入加一，未写入过为 0）
+    uint64_t version(InstrumentId id) const;
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    std::unique_ptr<SeqLock<MarketSnapshot>[]> slots_;
+    size_t capacity_ = 0;
+};
@@ -0,0 +1,73 @@
+#include "TickHistory.h"
+
+void TickHistory::reset(const std::vector<InstrumentId>& ids, size_t per_symbol_capacity) {
+    rings_.clear();
+    capacity_ = per_symbol_capacity;
+    if (capacity_ == 0) {
+        return;
+    }
+    for (InstrumentId id : ids) {
+        if (id < 0) {
+            continue;
+        }
+        size_t idx = static_cast<size_t>(id);
+        if (idx >= rings_.size()) {
+            rings_.resize(idx + 1);
+        }
+        if (!rings_[idx]) {
+            std::unique_ptr<Ring> ring(new Ring());
+            ring->entries.reset(new SeqLock<TickRecord>[capacity_]);
+            rings_[idx] = std::move(ring);
+        }
+    }
+}
+
+void TickHistory::append(InstrumentId id, const TickRecord& rec) {
+    if (id < 0 || static_cast<size_t>(id) >= rings_.size() || !rings_[static_cast<size_t>(id)]) {
+        return;
+    }
+    Ring& ring = *rings_[static_cast<size_t>(id)];
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    TickRecord stamped = rec;
+    stamped.seq = head;
+    ring.entries[head % capacity_].store(stamped);
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+bool TickHistory::read_at(const Ring& ring, uint64_t i, TickRecord& out) const {
+    out = ring.entries[i % capacity_].load();
+    return out.seq == i;
+}
+
+bool TickHistory::query(InstrumentId id, int start_time, int end_time,
+                        std::vector<TickRecord>& out) const {
+    if (id < 0 || static_cast<size_t>(id) >= rings_.size() || !rings_[static_cast<size_t>(id)]) {
+        return false;
+    }
+    const Ring& ring = *rings_[static_cast<size_t>(id)];
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t lo = head > capacity_ ? head - capacity_ : 0;
+    uint64_t hi = head;
+
+    // 二分查找第一条 timestamp >= start_time；被覆盖的槽位视为更早的数据
+    TickRecord rec;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (!read_at(ring, mid, rec) || rec.timestamp < start_time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (uint64_t i = lo; i < head; ++i) {
+        if (!read_at(ring, i, rec)) {
+            continue;  // 读取期间被新数据覆盖
+        }
+        if (rec.timestamp > end_time) {
+            break;
+        }
+        out.push_back(rec);
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "InstrumentRegistry.h"
+#include "SeqLock.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// @brief 单条历史 tick（快照的精简版，可平凡拷贝）
+struct TickRecord {
+    uint64_t seq;          ///< 该证券内的写入序号（用于识别被覆盖的槽位）
+    int timestamp;         ///< HHMMSSmmm
+    double last_price;
+    double high;
+    double low;
+    int64_t volume;        ///< 累计成交量
+    int64_t turnover;      ///< 累计成交额
+    int64_t bid_px1;       ///< 买一价（定点，元 × kPriceScale）
+    int64_t bid_volume1;
+    int64_t ask_px1;       ///< 卖一价（定点）
+    int64_t ask_volume1;
+};
+
+/// @brief 按证券预分配的定长 tick 环形缓冲
+///
+/// - reset 在行情回调开始前为订阅证券一次性分配全部槽位，写入时不再分配内存；
+/// - 每个证券单写端（行情回调线程），任意读端；读写都不加锁；
+/// - 时间戳单调不减，查询按时间二分定位起点。
+class TickHistory {
+public:
+    TickHistory() = default;
+    TickHistory(const TickHistory&) = delete;
+    TickHistory& operator=(const TickHistory&) = delete;
+
+    /// @brief 为指定证券分配环形缓冲（必须在行情回调开始前调用）
+    /// @param ids 需要保留历史的证券
+    /// @param per_symbol_capacity 每只证券保留的最近 tick 条数
+    void reset(const std::vector<InstrumentId>& ids, size_t per_symbol_capacity);
+
+    /// @brief 追加一条 tick（仅行情回调线程调用）；未分配缓冲的证券直接忽略
+    void append(InstrumentId id, const TickRecord& rec);
+
+    /// @brief 查询时间区间 [start, end] 内仍在缓冲中的 tick（HHMMSSmmm，闭区间）
+    /// @return 未分配缓冲时返回 false
+    bool query(InstrumentId id, int start_time, int end_time, std::vector<TickRecord>& out) const;
+
+    size_t per_symbol_capacity() const { return capacity_; }
+
+private:
+    struct Ring {
+        std::unique_ptr<SeqLock<TickRecord>[]> entries;
+        std::atomic<uint64_t> head;  ///< 下一条写入序号
+
+        Ring() : head(0) {}
+    };
+
+    /// @brief 读取逻辑序号 i 的记录；已被覆盖时返回 false
+    bool read_at(const Ring& ring, uint64_t i, TickRecord& out) const;
+
+    std::vector<std::unique_ptr<Ring>> rings_;  ///< 按 InstrumentId 下标，未订阅为空
+    size_t capacity_ = 0;
+};
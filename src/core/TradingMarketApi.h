@@ -58,20 +58,81 @@ public:
         return trading_api_->place_order(req);
     }
     
+    /// @brief 批量下单
+    virtual std::vector<std::string> place_orders(const std::vector<OrderRequest>& reqs) override {
+        return trading_api_->place_orders(reqs);
+    }
+    
     /// @brief 撤单
     virtual bool cancel_order(const std::string& order_id) override {
         return trading_api_->cancel_order(order_id);
     }
     
+    /// @brief 批量撤单
+    virtual std::vector<bool> cancel_orders(const std::vector<std::string>& order_ids) override {
+        return trading_api_->cancel_orders(order_ids);
+    }
+    
     /// @brief 查询持仓
     virtual std::vector<Position> query_positions() override {
         return trading_api_->query_positions();
     }
     
+    /// @brief 读取本地持仓台账
+    virtual bool query_positions_local(std::vector<Position>& out) override {
+        return trading_api_->query_positions_local(out);
+    }
+    
+    /// @brief 持仓对账
+    virtual size_t reconcile_positions() override {
+        return trading_api_->reconcile_positions();
+    }
+    
+    /// @brief 读取本地订单簿：某证券的活动订单 / 某标签键的订单
+    virtual bool query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) override {
+        return trading_api_->query_live_orders_local(instrument, out);
+    }
+    
+    virtual bool query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) override {
+        return trading_api_->query_orders_by_tag_local(tag_key, out);
+    }
+    
+    /// @brief 本地订单的资金账号与证券代码
+    virtual bool order_route(const std::string& order_id, std::string& account, std::string& symbol) override {
+        return trading_api_->order_route(order_id, account, symbol);
+    }
+
+    /// @brief 非阻塞下单 / 撤单 / 查询
+    virtual std::future<std::string> place_order_async(const OrderRequest& req) override {
+        return trading_api_->place_order_async(req);
+    }
+    
+    virtual std::future<bool> cancel_order_async(const std::string& order_id) override {
+        return trading_api_->cancel_order_async(order_id);
+    }
+    
+    virtual std::future<std::vector<Position>> query_positions_async() override {
+        return trading_api_->query_positions_async();
+    }
+    
+    virtual std::future<std::vector<OrderResult>> query_orders_async() override {
+        return trading_api_->query_orders_async();
+    }
+    
     /// @brief 查询订单
     virtual std::vector<OrderResult> query_orders() override {
         return trading_api_->query_orders();
     }
+    
+    /// @brief 按证券查询订单
+    virtual std::vector<OrderResult> query_orders(const std::string& symbol) override {
+        return trading_api_->query_orders(symbol);
+    }
+    
+    /// @brief 查询单个订单
+    virtual OrderResult query_order(const std::string& order_id) override {
+        return trading_api_->query_order(order_id);
+    }
 
     // ========== 行情API方法（转发到 market_data_api_）==========
     
@@ -89,6 +150,21 @@ public:
         return market_data_api_->get_limits(symbol);
     }
     
+    /// @brief 获取行情快照（按证券 ID）
+    MarketSnapshot get_snapshot(InstrumentId id) {
+        return market_data_api_->get_snapshot(id);
+    }
+    
+    /// @brief 获取涨跌停价（按证券 ID）
+    std::pair<double, double> get_limits(InstrumentId id) {
+        return market_data_api_->get_limits(id);
+    }
+    
+    /// @brief 获取买一委托队列（涨停封单深度）
+    bool get_limit_up_queue(InstrumentId id, LimitUpQueue& out) {
+        return market_data_api_->get_limit_up_queue(id, out);
+    }
+    
     /// @brief 获取集合竞价数据
     /// @param symbol 股票代码
     /// @param date 日期 YYYYMMDD格式
@@ -1,5 +1,6 @@
 #include "BaseCancelModule.h"
 
+#include "../core/QueuedTradingApi.h"
 #include "../core/util.h"
 #include "itpdk/itpdk_dict.h"
 #include "ImprovedLogger.h"
@@ -10,7 +11,6 @@
 #include <ctime>
 #include <fstream>
 #include <sstream>
-#include <thread>
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -26,7 +26,6 @@ namespace {
 constexpr const char* kStrategyName = "qh2h_base_cancel";
 
 constexpr int kBatchSize = 100;
-constexpr int kBatchSleepMs = 1000;
 constexpr int kPanqianBatchSize = 150;
 }
 
@@ -82,6 +81,11 @@ bool BaseCancelModule::init(AppContext& ctx) {
         second_order_by_symbol_.clear();
         second_ready_.clear();
         second_canceled_.clear();
+        second_inflight_.clear();
+        pending_cancels_.clear();
+        reaction_count_ = 0;
+        reaction_total_us_ = 0;
+        reaction_max_us_ = 0;
         zt_cache_.clear();
         preclose_cache_.clear();
     }
@@ -126,50 +130,133 @@ void BaseCancelModule::tick(AppContext& ctx) {
 }
 
 void BaseCancelModule::on_order_event(AppContext& ctx, const OrderResult& result, int notify_type) {
-    (void)ctx;
-
     // 排撤触发只需要“委托推送”(nType=NOTIFY_PUSH_ORDER)。
     // 外部单出现就撤第二单：不必等待成交推送。
     if (notify_type != NOTIFY_PUSH_ORDER) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    auto received = std::chrono::steady_clock::now();
+    std::string triggered;
+    std::string target;
+    std::string symbol;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
 
-    // Only external orders trigger cancel; ignore local orders and the second order itself.
-    if (result.is_local || second_order_ids_.count(result.order_id) > 0) {
-        return;
+        // Only external orders trigger cancel; ignore local orders and the second order itself.
+        if (result.is_local || second_order_ids_.count(result.order_id) > 0) {
+            return;
+        }
+
+        // Sell + limit (OrderType==0) + 100 shares + limit-up price.
+        if (result.side != 1 || result.order_type != 0 || result.volume != 100) {
+            return;
+        }
+
+        symbol = result.symbol;
+        auto zt_it = zt_cache_.find(symbol);
+        if (zt_it == zt_cache_.end()) {
+            std::string code = extract_code_from_symbol(symbol);
+            std::string alt = to_symbol(code);
+            if (!alt.empty()) {
+                symbol = alt;
+                zt_it = zt_cache_.find(symbol);
+            }
+        }
+        if (zt_it == zt_cache_.end()) {
+            return;
+        }
+
+        if (std::abs(result.price - zt_it->second) < 0.01) {
+            auto it = second_order_by_symbol_.find(symbol);
+            if (it != second_order_by_symbol_.end()) {
+                const std::string& second_order_id = it->second;
+                if (second_canceled_.count(second_order_id) == 0 &&
+                    second_inflight_.count(second_order_id) == 0) {
+                    second_ready_.insert(second_order_id);
+                    triggered = second_order_id;
+                    // 撤单时段内直接在回调线程发出；时段外留给 tick 在时段开始后撤
+                    if (!ctx.stop.load() && time_in_range(current_hhmmss(), 92900, 145500)) {
+                        second_inflight_.insert(second_order_id);
+                        target = second_order_id;
+                    }
+                }
+            }
+        }
     }
 
-    // Sell + limit (OrderType==0) + 100 shares + limit-up price.
-    if (result.side != 1 || result.order_type != 0 || result.volume != 100) {
-        return;
+    // 先撤单后写日志，日志不计入反应时延
+    if (!target.empty()) {
+        submit_cancel(ctx, target, symbol, received);
+    }
+    if (!triggered.empty()) {
+        logger_->info("[CALLBACK] external " + symbol + " order=" + result.order_id +
+                      " trigger cancel second=" + triggered + (target.empty() ? " (outside cancel window)" : ""));
     }
+}
 
-    std::string symbol = result.symbol;
-    auto zt_it = zt_cache_.find(symbol);
-    if (zt_it == zt_cache_.end()) {
-        std::string code = extract_code_from_symbol(symbol);
-        std::string alt = to_symbol(code);
-        if (!alt.empty()) {
-            symbol = alt;
-            zt_it = zt_cache_.find(symbol);
-        }
+void BaseCancelModule::submit_cancel(AppContext& ctx, const std::string& order_id, const std::string& symbol,
+                                     std::chrono::steady_clock::time_point received) {
+    PendingCancel pending;
+    pending.order_id = order_id;
+    pending.symbol = symbol;
+    {
+        // 插到交易队列最前面；只提交不等待，结果在 tick 中取回
+        QueuedTradingApi::UrgentScope urgent;
+        pending.done = ctx.trading->cancel_order_async(order_id);
     }
-    if (zt_it == zt_cache_.end()) {
-        return;
+    uint64_t reaction_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - received).count());
+
+    uint64_t count = 0;
+    uint64_t avg_us = 0;
+    uint64_t max_us = 0;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        pending_cancels_.push_back(std::move(pending));
+        ++reaction_count_;
+        reaction_total_us_ += reaction_us;
+        reaction_max_us_ = std::max(reaction_max_us_, reaction_us);
+        count = reaction_count_;
+        avg_us = reaction_total_us_ / reaction_count_;
+        max_us = reaction_max_us_;
+    }
+    logger_->info_f("[CANCEL] submit %s order=%s reaction_us=%llu (n=%llu avg=%llu max=%llu)",
+                    symbol.c_str(), order_id.c_str(),
+                    static_cast<unsigned long long>(reaction_us), static_cast<unsigned long long>(count),
+                    static_cast<unsigned long long>(avg_us), static_cast<unsigned long long>(max_us));
+}
+
+void BaseCancelModule::collect_cancels() {
+    std::vector<PendingCancel> finished;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        for (size_t i = 0; i < pending_cancels_.size();) {
+            if (pending_cancels_[i].done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++i;
+                continue;
+            }
+            finished.push_back(std::move(pending_cancels_[i]));
+            pending_cancels_[i] = std::move(pending_cancels_.back());
+            pending_cancels_.pop_back();
+        }
     }
 
-    if (std::abs(result.price - zt_it->second) < 0.01) {
-        auto it = second_order_by_symbol_.find(symbol);
-        if (it != second_order_by_symbol_.end()) {
-            const std::string& second_order_id = it->second;
-            if (second_canceled_.count(second_order_id) == 0) {
-                second_ready_.insert(second_order_id);
-                logger_->info("[CALLBACK] external " + symbol + " order=" + result.order_id +
-                              " trigger cancel second=" + second_order_id);
+    for (auto& pending : finished) {
+        bool ok = pending.done.get();
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            second_inflight_.erase(pending.order_id);
+            if (ok) {
+                second_canceled_.insert(pending.order_id);
             }
         }
+        if (ok) {
+            logger_->info("[CANCEL] " + pending.symbol + " order=" + pending.order_id);
+        } else {
+            // 留在 second_ready_ 中，由 do_cancel 重试
+            logger_->warn("[CANCEL] failed " + pending.symbol + " order=" + pending.order_id + ", will retry");
+        }
     }
 }
 
@@ -526,6 +613,25 @@ void BaseCancelModule::do_base_buy(AppContext& ctx, int now) {
 
     auto pos_map = build_position_map(ctx.trading->query_positions());
     int buy_count = 0;
+    std::vector<OrderRequest> batch;
+    batch.reserve(kBatchSize);
+
+    // 每 kBatchSize 笔合并为一次批量委托，发送速率由交易队列的限流器控制
+    auto flush = [&]() {
+        if (batch.empty()) {
+            return;
+        }
+        std::vector<std::string> order_ids = ctx.trading->place_orders(batch);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!order_ids[i].empty()) {
+                buy_count++;
+                logger_->info_f("[BUY] %s vol=%lld price=%.2f order=%s",
+                                batch[i].symbol.c_str(), static_cast<long long>(batch[i].volume),
+                                batch[i].price, order_ids[i].c_str());
+            }
+        }
+        batch.clear();
+    };
 
     for (const auto& symbol : buy_symbols_) {
         int64_t current = 0;
@@ -543,11 +649,6 @@ void BaseCancelModule::do_base_buy(AppContext& ctx, int now) {
             continue;
         }
 
-        if (buy_count > 0 && buy_count % kBatchSize == 0) {
-            logger_->info_f("[BUY] batch sleep 1s (%d orders)", buy_count);
-            std::this_thread::sleep_for(std::chrono::milliseconds(kBatchSleepMs));
-        }
-
         double buy_price = 0.0;
         {
             std::lock_guard<std::mutex> lock(ctx.market_mutex);
@@ -574,14 +675,14 @@ void BaseCancelModule::do_base_buy(AppContext& ctx, int now) {
         req.volume = vol;
         req.is_market = true;
         req.remark = std::string(kStrategyName) + "_base_buy_" + symbol + "_" + std::to_string(now);
+        req.tag = next_order_tag(StrategyIds::kQh2hBaseCancel, InstrumentRegistry::instance().find(req.symbol));
 
-        std::string order_id = ctx.trading->place_order(req);
-        if (!order_id.empty()) {
-            buy_count++;
-            logger_->info_f("[BUY] %s vol=%lld price=%.2f order=%s",
-                            symbol.c_str(), static_cast<long long>(vol), buy_price, order_id.c_str());
+        batch.push_back(req);
+        if (static_cast<int>(batch.size()) >= kBatchSize) {
+            flush();
         }
     }
+    flush();
 
     logger_->info_f("[BUY] done, total %d orders", buy_count);
 }
@@ -589,6 +690,23 @@ void BaseCancelModule::do_base_buy(AppContext& ctx, int now) {
 void BaseCancelModule::do_pre_orders(AppContext& ctx, int now) {
     auto pos_map = build_position_map(ctx.trading->query_positions());
     int placed = 0;
+    std::vector<OrderRequest> batch;
+    batch.reserve(kPanqianBatchSize);
+
+    // 每 kPanqianBatchSize 笔合并为一次批量委托
+    auto flush = [&]() {
+        if (batch.empty()) {
+            return;
+        }
+        std::vector<std::string> order_ids = ctx.trading->place_orders(batch);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!order_ids[i].empty()) {
+                logger_->info_f("[PRE] %s zt=%.2f order=%s",
+                                batch[i].symbol.c_str(), batch[i].price, order_ids[i].c_str());
+            }
+        }
+        batch.clear();
+    };
 
     for (size_t idx = static_cast<size_t>(panqian_index_); idx < holding_symbols_.size(); ++idx) {
         if (panqian_index_ >= 270 && now < 91500) {
@@ -645,17 +763,15 @@ void BaseCancelModule::do_pre_orders(AppContext& ctx, int now) {
         req.volume = 100;
         req.is_market = false;
         req.remark = std::string(kStrategyName) + "_pre_" + symbol + "_" + std::to_string(now);
+        req.tag = next_order_tag(StrategyIds::kQh2hBaseCancel, InstrumentRegistry::instance().find(req.symbol));
 
-        std::string order_id = ctx.trading->place_order(req);
-        if (!order_id.empty()) {
-            logger_->info_f("[PRE] %s zt=%.2f order=%s", symbol.c_str(), zt, order_id.c_str());
-        }
-
+        batch.push_back(req);
         placed++;
         if (placed % kPanqianBatchSize == 0) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            flush();
         }
     }
+    flush();
 
     if (panqian_index_ >= static_cast<int>(holding_symbols_.size())) {
         panqian_done_ = true;
@@ -708,10 +824,6 @@ void BaseCancelModule::do_second_orders(AppContext& ctx, int now) {
             continue;
         }
 
-        if (queue_count > 0 && queue_count % kBatchSize == 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(kBatchSleepMs));
-        }
-
         OrderRequest req;
         req.account_id = account_id_;
         req.symbol = symbol;
@@ -720,6 +832,7 @@ void BaseCancelModule::do_second_orders(AppContext& ctx, int now) {
         req.volume = 100;
         req.is_market = false;
         req.remark = std::string(kStrategyName) + "_queue_" + symbol + "_" + std::to_string(now);
+        req.tag = next_order_tag(StrategyIds::kQh2hBaseCancel, InstrumentRegistry::instance().find(req.symbol));
 
         std::string order_id = ctx.trading->place_order(req);
         if (!order_id.empty()) {
@@ -780,8 +893,8 @@ void BaseCancelModule::do_sell_non_list_positions(AppContext& ctx, int now) {
                 sell_price = dt;
             } else {
                 MarketSnapshot snap = ctx.market->get_snapshot(sell_symbol);
-                if (snap.valid && snap.bid_price1 > 0.0) {
-                    sell_price = round_price(snap.bid_price1);
+                if (snap.valid && snap.bid_price(0) > 0.0) {
+                    sell_price = round_price(snap.bid_price(0));
                 }
             }
         }
@@ -798,6 +911,7 @@ void BaseCancelModule::do_sell_non_list_positions(AppContext& ctx, int now) {
         req.volume = vol;
         req.is_market = false;
         req.remark = std::string(kStrategyName) + "_sell_non_list_" + sell_symbol + "_" + std::to_string(now);
+        req.tag = next_order_tag(StrategyIds::kQh2hBaseCancel, InstrumentRegistry::instance().find(req.symbol));
 
         std::string order_id = ctx.trading->place_order(req);
         if (!order_id.empty()) {
@@ -812,6 +926,9 @@ void BaseCancelModule::do_sell_non_list_positions(AppContext& ctx, int now) {
 }
 
 void BaseCancelModule::do_cancel(AppContext& ctx) {
+    // 回调中已发出的撤单在此取回结果；时段开始前触发的和失败待重试的在此补撤
+    collect_cancels();
+
     std::vector<std::string> to_cancel;
     {
         std::lock_guard<std::mutex> lock(state_mutex_);
@@ -819,14 +936,21 @@ void BaseCancelModule::do_cancel(AppContext& ctx) {
             if (second_order_ids_.count(order_id) == 0) {
                 continue;
             }
-            if (second_canceled_.count(order_id) == 0) {
+            if (second_canceled_.count(order_id) == 0 && second_inflight_.count(order_id) == 0) {
                 to_cancel.push_back(order_id);
             }
         }
     }
 
-    for (const auto& order_id : to_cancel) {
-        if (ctx.trading->cancel_order(order_id)) {
+    std::vector<bool> cancelled;
+    {
+        // 排撤单插到交易队列最前面，不等待排在前面的委托/查询
+        QueuedTradingApi::UrgentScope urgent;
+        cancelled = ctx.trading->cancel_orders(to_cancel);
+    }
+    for (size_t i = 0; i < to_cancel.size(); ++i) {
+        const std::string& order_id = to_cancel[i];
+        if (cancelled[i]) {
             std::string symbol = "unknown";
             {
                 std::lock_guard<std::mutex> lock(state_mutex_);
@@ -5,6 +5,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -60,6 +61,9 @@ private:
     void do_pre_orders(AppContext& ctx, int now);
     void do_second_orders(AppContext& ctx, int now);
     void do_cancel(AppContext& ctx);
+    void submit_cancel(AppContext& ctx, const std::string& order_id, const std::string& symbol,
+                       std::chrono::steady_clock::time_point received);
+    void collect_cancels();
     void do_sell_non_list_positions(AppContext& ctx, int now);
 
     std::string account_id_;
@@ -86,6 +90,20 @@ private:
     std::unordered_map<std::string, std::string> second_order_by_symbol_;
     std::unordered_set<std::string> second_ready_;
     std::unordered_set<std::string> second_canceled_;
+    std::unordered_set<std::string> second_inflight_;     // 回调中已发出、结果未取回的撤单
+
+    /// @brief 回调中直接发出的排撤单
+    struct PendingCancel {
+        std::string order_id;
+        std::string symbol;
+        std::future<bool> done;
+    };
+    std::vector<PendingCancel> pending_cancels_;
+
+    // 外部单推送到达 → 撤单提交到交易队列的反应时延
+    uint64_t reaction_count_ = 0;
+    uint64_t reaction_total_us_ = 0;
+    uint64_t reaction_max_us_ = 0;
     std::unordered_map<std::string, double> zt_cache_;
     std::unordered_map<std::string, double> preclose_cache_;
 };
@@ -4,6 +4,7 @@
 #include "../core/Order.h"
 
 #include <chrono>
+#include <thread>
 
 class IModule {
 public:
@@ -15,5 +16,12 @@ public:
     virtual bool init(AppContext& ctx) = 0;
     virtual void tick(AppContext& ctx) = 0;
     virtual void on_order_event(AppContext& ctx, const OrderResult& result, int notify_type) = 0;
+
+    // Waits between ticks. The default sleeps until the deadline; modules that
+    // subscribe to market updates can return early when an update arrives.
+    virtual void wait_next_tick(AppContext& ctx, std::chrono::steady_clock::time_point deadline) {
+        (void)ctx;
+        std::this_thread::sleep_until(deadline);
+    }
 };
 
@@ -40,7 +40,7 @@ bool Qh2hSellModule::init(AppContext& ctx) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
         pos_map_ = build_position_map(positions);
-        symbols_ = build_symbol_list(positions);
+        set_symbols(build_symbol_list(positions));
 
         states_.clear();
         for (const auto& symbol : symbols_) {
@@ -59,6 +59,14 @@ bool Qh2hSellModule::init(AppContext& ctx) {
         active_ = !symbols_.empty();
     }
 
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        updates_ = ctx.market->subscribe_updates(symbol_ids_);
+    }
+    if (!updates_) {
+        logger_->info("[INIT] market update push unavailable; polling every tick");
+    }
+
     if (!active_) {
         logger_->warn("[INIT] no symbols available for sell; module will stay idle");
     } else {
@@ -86,7 +94,7 @@ void Qh2hSellModule::tick(AppContext& ctx) {
         auto refreshed = ctx.trading->query_positions();
         std::lock_guard<std::mutex> lock(mutex_);
         pos_map_ = build_position_map(refreshed);
-        symbols_ = build_symbol_list(refreshed);
+        set_symbols(build_symbol_list(refreshed));
         states_.clear();
         for (const auto& symbol : symbols_) {
             states_[symbol] = StockState();
@@ -108,14 +116,39 @@ void Qh2hSellModule::tick(AppContext& ctx) {
         last_pos_refresh_ = steady_now;
     }
 
+    // 有行情推送时：未封板的证券只在收到更新（或每秒兜底扫描）时读快照；
+    // 已炸板的证券仍按 tick_interval 周期处理
+    bool periodic = steady_now >= next_periodic_;
+    if (periodic) {
+        next_periodic_ = steady_now + tick_interval();
+    }
+    bool sweep = !updates_ || steady_now >= next_sweep_;
+    if (updates_) {
+        if (sweep) {
+            next_sweep_ = steady_now + std::chrono::seconds(1);
+        }
+        pending_updates_.clear();
+        updates_->drain(pending_updates_);
+        updated_.clear();
+        for (const MarketUpdate& update : pending_updates_) {
+            updated_[update.id] = 1;
+        }
+    }
+
     bool use_post_rules = now >= 93500;
     std::vector<std::string> local_symbols;
+    std::vector<InstrumentId> local_ids;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         local_symbols = symbols_;
+        local_ids = symbol_ids_;
     }
 
-    for (const auto& symbol : local_symbols) {
+    // 本轮各证券的卖单只发出不等待，循环结束后统一取回委托号
+    std::vector<PendingSell> pending_sells;
+    for (size_t idx = 0; idx < local_symbols.size(); ++idx) {
+        const std::string& symbol = local_symbols[idx];
+        InstrumentId id = local_ids[idx];
         StockState state;
         Position pos;
         double zt = 0.0;
@@ -130,36 +163,51 @@ void Qh2hSellModule::tick(AppContext& ctx) {
             if (pos_it != pos_map_.end()) {
                 pos = pos_it->second;
             }
-            auto zt_it = zt_cache_.find(symbol);
-            if (zt_it != zt_cache_.end()) {
-                zt = zt_it->second;
+            if (const double* cached = zt_cache_.find(id)) {
+                zt = *cached;
             }
         }
 
         if (state.zhaban == 0) {
+            if (!sweep && !updated_.contains(id)) {
+                continue;
+            }
             MarketSnapshot snap;
+            LimitUpQueue queue;
+            bool has_queue = false;
             {
                 std::lock_guard<std::mutex> lock(ctx.market_mutex);
-                snap = ctx.market->get_snapshot(symbol);
+                snap = ctx.market->get_snapshot(id);
+                has_queue = ctx.market->get_limit_up_queue(id, queue);
             }
             if (!snap.valid) {
                 continue;
             }
 
-            double buy_price1 = round_price(snap.bid_price1);
-            int64_t buy_vol1 = snap.bid_volume1;
-
             if (zt <= 0.0) {
-                zt = resolve_zt_price(ctx, symbol);
+                zt = resolve_zt_price(ctx, id);
                 if (zt > 0.0) {
                     std::lock_guard<std::mutex> lock(mutex_);
-                    zt_cache_[symbol] = zt;
+                    zt_cache_[id] = zt;
                 }
             }
             if (zt <= 0.0) {
                 continue;
             }
 
+            double buy_price1 = round_price(snap.bid_price(0));
+            int64_t buy_vol1 = snap.bid_volume(0);
+            // 委托队列比快照新时参考队列：只有涨停价上明细完整的队列才能替代快照买一，
+            // 否则队列累计量只是下限（或不在涨停价），不能据此判定封单变弱
+            if (has_queue && queue.timestamp >= snap.timestamp && queue.price > 0.0) {
+                if (round_price(queue.price) == zt && queue.items >= queue.orders) {
+                    buy_price1 = zt;
+                    buy_vol1 = queue.volume;
+                } else {
+                    buy_vol1 = std::max(queue.volume, buy_vol1);
+                }
+            }
+
             if (buy_price1 == zt && buy_vol1 > 0 && state.fengban == 0) {
                 logger_->info("[FB] " + symbol + " is FB! sleeping 1s...");
                 std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -168,11 +216,13 @@ void Qh2hSellModule::tick(AppContext& ctx) {
                 OrderRequest req;
                 req.account_id = account_id_;
                 req.symbol = symbol;
+                req.instrument = id;
                 req.side = OrderSide::Buy;
                 req.price = buy_price;
                 req.volume = 100;
                 req.is_market = false;
                 req.remark = std::string(kStrategyName) + "_pair_buy_" + symbol;
+                req.tag = next_order_tag(StrategyIds::kQh2hSell, id);
 
                 std::string order_id = ctx.trading->place_order(req);
                 if (!order_id.empty()) {
@@ -187,35 +237,17 @@ void Qh2hSellModule::tick(AppContext& ctx) {
                     continue;
                 }
 
-                double sell_price = resolve_sell_price(ctx, symbol);
+                double sell_price = resolve_sell_price(ctx, id);
                 if (sell_price <= 0.0) {
                     continue;
                 }
 
-                std::vector<std::string> new_orders;
-                for (int i = 0; i < 2; ++i) {
-                    OrderRequest req;
-                    req.account_id = account_id_;
-                    req.symbol = symbol;
-                    req.side = OrderSide::Sell;
-                    req.price = sell_price;
-                    req.volume = split_vol;
-                    req.is_market = true;
-                    req.remark = std::string(kStrategyName) + "_zb_sell_" + symbol;
-                    std::string order_id = ctx.trading->place_order(req);
-                    if (!order_id.empty()) {
-                        new_orders.push_back(order_id);
-                    }
-                }
-
-                if (!new_orders.empty()) {
-                    std::lock_guard<std::mutex> lock(mutex_);
-                    states_[symbol].zhaban = 1;
-                    auto& orders = sell_orders_[symbol];
-                    orders.insert(new_orders.begin(), new_orders.end());
-                }
+                fire_split_sells(ctx, symbol, id, sell_price, split_vol, 2, true, pending_sells);
             }
         } else if (state.zhaban == 1 && state.sold_out != 1) {
+            if (!periodic) {
+                continue;
+            }
             if (pos.available > hold_vol_) {
                 int64_t vol = calc_sell_volume(pos, hold_vol_);
                 int64_t split_vol = (vol / 100 / 2) * 100;
@@ -223,31 +255,12 @@ void Qh2hSellModule::tick(AppContext& ctx) {
                     continue;
                 }
 
-                double sell_price = resolve_sell_price(ctx, symbol);
+                double sell_price = resolve_sell_price(ctx, id);
                 if (sell_price <= 0.0) {
                     continue;
                 }
 
-                std::vector<std::string> new_orders;
-                for (int i = 0; i < 2; ++i) {
-                    OrderRequest req;
-                    req.account_id = account_id_;
-                    req.symbol = symbol;
-                    req.side = OrderSide::Sell;
-                    req.price = sell_price;
-                    req.volume = split_vol;
-                    req.is_market = true;
-                    req.remark = std::string(kStrategyName) + "_zb_sell_" + symbol;
-                    std::string order_id = ctx.trading->place_order(req);
-                    if (!order_id.empty()) {
-                        new_orders.push_back(order_id);
-                    }
-                }
-                if (!new_orders.empty()) {
-                    std::lock_guard<std::mutex> lock(mutex_);
-                    auto& orders = sell_orders_[symbol];
-                    orders.insert(new_orders.begin(), new_orders.end());
-                }
+                fire_split_sells(ctx, symbol, id, sell_price, split_vol, 2, false, pending_sells);
             } else {
                 std::vector<std::string> to_cancel;
                 {
@@ -257,18 +270,27 @@ void Qh2hSellModule::tick(AppContext& ctx) {
                         to_cancel.assign(it->second.begin(), it->second.end());
                     }
                 }
-                for (const auto& order_id : to_cancel) {
-                    OrderResult ord = ctx.trading_raw->query_order(order_id);
-                    if (!ord.success) {
-                        continue;
+                // 读本地订单簿中该证券的活动订单，不支持时退回一次按证券过滤的委托查询
+                std::vector<std::string> live_ids;
+                if (!to_cancel.empty()) {
+                    std::unordered_set<std::string> wanted(to_cancel.begin(), to_cancel.end());
+                    std::vector<OrderResult> orders;
+                    if (!ctx.trading->query_live_orders_local(id, orders)) {
+                        orders = ctx.trading->query_orders(symbol);
                     }
-                    if (ord.status == OrderResult::Status::FILLED ||
-                        ord.status == OrderResult::Status::CANCELLED ||
-                        ord.status == OrderResult::Status::REJECTED) {
-                        continue;
+                    for (const auto& ord : orders) {
+                        if (!wanted.count(ord.order_id)) {
+                            continue;
+                        }
+                        if (ord.status == OrderResult::Status::FILLED ||
+                            ord.status == OrderResult::Status::CANCELLED ||
+                            ord.status == OrderResult::Status::REJECTED) {
+                            continue;
+                        }
+                        live_ids.push_back(ord.order_id);
                     }
-                    ctx.trading->cancel_order(order_id);
                 }
+                ctx.trading->cancel_orders(live_ids);
 
                 auto refreshed = ctx.trading->query_positions();
                 Position updated;
@@ -288,31 +310,12 @@ void Qh2hSellModule::tick(AppContext& ctx) {
                         continue;
                     }
 
-                    double sell_price = resolve_sell_price(ctx, symbol);
+                    double sell_price = resolve_sell_price(ctx, id);
                     if (sell_price <= 0.0) {
                         continue;
                     }
 
-                    std::vector<std::string> new_orders;
-                    for (int i = 0; i < 2; ++i) {
-                        OrderRequest req;
-                        req.account_id = account_id_;
-                        req.symbol = symbol;
-                        req.side = OrderSide::Sell;
-                        req.price = sell_price;
-                        req.volume = split_vol;
-                        req.is_market = true;
-                        req.remark = std::string(kStrategyName) + "_zb_sell_" + symbol;
-                        std::string order_id = ctx.trading->place_order(req);
-                        if (!order_id.empty()) {
-                            new_orders.push_back(order_id);
-                        }
-                    }
-                    if (!new_orders.empty()) {
-                        std::lock_guard<std::mutex> lock(mutex_);
-                        auto& orders = sell_orders_[symbol];
-                        orders.insert(new_orders.begin(), new_orders.end());
-                    }
+                    fire_split_sells(ctx, symbol, id, sell_price, split_vol, 2, false, pending_sells);
                 } else {
                     std::lock_guard<std::mutex> lock(mutex_);
                     states_[symbol].sold_out = 1;
@@ -320,6 +323,15 @@ void Qh2hSellModule::tick(AppContext& ctx) {
             }
         }
     }
+    collect_sells(pending_sells);
+}
+
+void Qh2hSellModule::wait_next_tick(AppContext& ctx, std::chrono::steady_clock::time_point deadline) {
+    if (!updates_) {
+        IModule::wait_next_tick(ctx, deadline);
+        return;
+    }
+    updates_->wait_until(deadline);
 }
 
 void Qh2hSellModule::on_order_event(AppContext& ctx, const OrderResult& result, int notify_type) {
@@ -331,6 +343,7 @@ void Qh2hSellModule::on_order_event(AppContext& ctx, const OrderResult& result,
     }
 
     std::string symbol;
+    InstrumentId id = kInvalidInstrument;
     double zt = 0.0;
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -343,22 +356,22 @@ void Qh2hSellModule::on_order_event(AppContext& ctx, const OrderResult& result,
         if (st_it != states_.end() && st_it->second.zhaban == 1) {
             return;
         }
-        auto zt_it = zt_cache_.find(symbol);
-        if (zt_it != zt_cache_.end()) {
-            zt = zt_it->second;
+        id = InstrumentRegistry::instance().find(symbol);
+        if (const double* cached = zt_cache_.find(id)) {
+            zt = *cached;
         }
     }
-    if (symbol.empty()) {
+    if (symbol.empty() || id == kInvalidInstrument) {
         return;
     }
 
     if (zt <= 0.0) {
-        zt = resolve_zt_price(ctx, symbol);
+        zt = resolve_zt_price(ctx, id);
         if (zt <= 0.0) {
             return;
         }
         std::lock_guard<std::mutex> lock(mutex_);
-        zt_cache_[symbol] = zt;
+        zt_cache_[id] = zt;
     }
 
     double match_price = result.last_fill_price > 0.0 ? result.last_fill_price : result.filled_price;
@@ -393,33 +406,15 @@ void Qh2hSellModule::on_order_event(AppContext& ctx, const OrderResult& result,
         return;
     }
 
-    double sell_price = resolve_sell_price(ctx, symbol);
+    double sell_price = resolve_sell_price(ctx, id);
     if (sell_price <= 0.0) {
         return;
     }
 
-    std::vector<std::string> new_orders;
-    for (int i = 0; i < 10; ++i) {
-        OrderRequest req;
-        req.account_id = account_id_;
-        req.symbol = symbol;
-        req.side = OrderSide::Sell;
-        req.price = sell_price;
-        req.volume = split_vol;
-        req.is_market = true;
-        req.remark = std::string(kStrategyName) + "_zb_sell_" + symbol;
-        std::string order_id = ctx.trading->place_order(req);
-        if (!order_id.empty()) {
-            new_orders.push_back(order_id);
-        }
-    }
-
-    if (!new_orders.empty()) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        states_[symbol].zhaban = 1;
-        auto& orders = sell_orders_[symbol];
-        orders.insert(new_orders.begin(), new_orders.end());
-    }
+    // 10 笔拆单一次性发出，再统一取回委托号
+    std::vector<PendingSell> pending;
+    fire_split_sells(ctx, symbol, id, sell_price, split_vol, 10, true, pending);
+    collect_sells(pending);
 }
 
 int Qh2hSellModule::current_hhmmss() {
@@ -488,7 +483,7 @@ void Qh2hSellModule::refresh_positions(AppContext& ctx) {
     auto refreshed = ctx.trading->query_positions();
     std::lock_guard<std::mutex> lock(mutex_);
     pos_map_ = build_position_map(refreshed);
-    symbols_ = build_symbol_list(refreshed);
+    set_symbols(build_symbol_list(refreshed));
     states_.clear();
     for (const auto& symbol : symbols_) {
         states_[symbol] = StockState();
@@ -523,32 +518,90 @@ std::unordered_map<std::string, Position> Qh2hSellModule::build_position_map(con
     return map;
 }
 
-double Qh2hSellModule::resolve_sell_price(AppContext& ctx, const std::string& symbol) {
+void Qh2hSellModule::set_symbols(std::vector<std::string> symbols) {
+    // 调用方持有 mutex_
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    symbols_.clear();
+    symbol_ids_.clear();
+    for (auto& symbol : symbols) {
+        InstrumentId id = registry.intern(symbol);
+        if (id == kInvalidInstrument) {
+            continue;
+        }
+        symbols_.push_back(std::move(symbol));
+        symbol_ids_.push_back(id);
+    }
+    if (updates_) {
+        updates_->unwatch_all();
+        for (InstrumentId id : symbol_ids_) {
+            updates_->watch(id);
+        }
+    }
+}
+
+double Qh2hSellModule::resolve_sell_price(AppContext& ctx, InstrumentId id) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = dt_cache_.find(symbol);
-        if (it != dt_cache_.end()) {
-            return it->second;
+        if (const double* cached = dt_cache_.find(id)) {
+            return *cached;
         }
     }
     std::pair<double, double> limits;
     {
         std::lock_guard<std::mutex> lock(ctx.market_mutex);
-        limits = ctx.market->get_limits(symbol);
+        limits = ctx.market->get_limits(id);
     }
     double dt = round_price(limits.second);
-    if (dt > 0.0) {
+    if (dt > 0.0 && id != kInvalidInstrument) {
         std::lock_guard<std::mutex> lock(mutex_);
-        dt_cache_[symbol] = dt;
+        dt_cache_[id] = dt;
     }
     return dt;
 }
 
-double Qh2hSellModule::resolve_zt_price(AppContext& ctx, const std::string& symbol) {
+void Qh2hSellModule::fire_split_sells(AppContext& ctx, const std::string& symbol, InstrumentId id,
+                                      double price, int64_t split_vol, int count, bool mark_zhaban,
+                                      std::vector<PendingSell>& pending) {
+    // 各笔拆单只有标签序号不同，备注只拼接一次
+    OrderRequest req;
+    req.account_id = account_id_;
+    req.symbol = symbol;
+    req.instrument = id;
+    req.side = OrderSide::Sell;
+    req.price = price;
+    req.volume = split_vol;
+    req.is_market = true;
+    req.remark = std::string(kStrategyName) + "_zb_sell_" + symbol;
+    for (int i = 0; i < count; ++i) {
+        req.tag = next_order_tag(StrategyIds::kQh2hSell, id);
+        PendingSell sell;
+        sell.symbol = symbol;
+        sell.order_id = ctx.trading->place_order_async(req);
+        sell.mark_zhaban = mark_zhaban;
+        pending.push_back(std::move(sell));
+    }
+}
+
+void Qh2hSellModule::collect_sells(std::vector<PendingSell>& pending) {
+    for (auto& sell : pending) {
+        std::string order_id = sell.order_id.get();
+        if (order_id.empty()) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sell.mark_zhaban) {
+            states_[sell.symbol].zhaban = 1;
+        }
+        sell_orders_[sell.symbol].insert(order_id);
+    }
+    pending.clear();
+}
+
+double Qh2hSellModule::resolve_zt_price(AppContext& ctx, InstrumentId id) {
     std::pair<double, double> limits;
     {
         std::lock_guard<std::mutex> lock(ctx.market_mutex);
-        limits = ctx.market->get_limits(symbol);
+        limits = ctx.market->get_limits(id);
     }
     return round_price(limits.first);
 }
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "IModule.h"
+#include "../core/InstrumentRegistry.h"
 #include "../core/MarketData.h"
+#include "../core/MarketUpdateQueue.h"
 
 #include <chrono>
+#include <future>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -27,6 +30,7 @@ public:
     bool init(AppContext& ctx) override;
     void tick(AppContext& ctx) override;
     void on_order_event(AppContext& ctx, const OrderResult& result, int notify_type) override;
+    void wait_next_tick(AppContext& ctx, std::chrono::steady_clock::time_point deadline) override;
 
 private:
     struct StockState {
@@ -35,6 +39,13 @@ private:
         int sold_out = 0;
     };
 
+    /// @brief 已发出、尚未取回委托号的拆单卖出
+    struct PendingSell {
+        std::string symbol;
+        std::future<std::string> order_id;
+        bool mark_zhaban = false;   // 成功后置炸板标志
+    };
+
     static int current_hhmmss();
     static bool time_in_range(int now, int start, int end);
     static std::string extract_code_from_symbol(const std::string& symbol);
@@ -48,8 +59,12 @@ private:
     void refresh_positions(AppContext& ctx);
     std::vector<std::string> build_symbol_list(const std::vector<Position>& positions) const;
     std::unordered_map<std::string, Position> build_position_map(const std::vector<Position>& positions) const;
-    double resolve_sell_price(AppContext& ctx, const std::string& symbol);
-    double resolve_zt_price(AppContext& ctx, const std::string& symbol);
+    void set_symbols(std::vector<std::string> symbols);
+    double resolve_sell_price(AppContext& ctx, InstrumentId id);
+    double resolve_zt_price(AppContext& ctx, InstrumentId id);
+    void fire_split_sells(AppContext& ctx, const std::string& symbol, InstrumentId id, double price,
+                          int64_t split_vol, int count, bool mark_zhaban, std::vector<PendingSell>& pending);
+    void collect_sells(std::vector<PendingSell>& pending);
 
     std::string account_id_;
     int hold_vol_ = 300;
@@ -65,11 +80,19 @@ private:
     std::chrono::steady_clock::time_point last_pos_refresh_{};
 
     std::vector<std::string> symbols_;
+    std::vector<InstrumentId> symbol_ids_;  // 与 symbols_ 一一对应
     std::unordered_map<std::string, StockState> states_;
     std::unordered_map<std::string, Position> pos_map_;
 
-    std::unordered_map<std::string, double> zt_cache_;
-    std::unordered_map<std::string, double> dt_cache_;
+    // 行情推送（仅 tick 线程访问 pending_updates_/updated_/next_*）
+    std::shared_ptr<MarketUpdateQueue> updates_;
+    std::vector<MarketUpdate> pending_updates_;
+    InstrumentMap<uint8_t> updated_;
+    std::chrono::steady_clock::time_point next_periodic_{};
+    std::chrono::steady_clock::time_point next_sweep_{};
+
+    InstrumentMap<double> zt_cache_;
+    InstrumentMap<double> dt_cache_;
 
     std::unordered_map<std::string, std::string> pair_buy_orders_; // order_id -> symbol
     std::unordered_map<std::string, std::unordered_set<std::string>> sell_orders_; // symbol -> order_ids
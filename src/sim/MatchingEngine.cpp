@@ -0,0 +1,414 @@
+#include "MatchingEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+MatchingEngine::Event make_fill(uint64_t id, int64_t price, int64_t qty, int64_t leaves) {
+    MatchingEngine::Event ev;
+    ev.kind = MatchingEngine::Event::Kind::FILL;
+    ev.order_id = id;
+    ev.price = price;
+    ev.qty = qty;
+    ev.leaves = leaves;
+    return ev;
+}
+
+MatchingEngine::Event make_cancel(uint64_t id, int64_t qty) {
+    MatchingEngine::Event ev;
+    ev.kind = MatchingEngine::Event::Kind::CANCEL;
+    ev.order_id = id;
+    ev.qty = qty;
+    return ev;
+}
+
+OrderSide contra_of(OrderSide side) {
+    return side == OrderSide::Buy ? OrderSide::Sell : OrderSide::Buy;
+}
+
+int64_t price_of(OrderSide side, int64_t key) {
+    return side == OrderSide::Buy ? -key : key;
+}
+
+}  // namespace
+
+MatchingEngine::Phase MatchingEngine::phase_at(int timestamp) {
+    if (timestamp < 91500000) return Phase::HALT;
+    if (timestamp < 92500000) return Phase::CALL_AUCTION;
+    if (timestamp < 93000000) return Phase::HALT;
+    if (timestamp < 113000000) return Phase::CONTINUOUS;
+    if (timestamp < 130000000) return Phase::HALT;
+    if (timestamp < 145700000) return Phase::CONTINUOUS;
+    if (timestamp < 150000000) return Phase::CALL_AUCTION;
+    return Phase::HALT;
+}
+
+bool MatchingEngine::add(uint64_t order_id, InstrumentId instrument, OrderSide side, int64_t price,
+                         int64_t volume, bool is_market, std::vector<Event>& events) {
+    if (instrument == kInvalidInstrument || volume <= 0 || (!is_market && price <= 0) ||
+        index_.count(order_id) != 0) {
+        return false;
+    }
+    Book& book = books_[instrument];
+    if (is_market) {
+        // 市价委托：对手盘成交后剩余部分撤销
+        if (book.phase != Phase::CONTINUOUS) {
+            return false;
+        }
+        int64_t leaves = take(book, order_id, side, 0, true, volume, events);
+        if (leaves > 0) {
+            events.push_back(make_cancel(order_id, leaves));
+        }
+        return true;
+    }
+
+    int64_t leaves = volume;
+    if (book.phase == Phase::CONTINUOUS) {
+        leaves = take(book, order_id, side, price, false, leaves, events);
+    }
+    if (leaves > 0) {
+        rest(book, instrument, order_id, side, price, leaves);
+    }
+    return true;
+}
+
+bool MatchingEngine::cancel(uint64_t order_id, std::vector<Event>& events) {
+    auto it = index_.find(order_id);
+    if (it == index_.end()) {
+        return false;
+    }
+    Locator loc = it->second;
+    Book* book = books_.find(loc.instrument);
+    if (!book) {
+        index_.erase(it);
+        return false;
+    }
+    Side& side = own_side(*book, loc.side);
+    auto level = side.find(loc.key);
+    if (level != side.end()) {
+        for (auto r = level->second.begin(); r != level->second.end(); ++r) {
+            if (r->id != order_id) {
+                continue;
+            }
+            events.push_back(make_cancel(order_id, r->leaves));
+            level->second.erase(r);
+            if (level->second.empty()) {
+                side.erase(level);
+            }
+            index_.erase(order_id);
+            return true;
+        }
+    }
+    index_.erase(order_id);
+    return false;
+}
+
+void MatchingEngine::on_snapshot(const MarketSnapshot& snap, std::vector<Event>& events) {
+    if (!snap.valid || snap.instrument == kInvalidInstrument) {
+        return;
+    }
+    Book& book = books_[snap.instrument];
+    if (book.has_snapshot && (snap.timestamp < book.timestamp ||
+                              (snap.timestamp == book.timestamp && snap.volume == book.volume))) {
+        return;  // 乱序或重复到达的快照（重复刷新会恢复已被主动成交扣减的盘口量）
+    }
+
+    Phase prev = book.phase;
+    Phase phase = phase_at(snap.timestamp);
+    int64_t traded = book.has_snapshot ? snap.volume - book.volume : 0;
+    int64_t last_px = static_cast<int64_t>(std::llround(snap.last_price * kPriceScale));
+
+    for (int i = 0; i < kDepthLevels; ++i) {
+        book.ext_bids[i].price = snap.bid_px[i];
+        book.ext_bids[i].qty = snap.bid_qty[i];
+        book.ext_asks[i].price = snap.ask_px[i];
+        book.ext_asks[i].qty = snap.ask_qty[i];
+    }
+    book.phase = phase;
+    book.timestamp = snap.timestamp;
+    book.volume = snap.volume;
+    book.has_snapshot = true;
+
+    if (prev == Phase::CALL_AUCTION && phase != Phase::CALL_AUCTION) {
+        // 集合竞价结束后的第一笔快照：最新价即竞价成交价，成交量增量即竞价成交量
+        uncross(book, last_px, std::max<int64_t>(traded, 0), events);
+    } else if (phase == Phase::CONTINUOUS) {
+        if (prev != Phase::CONTINUOUS) {
+            cross_resting(book, events);
+        }
+        match_passive(book, OrderSide::Sell, last_px, traded, events);
+        match_passive(book, OrderSide::Buy, last_px, traded, events);
+    }
+}
+
+bool MatchingEngine::has_resting(InstrumentId instrument) const {
+    const Book* book = books_.find(instrument);
+    return book && (!book->bids.empty() || !book->asks.empty());
+}
+
+int64_t MatchingEngine::take(Book& book, uint64_t id, OrderSide side, int64_t limit, bool is_market,
+                             int64_t leaves, std::vector<Event>& events) {
+    OrderSide contra = contra_of(side);
+    Side& opp = opposite_side(book, side);
+    ExternalLevel* ext = external_side(book, contra);
+
+    while (leaves > 0) {
+        ExternalLevel* best_ext = nullptr;
+        for (int i = 0; i < kDepthLevels; ++i) {
+            if (ext[i].price > 0 && ext[i].qty > 0) {
+                best_ext = &ext[i];
+                break;
+            }
+        }
+        auto best_own = opp.begin();
+        bool has_own = best_own != opp.end();
+        if (!best_ext && !has_own) {
+            break;
+        }
+        int64_t own_price = has_own ? price_of(contra, best_own->first) : 0;
+        // 同价位时盘口上的外部委托先于模拟挂单
+        bool use_ext = best_ext && (!has_own || at_least(contra, best_ext->price, own_price));
+        int64_t price = use_ext ? best_ext->price : own_price;
+        if (!is_market && !at_least(side, limit, price)) {
+            break;
+        }
+
+        if (use_ext) {
+            int64_t qty = std::min(leaves, best_ext->qty);
+            best_ext->qty -= qty;
+            leaves -= qty;
+            events.push_back(make_fill(id, price, qty, leaves));
+        } else {
+            Resting& maker = best_own->second.front();
+            int64_t qty = std::min(leaves, maker.leaves);
+            leaves -= qty;
+            events.push_back(make_fill(id, price, qty, leaves));
+            fill_resting(maker, price, qty, events);
+            drop_filled_front(opp, best_own);
+        }
+    }
+    return leaves;
+}
+
+void MatchingEngine::rest(Book& book, InstrumentId instrument, uint64_t id, OrderSide side, int64_t price,
+                          int64_t leaves) {
+    Resting r;
+    r.id = id;
+    r.price = price;
+    r.leaves = leaves;
+    // 同价位盘口上已有的外部委托排在前面
+    const ExternalLevel* same = external_side(book, side);
+    for (int i = 0; i < kDepthLevels; ++i) {
+        if (same[i].price == price) {
+            r.queue_ahead = same[i].qty;
+            break;
+        }
+    }
+
+    int64_t key = key_of(side, price);
+    own_side(book, side)[key].push_back(r);
+    Locator loc;
+    loc.instrument = instrument;
+    loc.side = side;
+    loc.key = key;
+    index_[id] = loc;
+}
+
+void MatchingEngine::fill_resting(Resting& r, int64_t price, int64_t qty, std::vector<Event>& events) {
+    r.leaves -= qty;
+    events.push_back(make_fill(r.id, price, qty, r.leaves));
+}
+
+void MatchingEngine::drop_filled_front(Side& side, Side::iterator level) {
+    if (level->second.front().leaves > 0) {
+        return;
+    }
+    index_.erase(level->second.front().id);
+    level->second.pop_front();
+    if (level->second.empty()) {
+        side.erase(level);
+    }
+}
+
+void MatchingEngine::prune(Side& side) {
+    for (auto level = side.begin(); level != side.end();) {
+        Level& queue = level->second;
+        for (auto r = queue.begin(); r != queue.end();) {
+            if (r->leaves > 0) {
+                ++r;
+                continue;
+            }
+            index_.erase(r->id);
+            r = queue.erase(r);
+        }
+        level = queue.empty() ? side.erase(level) : std::next(level);
+    }
+}
+
+void MatchingEngine::cross_resting(Book& book, std::vector<Event>& events) {
+    while (!book.bids.empty() && !book.asks.empty()) {
+        auto bid = book.bids.begin();
+        auto ask = book.asks.begin();
+        if (price_of(OrderSide::Buy, bid->first) < ask->first) {
+            break;
+        }
+        Resting& b = bid->second.front();
+        Resting& a = ask->second.front();
+        // 先进入订单簿的一方为挂单方，按其价格成交
+        int64_t price = b.id < a.id ? b.price : a.price;
+        int64_t qty = std::min(b.leaves, a.leaves);
+        fill_resting(b, price, qty, events);
+        fill_resting(a, price, qty, events);
+        drop_filled_front(book.bids, bid);
+        drop_filled_front(book.asks, ask);
+    }
+}
+
+void MatchingEngine::match_passive(Book& book, OrderSide side, int64_t trade_price, int64_t traded,
+                                   std::vector<Event>& events) {
+    Side& own = own_side(book, side);
+    if (own.empty()) {
+        return;
+    }
+    ExternalLevel* contra = external_side(book, contra_of(side));
+    const ExternalLevel* same = external_side(book, side);
+    int64_t budget = (traded > 0 && trade_price > 0) ? traded : 0;
+
+    for (auto level = own.begin(); level != own.end(); ++level) {
+        int64_t price = price_of(side, level->first);
+
+        // 成交量增量：价格优于成交价的挂单已被穿过；同价位先消耗排在前面的外部委托
+        if (budget > 0 && at_least(side, price, trade_price)) {
+            bool at_trade = price == trade_price;
+            int64_t before = 0;   // 本价位排在前面的模拟委托量
+            int64_t filled = 0;
+            for (Resting& r : level->second) {
+                int64_t ahead = before + (at_trade ? r.queue_ahead : 0);
+                int64_t qty = std::min(r.leaves, std::max<int64_t>(0, budget - ahead));
+                before += r.leaves;
+                if (at_trade) {
+                    r.queue_ahead = std::max<int64_t>(0, r.queue_ahead - budget);
+                }
+                if (qty > 0) {
+                    fill_resting(r, price, qty, events);
+                    filled += qty;
+                }
+            }
+            budget -= filled;
+        }
+
+        for (Resting& r : level->second) {
+            // 对手盘价格穿过挂单价：按挂单价成交
+            for (int i = 0; i < kDepthLevels && r.leaves > 0; ++i) {
+                if (contra[i].price <= 0 || contra[i].qty <= 0) {
+                    continue;
+                }
+                if (!at_least(side, price, contra[i].price)) {
+                    break;
+                }
+                int64_t qty = std::min(r.leaves, contra[i].qty);
+                contra[i].qty -= qty;
+                fill_resting(r, price, qty, events);
+            }
+            // 排在前面的外部委托撤单时队列位置前移
+            for (int i = 0; i < kDepthLevels && r.leaves > 0; ++i) {
+                if (same[i].price == price) {
+                    r.queue_ahead = std::min(r.queue_ahead, same[i].qty);
+                    break;
+                }
+            }
+        }
+    }
+    prune(own);
+}
+
+void MatchingEngine::uncross(Book& book, int64_t price, int64_t volume, std::vector<Event>& events) {
+    if (price <= 0) {
+        price = equilibrium_price(book);
+    }
+    if (price <= 0) {
+        return;
+    }
+
+    // 可成交的模拟委托之间先按价格时间优先成交
+    while (!book.bids.empty() && !book.asks.empty()) {
+        auto bid = book.bids.begin();
+        auto ask = book.asks.begin();
+        if (price_of(OrderSide::Buy, bid->first) < price || ask->first > price) {
+            break;
+        }
+        Resting& b = bid->second.front();
+        Resting& a = ask->second.front();
+        int64_t qty = std::min(b.leaves, a.leaves);
+        fill_resting(b, price, qty, events);
+        fill_resting(a, price, qty, events);
+        drop_filled_front(book.bids, bid);
+        drop_filled_front(book.asks, ask);
+    }
+
+    // 剩余部分与外部委托成交，每侧以竞价成交量为上限
+    static const OrderSide kSides[] = {OrderSide::Buy, OrderSide::Sell};
+    for (OrderSide side : kSides) {
+        Side& own = own_side(book, side);
+        int64_t budget = volume;
+        for (auto level = own.begin(); level != own.end() && budget > 0; ++level) {
+            if (!at_least(side, price_of(side, level->first), price)) {
+                break;
+            }
+            for (Resting& r : level->second) {
+                int64_t qty = std::min(budget, r.leaves);
+                if (qty <= 0) {
+                    break;
+                }
+                fill_resting(r, price, qty, events);
+                budget -= qty;
+            }
+        }
+        prune(own);
+    }
+}
+
+int64_t MatchingEngine::equilibrium_price(const Book& book) {
+    std::vector<int64_t> candidates;
+    for (const auto& level : book.bids) {
+        candidates.push_back(price_of(OrderSide::Buy, level.first));
+    }
+    for (const auto& level : book.asks) {
+        candidates.push_back(level.first);
+    }
+
+    int64_t best_price = 0;
+    int64_t best_volume = 0;
+    int64_t best_imbalance = 0;
+    for (int64_t p : candidates) {
+        int64_t demand = 0;
+        int64_t supply = 0;
+        for (const auto& level : book.bids) {
+            if (price_of(OrderSide::Buy, level.first) < p) {
+                break;
+            }
+            for (const Resting& r : level.second) {
+                demand += r.leaves;
+            }
+        }
+        for (const auto& level : book.asks) {
+            if (level.first > p) {
+                break;
+            }
+            for (const Resting& r : level.second) {
+                supply += r.leaves;
+            }
+        }
+        // 最大成交量优先，其次最小未成交量
+        int64_t volume = std::min(demand, supply);
+        int64_t imbalance = std::abs(demand - supply);
+        if (volume > best_volume || (volume == best_volume && volume > 0 && imbalance < best_imbalance)) {
+            best_price = p;
+            best_volume = volume;
+            best_imbalance = imbalance;
+        }
+    }
+    return best_price;
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include "InstrumentRegistry.h"
+#include "MarketData.h"
+#include "Order.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/// @brief 模拟撮合引擎：价格优先、时间优先，支持连续竞价与集合竞价
+///
+/// 对手方有两类：
+/// - 行情盘口（外部流动性）：每次快照刷新十档，本引擎主动成交的量在下一次快照前从对应档位扣减；
+/// - 其他模拟委托：同一证券的模拟买卖单之间按价格时间优先互相撮合。
+///
+/// 被动挂单按可见排队量估计队列位置：挂单时排在同价位已有委托之后，
+/// 之后快照的成交量增量先消耗排在前面的量，再按时间顺序成交模拟委托；
+/// 对手盘口价格穿过挂单价时按挂单价成交。
+///
+/// 交易阶段按快照时间戳（HHMMSSmmm）判断，集合竞价结束后的第一笔快照触发集中撮合：
+/// 成交价取该快照的最新价（行情无成交价时按模拟委托自身求最大成交量价格），
+/// 可成交的模拟委托先互相成交，剩余部分以集合竞价成交量为上限按价格时间优先成交。
+///
+/// 本类不加锁，由调用方保证互斥；价格均为定点整数（元 × kPriceScale）。
+class MatchingEngine {
+public:
+    /// @brief 交易阶段
+    enum class Phase {
+        HALT = 0,         // 不撮合，委托挂入订单簿等待（开盘前、9:25-9:30、午休、收盘后）
+        CALL_AUCTION = 1, // 集合竞价（9:15-9:25、14:57-15:00）
+        CONTINUOUS = 2    // 连续竞价
+    };
+
+    /// @brief 撮合结果
+    struct Event {
+        enum class Kind { FILL, CANCEL };
+        Kind kind = Kind::FILL;
+        uint64_t order_id = 0;
+        int64_t price = 0;    // 成交价（定点）；CANCEL 时为 0
+        int64_t qty = 0;      // 本次成交量；CANCEL 时为撤销的剩余量
+        int64_t leaves = 0;   // 事件之后的剩余未成交量
+    };
+
+    /// @brief 时间戳对应的交易阶段
+    static Phase phase_at(int timestamp);
+
+    /// @brief 新委托；连续竞价阶段立即撮合，其余阶段挂入订单簿
+    ///
+    /// 市价委托只在连续竞价阶段接受，按可见对手盘成交后剩余部分立即撤销（CANCEL 事件）。
+    /// @return 拒单（数量/价格非法、ID 重复、非连续竞价阶段的市价单）时返回 false
+    bool add(uint64_t order_id, InstrumentId instrument, OrderSide side, int64_t price,
+             int64_t volume, bool is_market, std::vector<Event>& events);
+
+    /// @brief 撤单；成功时产生 CANCEL 事件
+    /// @return 订单不在订单簿中（已成交/已撤/未知）时返回 false
+    bool cancel(uint64_t order_id, std::vector<Event>& events);
+
+    /// @brief 行情快照：刷新盘口、推进交易阶段并撮合被动挂单；旧快照和重复快照被忽略
+    void on_snapshot(const MarketSnapshot& snap, std::vector<Event>& events);
+
+    /// @brief 订单簿中的模拟委托数
+    size_t resting() const { return index_.size(); }
+
+    /// @brief 某证券是否有挂单
+    bool has_resting(InstrumentId instrument) const;
+
+private:
+    struct Resting {
+        uint64_t id = 0;
+        int64_t price = 0;
+        int64_t leaves = 0;
+        int64_t queue_ahead = 0;   // 估计排在前面的外部委托量
+    };
+
+    /// 买卖两侧统一用“越小越优先”的键：卖方为价格，买方为价格取负
+    using Level = std::deque<Resting>;
+    using Side = std::map<int64_t, Level>;
+
+    /// 外部盘口一档（快照刷新，主动成交时扣减）
+    struct ExternalLevel {
+        int64_t price = 0;
+        int64_t qty = 0;
+    };
+
+    struct Book {
+        Side bids;
+        Side asks;
+        ExternalLevel ext_bids[kDepthLevels];
+        ExternalLevel ext_asks[kDepthLevels];
+        Phase phase = Phase::CONTINUOUS;   // 尚无行情时按连续竞价处理
+        int timestamp = 0;
+        int64_t volume = 0;                // 上一笔快照的累计成交量
+        bool has_snapshot = false;
+    };
+
+    struct Locator {
+        InstrumentId instrument = kInvalidInstrument;
+        OrderSide side = OrderSide::Sell;
+        int64_t key = 0;
+    };
+
+    static int64_t key_of(OrderSide side, int64_t price) {
+        return side == OrderSide::Buy ? -price : price;
+    }
+
+    /// 价格 a 对 side 方向的委托是否不劣于 b（买方越高越好，卖方越低越好）
+    static bool at_least(OrderSide side, int64_t a, int64_t b) {
+        return side == OrderSide::Buy ? a >= b : a <= b;
+    }
+
+    static Side& own_side(Book& book, OrderSide side) {
+        return side == OrderSide::Buy ? book.bids : book.asks;
+    }
+    static Side& opposite_side(Book& book, OrderSide side) {
+        return side == OrderSide::Buy ? book.asks : book.bids;
+    }
+    static ExternalLevel* external_side(Book& book, OrderSide side) {
+        return side == OrderSide::Buy ? book.ext_bids : book.ext_asks;
+    }
+
+    /// 主动委托与对手方（外部盘口 + 模拟挂单）撮合，返回剩余量
+    int64_t take(Book& book, uint64_t id, OrderSide side, int64_t limit, bool is_market,
+                 int64_t leaves, std::vector<Event>& events);
+
+    /// 挂入订单簿，按当前盘口估计队列位置
+    void rest(Book& book, InstrumentId instrument, uint64_t id, OrderSide side, int64_t price,
+              int64_t leaves);
+
+    /// 成交一笔模拟挂单（只记账，移出订单簿由 drop_filled_front / prune 完成）
+    static void fill_resting(Resting& r, int64_t price, int64_t qty, std::vector<Event>& events);
+
+    /// 价位队首已完全成交时移出订单簿（空价位一并删除）
+    void drop_filled_front(Side& side, Side::iterator level);
+
+    /// 移出一侧全部已完全成交的挂单
+    void prune(Side& side);
+
+    /// 模拟买卖挂单之间的交叉撮合（进入连续竞价时）
+    void cross_resting(Book& book, std::vector<Event>& events);
+
+    /// 快照成交量增量与穿价盘口对被动挂单的撮合
+    void match_passive(Book& book, OrderSide side, int64_t trade_price, int64_t trade_qty,
+                       std::vector<Event>& events);
+
+    /// 集合竞价集中撮合
+    void uncross(Book& book, int64_t price, int64_t volume, std::vector<Event>& events);
+
+    /// 仅按模拟委托求最大成交量价格；无可成交时返回 0
+    static int64_t equilibrium_price(const Book& book);
+
+    InstrumentMap<Book> books_;
+    std::unordered_map<uint64_t, Locator> index_;
+};
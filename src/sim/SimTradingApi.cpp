@@ -0,0 +1,472 @@
+#include "SimTradingApi.h"
+
+#include "InstrumentRegistry.h"
+#include "itpdk/itpdk_dict.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// 行情更新检查周期（无待执行事件时的最长等待）
+const std::chrono::milliseconds kMarketPollInterval(1);
+
+std::string trim_field(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\"");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r\"");
+    return s.substr(begin, end - begin + 1);
+}
+
+}  // namespace
+
+SimTradingApi::SimTradingApi() = default;
+
+SimTradingApi::~SimTradingApi() {
+    disconnect();
+    if (market_ && updates_) {
+        market_->unsubscribe_updates(updates_);
+    }
+}
+
+bool SimTradingApi::connect(const std::string& host, int port,
+                            const std::string& user, const std::string& password) {
+    (void)host;
+    (void)port;
+    (void)password;
+    std::lock_guard<std::mutex> lock(mutex_);
+    account_ = user;
+    if (running_) {
+        return true;
+    }
+    stopping_ = false;
+    running_ = true;
+    worker_ = std::thread([this]() { run(); });
+    std::cout << "[SIM] 模拟撮合已启动 ack_us=" << ack_latency_.count()
+              << " fill_us=" << fill_latency_.count() << std::endl;
+    return true;
+}
+
+void SimTradingApi::disconnect() {
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        stopping_ = true;
+        worker = std::move(worker_);
+    }
+    cv_.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool SimTradingApi::is_connected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+std::string SimTradingApi::place_order(const OrderRequest& req) {
+    InstrumentId instrument = req.instrument != kInvalidInstrument
+        ? req.instrument : InstrumentRegistry::instance().intern(req.symbol);
+    int side = req.side == OrderSide::Buy ? 0 : 1;
+    int64_t price = req.is_market ? 0 : static_cast<int64_t>(std::llround(req.price * kPriceScale));
+
+    std::string order_id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || instrument == kInvalidInstrument || req.volume <= 0 || (!req.is_market && price <= 0)) {
+            ++stats_.rejects;
+            std::cerr << "[SIM] 委托参数非法: " << req.symbol << " price=" << req.price
+                      << " volume=" << req.volume << std::endl;
+            return "";
+        }
+        if (side == 1 && positions_.seeded()) {
+            Position pos;
+            if (!positions_.get(instrument, pos) || pos.available < req.volume) {
+                ++stats_.rejects;
+                std::cerr << "[SIM] 可用持仓不足: " << InstrumentRegistry::instance().symbol(instrument)
+                          << " volume=" << req.volume << " available=" << pos.available << std::endl;
+                return "";
+            }
+        }
+
+        uint64_t id = ++next_id_;
+        order_id = std::to_string(id);
+        OrderRecord& order = orders_.create(order_id, instrument, req.tag, req.remark);
+        orders_.bind_sys_id(order, static_cast<int64_t>(id));
+        order.volume = req.volume;
+        order.price = req.is_market ? 0.0 : req.price;
+        order.side = side;
+        order.order_type = req.order_type;
+        order_ids_.push_back(order_id);
+        positions_.on_order(instrument, side, req.volume);
+        schedule(Action::Kind::ENTER, id, std::chrono::steady_clock::now() + ack_latency_, price, req.volume);
+    }
+    cv_.notify_one();
+    return order_id;
+}
+
+bool SimTradingApi::cancel_order(const std::string& order_id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        OrderRecord* order = orders_.find(order_id);
+        if (!running_ || !order || is_terminal(order->state.load(std::memory_order_relaxed))) {
+            return false;
+        }
+        set_state(*order, OrderState::CANCEL_PENDING);
+        schedule(Action::Kind::CANCEL, static_cast<uint64_t>(order->sys_id),
+                 std::chrono::steady_clock::now() + ack_latency_);
+    }
+    cv_.notify_one();
+    return true;
+}
+
+std::vector<Position> SimTradingApi::query_positions() {
+    return positions_.snapshot();
+}
+
+bool SimTradingApi::query_positions_local(std::vector<Position>& out) {
+    if (!positions_.seeded()) {
+        return false;
+    }
+    out = positions_.snapshot();
+    return true;
+}
+
+std::vector<OrderResult> SimTradingApi::query_orders() {
+    std::vector<OrderResult> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(order_ids_.size());
+    for (const auto& order_id : order_ids_) {
+        const OrderRecord* order = orders_.find(order_id);
+        if (order) {
+            result.push_back(to_order_result(*order));
+        }
+    }
+    return result;
+}
+
+OrderResult SimTradingApi::query_order(const std::string& order_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const OrderRecord* order = orders_.find(order_id);
+    if (!order) {
+        OrderResult result;
+        result.success = false;
+        result.err_msg = "Order not found";
+        return result;
+    }
+    return to_order_result(*order);
+}
+
+bool SimTradingApi::query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) {
+    std::vector<const OrderRecord*> records;
+    std::lock_guard<std::mutex> lock(mutex_);
+    orders_.live_orders(instrument, records);
+    for (const OrderRecord* order : records) {
+        out.push_back(to_order_result(*order));
+    }
+    return true;
+}
+
+bool SimTradingApi::query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) {
+    std::vector<const OrderRecord*> records;
+    std::lock_guard<std::mutex> lock(mutex_);
+    orders_.find_by_tag(tag_key, records);
+    for (const OrderRecord* order : records) {
+        out.push_back(to_order_result(*order));
+    }
+    return true;
+}
+
+bool SimTradingApi::order_route(const std::string& order_id, std::string& account, std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const OrderRecord* order = orders_.find(order_id);
+    if (!order) {
+        return false;
+    }
+    account = account_;
+    symbol = order->symbol();
+    return true;
+}
+
+void SimTradingApi::attach_market(std::shared_ptr<IMarketDataApi> market) {
+    std::shared_ptr<MarketUpdateQueue> queue =
+        market ? market->subscribe_updates(std::vector<InstrumentId>()) : nullptr;
+    std::shared_ptr<IMarketDataApi> old_market;
+    std::shared_ptr<MarketUpdateQueue> old_queue;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        old_market = std::move(market_);
+        old_queue = std::move(updates_);
+        market_ = std::move(market);
+        updates_ = std::move(queue);
+        if (updates_) {
+            for (InstrumentId id : watched_) {
+                updates_->watch(id);
+            }
+        }
+    }
+    if (old_market && old_queue) {
+        old_market->unsubscribe_updates(old_queue);
+    }
+}
+
+void SimTradingApi::set_latency(std::chrono::microseconds ack, std::chrono::microseconds fill) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ack_latency_ = ack;
+    fill_latency_ = fill;
+}
+
+void SimTradingApi::seed_positions(const std::vector<Position>& positions) {
+    positions_.seed(positions);
+}
+
+bool SimTradingApi::load_positions_csv(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "[SIM] 无法打开持仓文件: " << path << std::endl;
+        return false;
+    }
+    std::vector<Position> positions;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t comma = line.find(',');
+        if (comma == std::string::npos) {
+            continue;
+        }
+        std::string symbol = trim_field(line.substr(0, comma));
+        std::string qty = trim_field(line.substr(comma + 1));
+        char* end = nullptr;
+        long long volume = std::strtoll(qty.c_str(), &end, 10);
+        if (symbol.empty() || end == qty.c_str()) {
+            continue;  // 表头或空行
+        }
+        Position pos;
+        pos.symbol = symbol;
+        pos.total = volume;
+        pos.available = volume;
+        positions.push_back(pos);
+    }
+    seed_positions(positions);
+    std::cout << "[SIM] 持仓建账 " << positions.size() << " 只: " << path << std::endl;
+    return true;
+}
+
+void SimTradingApi::set_order_callback(OrderEventCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    order_callback_ = std::move(callback);
+}
+
+SimTradingApi::Stats SimTradingApi::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SimTradingApi::run() {
+    std::vector<Notice> notices;
+    std::vector<MarketUpdate> updates;
+    std::vector<MarketSnapshot> snapshots;
+    std::vector<InstrumentId> poll;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        // 行情在锁外读取，下单线程不必等待行情接口
+        std::shared_ptr<IMarketDataApi> market = market_;
+        std::shared_ptr<MarketUpdateQueue> queue = updates_;
+        poll.clear();
+        if (market && !queue) {
+            for (InstrumentId id : watched_) {
+                if (engine_.has_resting(id)) {
+                    poll.push_back(id);
+                }
+            }
+        }
+        lock.unlock();
+        snapshots.clear();
+        if (queue) {
+            updates.clear();
+            queue->drain(updates);
+            for (const auto& update : updates) {
+                snapshots.push_back(market->get_snapshot(update.id));
+            }
+        } else {
+            for (InstrumentId id : poll) {
+                snapshots.push_back(market->get_snapshot(id));
+            }
+        }
+        lock.lock();
+
+        for (const auto& snap : snapshots) {
+            engine_.on_snapshot(snap, events_);
+        }
+        schedule_events();
+
+        auto now = std::chrono::steady_clock::now();
+        while (!actions_.empty() && actions_.top().due <= now) {
+            Action action = actions_.top();
+            actions_.pop();
+            uint64_t lag_us = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - action.due).count());
+            stats_.max_lag_us = std::max(stats_.max_lag_us, lag_us);
+            execute(action, notices);
+        }
+
+        if (!notices.empty()) {
+            lock.unlock();
+            OrderEventCallback callback;
+            {
+                std::lock_guard<std::mutex> cb_lock(callback_mutex_);
+                callback = order_callback_;
+            }
+            if (callback) {
+                for (const auto& notice : notices) {
+                    callback(notice.first, notice.second);
+                }
+            }
+            notices.clear();
+            lock.lock();
+            continue;
+        }
+
+        auto deadline = now + kMarketPollInterval;
+        if (!actions_.empty() && actions_.top().due < deadline) {
+            deadline = actions_.top().due;
+        }
+        cv_.wait_until(lock, deadline);
+    }
+}
+
+void SimTradingApi::schedule(Action::Kind kind, uint64_t order_id, std::chrono::steady_clock::time_point due,
+                             int64_t price, int64_t qty) {
+    Action action;
+    action.due = due;
+    action.seq = ++next_seq_;
+    action.kind = kind;
+    action.order_id = order_id;
+    action.price = price;
+    action.qty = qty;
+    actions_.push(action);
+}
+
+void SimTradingApi::schedule_events() {
+    if (events_.empty()) {
+        return;
+    }
+    auto due = std::chrono::steady_clock::now() + fill_latency_;
+    for (const auto& ev : events_) {
+        schedule(ev.kind == MatchingEngine::Event::Kind::FILL ? Action::Kind::FILL : Action::Kind::WITHDRAW,
+                 ev.order_id, due, ev.price, ev.qty);
+    }
+    events_.clear();
+}
+
+void SimTradingApi::execute(const Action& action, std::vector<Notice>& notices) {
+    OrderRecord* order = find_order(action.order_id);
+    if (!order) {
+        return;
+    }
+
+    switch (action.kind) {
+        case Action::Kind::ENTER: {
+            if (std::find(watched_.begin(), watched_.end(), order->instrument) == watched_.end()) {
+                watched_.push_back(order->instrument);
+                if (updates_) {
+                    updates_->watch(order->instrument);
+                }
+            }
+            // 进入撮合前用最新行情刷新盘口
+            if (market_) {
+                engine_.on_snapshot(market_->get_snapshot(order->instrument), events_);
+            }
+            ++stats_.orders;
+            OrderSide side = order->side == 0 ? OrderSide::Buy : OrderSide::Sell;
+            if (!engine_.add(action.order_id, order->instrument, side, action.price, action.qty,
+                             action.price == 0, events_)) {
+                ++stats_.rejects;
+                if (set_state(*order, OrderState::REJECTED)) {
+                    notices.emplace_back(to_order_result(*order), NOTIFY_PUSH_INVALID);
+                }
+                break;
+            }
+            set_state(*order, OrderState::ACCEPTED);
+            notices.emplace_back(to_order_result(*order), NOTIFY_PUSH_ORDER);
+            schedule_events();
+            break;
+        }
+        case Action::Kind::CANCEL:
+            // 已全部成交的订单撤单无效，等待已排队的成交推送
+            engine_.cancel(action.order_id, events_);
+            schedule_events();
+            break;
+        case Action::Kind::FILL: {
+            int64_t prev_filled = order->filled_volume;
+            double price = static_cast<double>(action.price) / kPriceScale;
+            if (!order->apply_fill(prev_filled + action.qty,
+                                   order->filled_price * prev_filled + price * action.qty, price)) {
+                break;
+            }
+            if (is_terminal(order->state.load(std::memory_order_relaxed))) {
+                positions_.on_late_fill(order->instrument, order->side, action.qty);
+            } else {
+                positions_.on_fill(order->instrument, order->side, action.qty);
+            }
+            set_state(*order, order->filled_volume >= order->volume ? OrderState::FILLED : OrderState::PARTIAL);
+            ++stats_.fills;
+            notices.emplace_back(to_order_result(*order), NOTIFY_PUSH_MATCH);
+            break;
+        }
+        case Action::Kind::WITHDRAW:
+            if (set_state(*order, OrderState::CANCELLED)) {
+                ++stats_.cancels;
+                notices.emplace_back(to_order_result(*order), NOTIFY_PUSH_WITHDRAW);
+            }
+            break;
+    }
+}
+
+OrderRecord* SimTradingApi::find_order(uint64_t order_id) {
+    return orders_.find_by_sys_id(static_cast<int64_t>(order_id));
+}
+
+bool SimTradingApi::set_state(OrderRecord& order, OrderState state) {
+    if (!order.transition(state)) {
+        return false;
+    }
+    // 终态订单移出活动列表；撤单/废单退回未成交部分的冻结
+    if (is_terminal(state)) {
+        orders_.retire(order);
+        if (state != OrderState::FILLED) {
+            positions_.on_release(order.instrument, order.side, order.volume - order.filled_volume);
+        }
+    }
+    return true;
+}
+
+OrderResult SimTradingApi::to_order_result(const OrderRecord& order) {
+    OrderResult result;
+    result.success = true;
+    result.order_id = order.order_id;
+    result.symbol = order.symbol();
+    result.volume = order.volume;
+    result.filled_volume = order.filled_volume;
+    result.filled_price = order.filled_price;
+    result.last_fill_price = order.last_fill_price;
+    result.price = order.price;
+    result.remark = order.remark;
+    result.tag = order.tag;
+    result.side = order.side;
+    result.order_type = order.order_type;
+    result.entrust_type = order.entrust_type;
+    result.is_local = true;
+    result.status = to_result_status(order.state.load(std::memory_order_acquire));
+    return result;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "IMarketDataApi.h"
+#include "ITradingApi.h"
+#include "MarketUpdateQueue.h"
+#include "MatchingEngine.h"
+#include "OrderStore.h"
+#include "PositionLedger.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// @brief 模拟交易接口：委托在本地撮合引擎（MatchingEngine）中按行情撮合，不连接柜台
+///
+/// - 下单/撤单立即返回，经过 ack 延迟后进入撮合引擎，随即推送确认（或废单）；
+/// - 撮合产生的成交、撤单经过 fill 延迟后推送，订单状态与推送同时生效；
+/// - 推送类型与 SecTradingApi 相同（NOTIFY_PUSH_ORDER/MATCH/WITHDRAW/INVALID），在模拟线程上回调；
+/// - 行情来自 attach_market 指定的行情接口：支持推送时订阅更新队列，否则轮询有挂单的证券；
+/// - 持仓由 seed_positions / load_positions_csv 建账，按委托/成交/撤单维护，卖出超过可用量时拒单。
+class SimTradingApi : public ITradingApi {
+public:
+    using OrderEventCallback = std::function<void(const OrderResult&, int)>;
+
+    /// @brief 运行统计
+    struct Stats {
+        uint64_t orders = 0;       // 进入撮合引擎的委托
+        uint64_t fills = 0;        // 成交推送
+        uint64_t cancels = 0;      // 撤单推送
+        uint64_t rejects = 0;      // 废单（含下单时同步拒绝）
+        uint64_t max_lag_us = 0;   // 模拟事件实际执行时间晚于计划时间的最大值
+    };
+
+    SimTradingApi();
+    ~SimTradingApi() override;
+
+    /// @brief 启动模拟线程（参数忽略）
+    bool connect(const std::string& host, int port,
+                 const std::string& user, const std::string& password) override;
+    void disconnect() override;
+    bool is_connected() const override;
+
+    std::string place_order(const OrderRequest& req) override;
+    bool cancel_order(const std::string& order_id) override;
+    std::vector<Position> query_positions() override;
+    bool query_positions_local(std::vector<Position>& out) override;
+    std::vector<OrderResult> query_orders() override;
+    OrderResult query_order(const std::string& order_id) override;
+    bool query_live_orders_local(InstrumentId instrument, std::vector<OrderResult>& out) override;
+    bool query_orders_by_tag_local(uint32_t tag_key, std::vector<OrderResult>& out) override;
+    bool order_route(const std::string& order_id, std::string& account, std::string& symbol) override;
+
+    /// @brief 指定撮合用的行情源（可在 connect 之后调用）
+    void attach_market(std::shared_ptr<IMarketDataApi> market);
+
+    /// @brief 设置延迟：ack=下单/撤单到进入撮合引擎，fill=撮合到成交/撤单推送
+    void set_latency(std::chrono::microseconds ack, std::chrono::microseconds fill);
+
+    /// @brief 建账（覆盖现有持仓）
+    void seed_positions(const std::vector<Position>& positions);
+
+    /// @brief 从 CSV 建账，每行 "证券代码,数量"，首行为表头时跳过
+    bool load_positions_csv(const std::string& path);
+
+    /// @brief 设置订单回调（委托/成交/撤单/废单）
+    void set_order_callback(OrderEventCallback callback);
+
+    Stats stats() const;
+
+private:
+    /// 计划在 due 时刻执行的模拟事件
+    struct Action {
+        enum class Kind { ENTER, CANCEL, FILL, WITHDRAW };
+        std::chrono::steady_clock::time_point due;
+        uint64_t seq = 0;          // 同一时刻按提交顺序执行
+        Kind kind = Kind::ENTER;
+        uint64_t order_id = 0;
+        int64_t price = 0;         // FILL：成交价（定点）
+        int64_t qty = 0;           // FILL：成交量
+    };
+
+    struct Later {
+        bool operator()(const Action& a, const Action& b) const {
+            return a.due != b.due ? a.due > b.due : a.seq > b.seq;
+        }
+    };
+
+    using Notice = std::pair<OrderResult, int>;
+
+    void run();
+    void schedule(Action::Kind kind, uint64_t order_id, std::chrono::steady_clock::time_point due,
+                  int64_t price = 0, int64_t qty = 0);              // 需持有 mutex_
+    void execute(const Action& action, std::vector<Notice>& notices);  // 需持有 mutex_
+    void schedule_events();                                             // 需持有 mutex_
+    OrderRecord* find_order(uint64_t order_id);                        // 需持有 mutex_
+    bool set_state(OrderRecord& order, OrderState state);              // 需持有 mutex_
+    static OrderResult to_order_result(const OrderRecord& order);
+
+    MatchingEngine engine_;
+    OrderStore orders_;
+    std::vector<std::string> order_ids_;   // 全部本地订单 ID（按下单顺序，供 query_orders）
+    PositionLedger positions_;
+    uint64_t next_id_ = 0;
+    uint64_t next_seq_ = 0;
+    std::priority_queue<Action, std::vector<Action>, Later> actions_;
+    std::vector<MatchingEngine::Event> events_;
+    std::vector<InstrumentId> watched_;    // 下过单的证券（无推送时轮询）
+    std::string account_;                  // connect 传入的资金账号（仅用于 order_route）
+    Stats stats_;
+
+    std::chrono::microseconds ack_latency_{200};
+    std::chrono::microseconds fill_latency_{300};
+
+    std::shared_ptr<IMarketDataApi> market_;
+    std::shared_ptr<MarketUpdateQueue> updates_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    OrderEventCallback order_callback_;
+    std::mutex callback_mutex_;
+};
@@ -5,6 +5,23 @@
 #include <ctime>
 #include <cmath>
 
+namespace {
+
+// 持仓按证券 ID 建索引，替代逐只股票线性扫描持仓列表（同代码取第一条）
+InstrumentMap<Position> index_positions(const std::vector<Position>& positions) {
+    InstrumentMap<Position> index;
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
+    for (const auto& pos : positions) {
+        InstrumentId id = registry.find(pos.symbol);
+        if (id != kInvalidInstrument && !index.contains(id)) {
+            index[id] = pos;
+        }
+    }
+    return index;
+}
+
+}  // namespace
+
 AuctionSellStrategy::AuctionSellStrategy(
     TradingMarketApi* api,
     const std::string& csv_path,
@@ -46,11 +63,12 @@ bool AuctionSellStrategy::init() {
     }
     
     // 3. 获取涨停价和跌停价（从API获取）
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
         if (stock) {
             // 获取涨停价和跌停价
-            auto limits = api_->get_limits(symbol);
+            auto limits = api_->get_limits(id);
             stock->zt_price = limits.first;   // 涨停价
             stock->dt_price = limits.second;  // 跌停价
             
@@ -108,9 +126,10 @@ void AuctionSellStrategy::on_timer() {
 void AuctionSellStrategy::check_market_data() {
     std::cout << "=== Phase 0: Checking market data ===" << std::endl;
     
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (stock && snap.valid && snap.pre_close > 0.0) {
             stock->pre_close = snap.pre_close;
         }
@@ -131,10 +150,12 @@ void AuctionSellStrategy::check_market_data() {
 }
 
 void AuctionSellStrategy::phase1_return1_sell() {
-    auto positions = api_->query_positions();
+    auto positions = index_positions(api_->query_positions());
+    std::vector<OrderRequest> reqs;
     
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
         if (!stock || stock->return1_sell == 1 || stock->sell_flag == 1) {
             continue;
         }
@@ -142,12 +163,9 @@ void AuctionSellStrategy::phase1_return1_sell() {
         // 查找持仓
         int64_t avail_vol = 0;
         int64_t total_vol = 0;
-        for (const auto& pos : positions) {
-            if (pos.symbol == symbol) {
-                avail_vol = std::max(pos.available - hold_vol_, int64_t(0));
-                total_vol = std::max(pos.total - hold_vol_, int64_t(0));
-                break;
-            }
+        if (const Position* pos = positions.find(id)) {
+            avail_vol = std::max(pos->available - hold_vol_, int64_t(0));
+            total_vol = std::max(pos->total - hold_vol_, int64_t(0));
         }
         
         int64_t vol = std::min(avail_vol, total_vol);
@@ -158,7 +176,7 @@ void AuctionSellStrategy::phase1_return1_sell() {
         }
         
         // 获取行情
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (!snap.valid) continue;
         if (snap.high_limit > 0.0) {
             stock->zt_price = snap.high_limit;
@@ -167,8 +185,8 @@ void AuctionSellStrategy::phase1_return1_sell() {
             stock->dt_price = snap.low_limit;
         }
         
-        double buy_price1 = snap.bid_price1;
-        double ask_vol2 = snap.ask_volume2;
+        double buy_price1 = snap.bid_price(0);
+        double ask_vol2 = snap.ask_volume(1);
         
         // 涨停判断：买一价=涨停价 且 卖二无量（封死）→ 跳过
         // 集合竞价期间，封死涨停时 Ask2 无量
@@ -191,27 +209,37 @@ void AuctionSellStrategy::phase1_return1_sell() {
         OrderRequest req;
         req.account_id = account_id_;
         req.symbol = symbol;
+        req.instrument = id;
         req.price = stock->dt_price;  // 跌停价
         req.volume = sell_vol;
         req.is_market = false;
-        req.remark = "盘前卖出" + symbol;
-        
-        std::string order_id = api_->place_order(req);
-        
-        if (!order_id.empty()) {
-            stock->total_sell += sell_vol;
-            stock->userOrderId = req.remark;
-            std::cout << "  [Phase1] " << symbol << " sell " << sell_vol 
-                      << " @ " << stock->dt_price << ", order=" << order_id << std::endl;
+        req.tag = next_order_tag(StrategyIds::kPreOpenSell, id);
+        reqs.push_back(req);
+    }
+    
+    // 本轮全部卖单一次批量委托
+    std::vector<std::string> order_ids = api_->place_orders(reqs);
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        const OrderRequest& req = reqs[i];
+        if (order_ids[i].empty()) {
+            continue;
         }
+        auto* stock = csv_config_.get_stock(req.instrument);
+        stock->total_sell += req.volume;
+        stock->order_tag = req.tag;
+        std::cout << "  [Phase1] " << req.symbol << " sell " << req.volume 
+                  << " @ " << req.price << ", order=" << order_ids[i] << std::endl;
     }
 }
 
 void AuctionSellStrategy::phase2_conditional_sell() {
-    auto positions = api_->query_positions();
+    auto positions = index_positions(api_->query_positions());
+    std::vector<OrderRequest> reqs;
+    std::vector<std::string> conditions;
     
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
         if (!stock || stock->sell_flag == 1) {
             continue;
         }
@@ -236,12 +264,9 @@ void AuctionSellStrategy::phase2_conditional_sell() {
         // 查找持仓
         int64_t avail_vol = 0;
         int64_t total_vol = 0;
-        for (const auto& pos : positions) {
-            if (pos.symbol == symbol) {
-                avail_vol = std::max(pos.available - hold_vol_, int64_t(0));
-                total_vol = std::max(pos.total - hold_vol_, int64_t(0));
-                break;
-            }
+        if (const Position* pos = positions.find(id)) {
+            avail_vol = std::max(pos->available - hold_vol_, int64_t(0));
+            total_vol = std::max(pos->total - hold_vol_, int64_t(0));
         }
         
         int64_t vol = std::min(avail_vol, total_vol);
@@ -251,7 +276,7 @@ void AuctionSellStrategy::phase2_conditional_sell() {
         }
         
         // 获取行情
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (!snap.valid) continue;
         if (snap.high_limit > 0.0) {
             stock->zt_price = snap.high_limit;
@@ -260,9 +285,9 @@ void AuctionSellStrategy::phase2_conditional_sell() {
             stock->dt_price = snap.low_limit;
         }
         
-        double buy_price1 = snap.bid_price1;
-        double ask_vol1 = snap.ask_volume1;
-        double ask_vol2 = snap.ask_volume2;
+        double buy_price1 = snap.bid_price(0);
+        double ask_vol1 = snap.ask_volume(0);
+        double ask_vol2 = snap.ask_volume(1);
         
         // 限制总卖出量不超过市场ask1的一定比例
         if (sell_to_mkt_ratio_ >= 0) {
@@ -350,20 +375,29 @@ void AuctionSellStrategy::phase2_conditional_sell() {
         OrderRequest req;
         req.account_id = account_id_;
         req.symbol = symbol;
+        req.instrument = id;
         req.price = sell_price;
         req.volume = vol;
         req.is_market = false;
-        req.remark = "盘前卖出" + symbol;
-        
-        std::string order_id = api_->place_order(req);
+        req.tag = next_order_tag(StrategyIds::kPreOpenSell, id);
         
-        if (!order_id.empty()) {
-            stock->total_sell += vol;
-            stock->userOrderId = req.remark;
-            std::cout << "  [Phase2] " << symbol << " " << condition 
-                      << " sell " << vol << " @ " << sell_price 
-                      << ", order=" << order_id << std::endl;
+        reqs.push_back(req);
+        conditions.push_back(condition);
+    }
+    
+    // 本轮全部卖单一次批量委托
+    std::vector<std::string> order_ids = api_->place_orders(reqs);
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        const OrderRequest& req = reqs[i];
+        if (order_ids[i].empty()) {
+            continue;
         }
+        auto* stock = csv_config_.get_stock(req.instrument);
+        stock->total_sell += req.volume;
+        stock->order_tag = req.tag;
+        std::cout << "  [Phase2] " << req.symbol << " " << conditions[i] 
+                  << " sell " << req.volume << " @ " << req.price 
+                  << ", order=" << order_ids[i] << std::endl;
     }
 }
 
@@ -401,8 +435,8 @@ void AuctionSellStrategy::print_status() const {
     int completed = 0;
     int64_t total_sold = 0;
     
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
         if (stock && stock->sell_flag == 1) {
             completed++;
         }
@@ -416,10 +450,14 @@ void AuctionSellStrategy::print_status() const {
 }
 
 void AuctionSellStrategy::phase3_final_sell() {
-    auto positions = api_->query_positions();
+    auto positions = index_positions(api_->query_positions());
+    std::vector<OrderRequest> reqs;
+    std::vector<std::string> labels;
+    std::vector<bool> limit_legs;  // 涨停分支的卖单（成功后置 limit_sell，否则置 sell_flag）
     
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
         if (!stock || stock->sell_flag == 1) {
             continue;
         }
@@ -427,12 +465,9 @@ void AuctionSellStrategy::phase3_final_sell() {
         // 查找持仓
         int64_t avail_vol = 0;
         int64_t total_vol = 0;
-        for (const auto& pos : positions) {
-            if (pos.symbol == symbol) {
-                avail_vol = std::max(pos.available - hold_vol_, int64_t(0));
-                total_vol = std::max(pos.total - hold_vol_, int64_t(0));
-                break;
-            }
+        if (const Position* pos = positions.find(id)) {
+            avail_vol = std::max(pos->available - hold_vol_, int64_t(0));
+            total_vol = std::max(pos->total - hold_vol_, int64_t(0));
         }
         
         int64_t vol = std::min(avail_vol, total_vol);
@@ -442,7 +477,7 @@ void AuctionSellStrategy::phase3_final_sell() {
         }
         
         // 获取行情
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (!snap.valid) continue;
         if (snap.high_limit > 0.0) {
             stock->zt_price = snap.high_limit;
@@ -451,10 +486,10 @@ void AuctionSellStrategy::phase3_final_sell() {
             stock->dt_price = snap.low_limit;
         }
         
-        double buy_price1 = snap.bid_price1;
-        double buy_vol2 = snap.bid_volume2;
-        double ask_vol1 = snap.ask_volume1;
-        double ask_vol2 = snap.ask_volume2;
+        double buy_price1 = snap.bid_price(0);
+        double buy_vol2 = snap.bid_volume(1);
+        double ask_vol1 = snap.ask_volume(0);
+        double ask_vol2 = snap.ask_volume(1);
         
         // Phase3 涨停分支：弱封板/未封板（对应 qh2h竞价卖出new.txt）
         // 弱封板：买1=涨停 且 买2量 < 2*卖1量 → 全仓卖出
@@ -467,20 +502,14 @@ void AuctionSellStrategy::phase3_final_sell() {
                 OrderRequest req;
                 req.account_id = account_id_;
                 req.symbol = symbol;
+                req.instrument = id;
                 req.price = gaokai_price;
                 req.volume = sell_vol;
                 req.is_market = false;
-                req.remark = "盘中卖出" + symbol;
-                
-                std::string order_id = api_->place_order(req);
-                
-                if (!order_id.empty()) {
-                    stock->total_sell += sell_vol;
-                    stock->userOrderId = req.remark;
-                    stock->limit_sell = 1;
-                    std::cout << "  [Phase3-WeakSeal] " << symbol << " sell " << sell_vol 
-                              << " @ " << gaokai_price << " (zt-0.01), order=" << order_id << std::endl;
-                }
+                req.tag = next_order_tag(StrategyIds::kIntradaySell, id);
+                reqs.push_back(req);
+                labels.push_back("[Phase3-WeakSeal]");
+                limit_legs.push_back(true);
                 continue;
             }
             
@@ -488,20 +517,14 @@ void AuctionSellStrategy::phase3_final_sell() {
                 OrderRequest req;
                 req.account_id = account_id_;
                 req.symbol = symbol;
+                req.instrument = id;
                 req.price = gaokai_price;
                 req.volume = sell_vol;
                 req.is_market = false;
-                req.remark = "盘中卖出" + symbol;
-                
-                std::string order_id = api_->place_order(req);
-                
-                if (!order_id.empty()) {
-                    stock->total_sell += sell_vol;
-                    stock->userOrderId = req.remark;
-                    stock->limit_sell = 1;
-                    std::cout << "  [Phase3-Unsealed] " << symbol << " sell " << sell_vol 
-                              << " @ " << gaokai_price << " (zt-0.01), order=" << order_id << std::endl;
-                }
+                req.tag = next_order_tag(StrategyIds::kIntradaySell, id);
+                reqs.push_back(req);
+                labels.push_back("[Phase3-Unsealed]");
+                limit_legs.push_back(true);
                 continue;
             }
         }
@@ -563,21 +586,33 @@ void AuctionSellStrategy::phase3_final_sell() {
         OrderRequest req;
         req.account_id = account_id_;
         req.symbol = symbol;
+        req.instrument = id;
         req.price = sell_price;
         req.volume = vol;
         req.is_market = false;
-        req.remark = "盘前卖出" + symbol;
-        
-        std::string order_id = api_->place_order(req);
-        
-        if (!order_id.empty()) {
-            stock->total_sell += vol;
-            stock->userOrderId = req.remark;
+        req.tag = next_order_tag(StrategyIds::kPreOpenSell, id);
+        reqs.push_back(req);
+        labels.push_back("[Phase3] " + condition);
+        limit_legs.push_back(false);
+    }
+    
+    // 本轮全部卖单一次批量委托
+    std::vector<std::string> order_ids = api_->place_orders(reqs);
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        const OrderRequest& req = reqs[i];
+        if (order_ids[i].empty()) {
+            continue;
+        }
+        auto* stock = csv_config_.get_stock(req.instrument);
+        stock->total_sell += req.volume;
+        stock->order_tag = req.tag;
+        if (limit_legs[i]) {
+            stock->limit_sell = 1;
+        } else {
             stock->sell_flag = 1;  // 此窗口成交后置标志
-            std::cout << "  [Phase3] " << symbol << " " << condition 
-                      << " sell " << vol << " @ " << sell_price 
-                      << ", order=" << order_id << std::endl;
         }
+        std::cout << "  " << labels[i] << " " << req.symbol << " sell " << req.volume 
+                  << " @ " << req.price << ", order=" << order_ids[i] << std::endl;
     }
 }
 
@@ -585,31 +620,48 @@ void AuctionSellStrategy::cancel_auction_orders() {
     std::cout << "=== Canceling auction orders ===" << std::endl;
     
     // txt line 279-294: 查询订单列表，撤销未成交的"盘前卖出"订单
-    auto orders = api_->query_orders();
-    int cancel_count = 0;
-    
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    // 每只证券匹配盘前卖出单与最近一次委托的标签
+    std::vector<uint32_t> keys;
+    std::vector<InstrumentId> key_instruments;
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
         if (!stock) continue;
         
-        for (const auto& order : orders) {
-            // 匹配remark字段
-            if (order.remark == stock->userOrderId || 
-                order.remark.find("盘前卖出" + symbol) != std::string::npos) {
-                // 状态不是已成交(56)则撤单
-                if (order.status != OrderResult::Status::FILLED) {
-                    if (api_->cancel_order(order.order_id)) {
-                        cancel_count++;
-                        std::cout << "  Cancelled: " << symbol 
-                                  << ", order_id=" << order.order_id << std::endl;
-                    }
-                }
-            }
+        uint32_t pre_open_key = order_tag_key(make_order_tag(StrategyIds::kPreOpenSell, id, 0));
+        keys.push_back(pre_open_key);
+        key_instruments.push_back(id);
+        if (stock->order_tag != 0 && order_tag_key(stock->order_tag) != pre_open_key) {
+            keys.push_back(order_tag_key(stock->order_tag));
+            key_instruments.push_back(id);
         }
-        
         stock->call_back = 1;  // 标记已处理
     }
     
+    // 按订单标签键（策略 + 证券）读本地订单簿，不支持时退回一次全量查询
+    std::vector<std::vector<OrderResult>> orders_by_key = api_->query_orders_by_tags(keys);
+    int cancel_count = 0;
+    std::vector<std::string> cancel_ids;
+    std::vector<InstrumentId> cancel_instruments;
+    for (size_t k = 0; k < keys.size(); ++k) {
+        for (const OrderResult& order : orders_by_key[k]) {
+            // 状态不是已成交(56)则撤单
+            if (order.status != OrderResult::Status::FILLED) {
+                cancel_ids.push_back(order.order_id);
+                cancel_instruments.push_back(key_instruments[k]);
+            }
+        }
+    }
+    
+    // 一次提交全部撤单
+    std::vector<bool> cancelled = api_->cancel_orders(cancel_ids);
+    for (size_t i = 0; i < cancel_ids.size(); ++i) {
+        if (cancelled[i]) {
+            cancel_count++;
+            std::cout << "  Cancelled: " << InstrumentRegistry::instance().symbol(cancel_instruments[i]) 
+                      << ", order_id=" << cancel_ids[i] << std::endl;
+        }
+    }
+    
     std::cout << "Total cancelled: " << cancel_count << " orders" << std::endl;
 }
 
@@ -620,8 +672,9 @@ void AuctionSellStrategy::collect_auction_data() {
     int date = get_current_date();
     std::string date_str = std::to_string(date);
     
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
         if (!stock) continue;
         
         // 通过API获取09:15-09:27的集合竞价数据
@@ -646,10 +699,13 @@ void AuctionSellStrategy::after_open_sell() {
         return;
     }
     
-    auto positions = api_->query_positions();
+    auto positions = index_positions(api_->query_positions());
+    std::vector<OrderRequest> reqs;
+    std::vector<std::string> labels;
     
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
-        auto* stock = csv_config_.get_stock(symbol);
+    for (InstrumentId id : csv_config_.ids()) {
+        auto* stock = csv_config_.get_stock(id);
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
         if (!stock || stock->sell_flag == 1) {
             continue;
         }
@@ -657,12 +713,9 @@ void AuctionSellStrategy::after_open_sell() {
         // 查找持仓
         int64_t avail_vol = 0;
         int64_t total_vol = 0;
-        for (const auto& pos : positions) {
-            if (pos.symbol == symbol) {
-                avail_vol = std::max(pos.available - hold_vol_, int64_t(0));
-                total_vol = std::max(pos.total - hold_vol_, int64_t(0));
-                break;
-            }
+        if (const Position* pos = positions.find(id)) {
+            avail_vol = std::max(pos->available - hold_vol_, int64_t(0));
+            total_vol = std::max(pos->total - hold_vol_, int64_t(0));
         }
         
         int64_t vol = std::min(avail_vol, total_vol);
@@ -672,14 +725,14 @@ void AuctionSellStrategy::after_open_sell() {
         }
         
         // 获取行情
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (!snap.valid) continue;
         if (snap.high_limit > 0.0) {
             stock->zt_price = snap.high_limit;
         }
         
-        double buy_price1 = snap.bid_price1;
-        double sell_price1 = snap.ask_price1;
+        double buy_price1 = snap.bid_price(0);
+        double sell_price1 = snap.ask_price(0);
         
         // 检查涨停
         if (stock->zt_price > 0 && std::abs(buy_price1 - stock->zt_price) < 0.01) {
@@ -720,20 +773,13 @@ void AuctionSellStrategy::after_open_sell() {
                 OrderRequest req;
                 req.account_id = account_id_;
                 req.symbol = symbol;
+                req.instrument = id;
                 req.price = sell_price;
                 req.volume = vol;
                 req.is_market = false;
-                req.remark = "盘中卖出" + symbol;
-                
-                std::string order_id = api_->place_order(req);
-                
-                if (!order_id.empty()) {
-                    stock->total_sell += vol;
-                    stock->userOrderId = req.remark;
-                    stock->call_back = 0;
-                    std::cout << "  [AfterOpen-封死] " << symbol << " sell " << vol 
-                              << " @ " << sell_price << ", order=" << order_id << std::endl;
-                }
+                req.tag = next_order_tag(StrategyIds::kIntradaySell, id);
+                reqs.push_back(req);
+                labels.push_back("[AfterOpen-封死]");
             }
         }
         // txt line 379-391: 炸板票，小量高开，盘前没卖完
@@ -750,21 +796,29 @@ void AuctionSellStrategy::after_open_sell() {
                 OrderRequest req;
                 req.account_id = account_id_;
                 req.symbol = symbol;
+                req.instrument = id;
                 req.price = sell_price;
                 req.volume = vol;
                 req.is_market = false;
-                req.remark = "盘中卖出" + symbol;
-                
-                std::string order_id = api_->place_order(req);
-                
-                if (!order_id.empty()) {
-                    stock->total_sell += vol;
-                    stock->userOrderId = req.remark;
-                    stock->call_back = 0;
-                    std::cout << "  [AfterOpen-炸板] " << symbol << " sell " << vol 
-                              << " @ " << sell_price << ", order=" << order_id << std::endl;
-                }
+                req.tag = next_order_tag(StrategyIds::kIntradaySell, id);
+                reqs.push_back(req);
+                labels.push_back("[AfterOpen-炸板]");
             }
         }
     }
+    
+    // 本轮全部卖单一次批量委托
+    std::vector<std::string> order_ids = api_->place_orders(reqs);
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        const OrderRequest& req = reqs[i];
+        if (order_ids[i].empty()) {
+            continue;
+        }
+        auto* stock = csv_config_.get_stock(req.instrument);
+        stock->total_sell += req.volume;
+        stock->order_tag = req.tag;
+        stock->call_back = 0;
+        std::cout << "  " << labels[i] << " " << req.symbol << " sell " << req.volume 
+                  << " @ " << req.price << ", order=" << order_ids[i] << std::endl;
+    }
 }
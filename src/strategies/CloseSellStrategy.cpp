@@ -26,13 +26,15 @@ bool CloseSellStrategy::init() {
     auto positions = api_->query_positions();
     std::cout << "Current positions: " << positions.size() << std::endl;
     
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
     for (const auto& pos : positions) {
         // txt line 231-237: 只处理持仓大于hold_vol的股票
-        if (pos.total > hold_vol_) {
-            total_volumes_[pos.symbol] = pos.total;
-            sold_volumes_[pos.symbol] = 0;
-            remarks_[pos.symbol] = "empty";
-            callbacks_[pos.symbol] = 0;
+        InstrumentId id = registry.intern(pos.symbol);
+        if (pos.total > hold_vol_ && id != kInvalidInstrument) {
+            total_volumes_[id] = pos.total;
+            sold_volumes_[id] = 0;
+            tags_[id] = 0;
+            callbacks_[id] = 0;
             std::cout << "  " << pos.symbol << ": total=" << pos.total 
                       << ", avail=" << pos.available << std::endl;
         }
@@ -72,11 +74,13 @@ void CloseSellStrategy::on_timer() {
 void CloseSellStrategy::phase1_random_sell() {
     // txt line 47-143: 随机卖出阶段
     // 每3秒触发，15%概率卖出，中间价
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
     if(!phase1_base_recorded_){
         auto positions = api_->query_positions();
         for(const auto& pos:positions){
-            if(pos.available>0){
-                phase1_base_available_[pos.symbol]=pos.available;
+            InstrumentId id = registry.intern(pos.symbol);
+            if(pos.available>0 && id != kInvalidInstrument){
+                phase1_base_available_[id]=pos.available;
             }
         }
         phase1_base_recorded_=true;
@@ -84,9 +88,11 @@ void CloseSellStrategy::phase1_random_sell() {
                   << phase1_base_available_.size() << " symbols" << std::endl;
     }
     auto positions = api_->query_positions();
+    std::vector<OrderRequest> reqs;
     
     for (const auto& pos : positions) {
         const std::string& symbol = pos.symbol;
+        InstrumentId id = registry.find(symbol);
         
         // 只处理记录中的股票（持仓>hold_vol）
         //if (total_volumes_.find(symbol) == total_volumes_.end()) {
@@ -101,11 +107,11 @@ void CloseSellStrategy::phase1_random_sell() {
         
         // txt line 55-57: 检查70%卖出限制
         // 当前可用 < 基准可用的30%，说明已卖超70%，跳过
-        auto base_it = phase1_base_available_.find(symbol);
-        if (base_it == phase1_base_available_.end()) {
+        const int64_t* base_it = phase1_base_available_.find(id);
+        if (!base_it) {
             continue;
         }
-        int64_t base_available = base_it->second;
+        int64_t base_available = *base_it;
         if (pos.available < base_available * 0.3) {
             continue;
         }
@@ -129,16 +135,16 @@ void CloseSellStrategy::phase1_random_sell() {
         }
         
         // 获取行情 - txt line 68-84
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (!snap.valid) {
             continue;
         }
         
-        double buy_price1 = snap.bid_price1;
-        double sell_price1 = snap.ask_price1;
+        double buy_price1 = snap.bid_price(0);
+        double sell_price1 = snap.ask_price(0);
         
         // 检查涨停价 - txt line 85-90
-        auto limits = api_->get_limits(symbol);
+        auto limits = api_->get_limits(id);
         double zt_price = limits.first;
         
         if (!(zt_price > 0)) {
@@ -179,21 +185,28 @@ void CloseSellStrategy::phase1_random_sell() {
         OrderRequest req;
         req.account_id = account_id_;
         req.symbol = symbol;
+        req.instrument = id;
         req.price = sell_price;
         req.volume = vol;
         req.is_market = false;
-        req.remark = "收盘卖出" + symbol;
-        
-        std::string order_id = api_->place_order(req);
-        
-        if (!order_id.empty()) {
-            remarks_[symbol] = req.remark;
-            auto& ids = order_ids_[symbol];
-            if (std::find(ids.begin(), ids.end(), order_id) == ids.end()) {
-                ids.push_back(order_id);
-            }
-            std::cout << "    Order placed: " << order_id << std::endl;
+        req.tag = next_order_tag(StrategyIds::kCloseSell, id);
+        reqs.push_back(req);
+    }
+    
+    // 本轮全部卖单一次批量委托，Phase 2 撤单时同批各腿可整批撤回
+    std::vector<std::string> order_ids = api_->place_orders(reqs);
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        const std::string& order_id = order_ids[i];
+        if (order_id.empty()) {
+            continue;
         }
+        InstrumentId id = reqs[i].instrument;
+        tags_[id] = reqs[i].tag;
+        auto& ids = order_ids_[id];
+        if (std::find(ids.begin(), ids.end(), order_id) == ids.end()) {
+            ids.push_back(order_id);
+        }
+        std::cout << "    Order placed: " << reqs[i].symbol << " " << order_id << std::endl;
     }
 }
 
@@ -205,44 +218,50 @@ void CloseSellStrategy::phase2_cancel_orders() {
     
     // 检查是否所有股票都已处理回调
     int total_callback = 0;
-    for (const auto& pair : callbacks_) {
-        total_callback += pair.second;
-    }
+    callbacks_.for_each([&](InstrumentId, int flag) {
+        total_callback += flag;
+    });
     
     if (total_callback == static_cast<int>(callbacks_.size())) {
         std::cout << "All callbacks processed, skip." << std::endl;
         return;
     }
     
-    // 查询订单列表
-    auto orders = api_->query_orders();
-    std::map<std::string, OrderResult::Status> status_by_id;
-    for (const auto& order : orders) {
-        status_by_id[order.order_id] = order.status;
-    }
+    // 按订单标签键（策略 + 证券）读本地订单簿，不支持时退回一次全量查询
+    std::vector<uint32_t> keys;
+    std::vector<InstrumentId> key_instruments;
+    tags_.for_each([&](InstrumentId id, OrderTag tag) {
+        keys.push_back(tag != 0 ? order_tag_key(tag) : 0);
+        key_instruments.push_back(id);
+    });
+    std::vector<std::vector<OrderResult>> orders_by_key = api_->query_orders_by_tags(keys);
     
-    std::cout << "[Phase2] orders_from_api=" << orders.size()
-              << ", tracked_symbols=" << order_ids_.size() << std::endl;
+    std::cout << "[Phase2] tracked_symbols=" << order_ids_.size() << std::endl;
+    
+    std::vector<std::string> cancel_ids;
+    std::vector<InstrumentId> cancel_instruments;
     
     // 遍历所有记录的股票
-    for (auto& pair : remarks_) {
-        const std::string& symbol = pair.first;
-        const std::string& remark = pair.second;
+    for (size_t k = 0; k < keys.size(); ++k) {
+        InstrumentId id = key_instruments[k];
+        const std::string& symbol = InstrumentRegistry::instance().symbol(id);
+        const std::vector<OrderResult>& orders = orders_by_key[k];
         
         int cancel_try = 0;
         
         // 优先按本地记录的 order_id 撤单
-        auto ids_it = order_ids_.find(symbol);
-        if (ids_it != order_ids_.end()) {
-            for (const auto& order_id : ids_it->second) {
-                auto st_it = status_by_id.find(order_id);
-                if (st_it == status_by_id.end()) {
+        const std::vector<std::string>* ids = order_ids_.find(id);
+        if (ids) {
+            for (const auto& order_id : *ids) {
+                auto st_it = std::find_if(orders.begin(), orders.end(),
+                                          [&](const OrderResult& o) { return o.order_id == order_id; });
+                if (st_it == orders.end()) {
                     std::cout << "  [Phase2] order_id not found: " << symbol 
                               << " " << order_id << std::endl;
                     continue;
                 }
                 
-                auto status = st_it->second;
+                auto status = st_it->status;
                 if (status == OrderResult::Status::FILLED ||
                     status == OrderResult::Status::CANCELLED ||
                     status == OrderResult::Status::REJECTED) {
@@ -250,33 +269,35 @@ void CloseSellStrategy::phase2_cancel_orders() {
                 }
                 
                 cancel_try++;
-                if (api_->cancel_order(order_id)) {
-                    cancel_count++;
-                    std::cout << "  Cancelled: " << symbol 
-                              << ", order_id=" << order_id << std::endl;
-                }
+                cancel_ids.push_back(order_id);
+                cancel_instruments.push_back(id);
             }
         }
         
-        // 兜底：按 remark 匹配
+        // 兜底：按订单标签（策略 + 证券）匹配
         if (cancel_try == 0) {
-            for (const auto& order : orders) {
-                if (order.remark == remark) {
-                    if (order.status != OrderResult::Status::FILLED &&
-                        order.status != OrderResult::Status::CANCELLED &&
-                        order.status != OrderResult::Status::REJECTED) {
-                        if (api_->cancel_order(order.order_id)) {
-                            cancel_count++;
-                            std::cout << "  Cancelled: " << symbol 
-                                      << ", order_id=" << order.order_id << std::endl;
-                        }
-                    }
+            for (const OrderResult& order : orders) {
+                if (order.status != OrderResult::Status::FILLED &&
+                    order.status != OrderResult::Status::CANCELLED &&
+                    order.status != OrderResult::Status::REJECTED) {
+                    cancel_ids.push_back(order.order_id);
+                    cancel_instruments.push_back(id);
                 }
             }
         }
         
         // 标记已处理回调
-        callbacks_[symbol] = 1;
+        callbacks_[id] = 1;
+    }
+    
+    // 一次提交全部撤单
+    std::vector<bool> cancelled = api_->cancel_orders(cancel_ids);
+    for (size_t i = 0; i < cancel_ids.size(); ++i) {
+        if (cancelled[i]) {
+            cancel_count++;
+            std::cout << "  Cancelled: " << InstrumentRegistry::instance().symbol(cancel_instruments[i]) 
+                      << ", order_id=" << cancel_ids[i] << std::endl;
+        }
     }
     
     std::cout << "Total cancelled: " << cancel_count << " orders" << std::endl;
@@ -288,8 +309,10 @@ void CloseSellStrategy::phase3_test_sell() {
     
     auto positions = api_->query_positions();
     
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
     for (const auto& pos : positions) {
         const std::string& symbol = pos.symbol;
+        InstrumentId id = registry.find(symbol);
         
         // txt line 165-167: 检查可用仓位
         if (pos.available <= 0) {
@@ -315,15 +338,15 @@ void CloseSellStrategy::phase3_test_sell() {
         int64_t vol = 100;
         
         // 获取行情 - txt line 172-183
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (!snap.valid) {
             continue;
         }
         
-        double buy_price1 = snap.bid_price1;
+        double buy_price1 = snap.bid_price(0);
         
         // 获取涨跌停价
-        auto limits = api_->get_limits(symbol);
+        auto limits = api_->get_limits(id);
         double zt_price = limits.first;
         double dt_price = limits.second;
         
@@ -350,15 +373,16 @@ void CloseSellStrategy::phase3_test_sell() {
         OrderRequest req;
         req.account_id = account_id_;
         req.symbol = symbol;
+        req.instrument = id;
         req.price = sell_price;
         req.volume = vol;
         req.is_market = false;
-        req.remark = "收盘卖出" + symbol;
+        req.tag = next_order_tag(StrategyIds::kCloseSell, id);
         
         std::string order_id = api_->place_order(req);
         
-        if (!order_id.empty()) {
-            auto& ids = order_ids_[symbol];
+        if (!order_id.empty() && id != kInvalidInstrument) {
+            auto& ids = order_ids_[id];
             if (std::find(ids.begin(), ids.end(), order_id) == ids.end()) {
                 ids.push_back(order_id);
             }
@@ -373,8 +397,10 @@ void CloseSellStrategy::phase4_bulk_sell() {
     
     auto positions = api_->query_positions();
     
+    InstrumentRegistry& registry = InstrumentRegistry::instance();
     for (const auto& pos : positions) {
         const std::string& symbol = pos.symbol;
+        InstrumentId id = registry.find(symbol);
         
         // txt line 201-202: 检查可用仓位
         if (pos.available <= 0) {
@@ -402,15 +428,15 @@ void CloseSellStrategy::phase4_bulk_sell() {
         }
         
         // 获取行情 - txt line 212-223
-        MarketSnapshot snap = api_->get_snapshot(symbol);
+        MarketSnapshot snap = api_->get_snapshot(id);
         if (!snap.valid) {
             continue;
         }
         
-        double buy_price1 = snap.bid_price1;
+        double buy_price1 = snap.bid_price(0);
         
         // 获取涨跌停价
-        auto limits = api_->get_limits(symbol);
+        auto limits = api_->get_limits(id);
         double zt_price = limits.first;
         double dt_price = limits.second;
         
@@ -437,15 +463,16 @@ void CloseSellStrategy::phase4_bulk_sell() {
         OrderRequest req;
         req.account_id = account_id_;
         req.symbol = symbol;
+        req.instrument = id;
         req.price = sell_price;
         req.volume = vol;
         req.is_market = false;
-        req.remark = "收盘卖出" + symbol;
+        req.tag = next_order_tag(StrategyIds::kCloseSell, id);
         
         std::string order_id = api_->place_order(req);
         
-        if (!order_id.empty()) {
-            auto& ids = order_ids_[symbol];
+        if (!order_id.empty() && id != kInvalidInstrument) {
+            auto& ids = order_ids_[id];
             if (std::find(ids.begin(), ids.end(), order_id) == ids.end()) {
                 ids.push_back(order_id);
             }
@@ -471,15 +498,17 @@ void CloseSellStrategy::print_status() const {
     std::cout << "Total stocks: " << total_volumes_.size() << std::endl;
     
     int64_t total_sold = 0;
-    for (const auto& pair : sold_volumes_) {
-        total_sold += pair.second;
-        double sold_ratio = (total_volumes_.at(pair.first) > 0) 
-            ? static_cast<double>(pair.second) / total_volumes_.at(pair.first) 
+    sold_volumes_.for_each([&](InstrumentId id, int64_t sold) {
+        total_sold += sold;
+        const int64_t* total = total_volumes_.find(id);
+        int64_t total_vol = total ? *total : 0;
+        double sold_ratio = (total_vol > 0) 
+            ? static_cast<double>(sold) / total_vol 
             : 0.0;
-        std::cout << "  " << pair.first << ": sold=" << pair.second 
-                  << "/" << total_volumes_.at(pair.first) 
+        std::cout << "  " << InstrumentRegistry::instance().symbol(id) << ": sold=" << sold 
+                  << "/" << total_vol 
                   << " (" << (sold_ratio * 100) << "%)" << std::endl;
-    }
+    });
     
     std::cout << "Total sold volume: " << total_sold << std::endl;
 }
@@ -2,9 +2,7 @@
 #include "../core/TradingMarketApi.h"
 #include <string>
 #include <vector>
-#include <map>
 #include <random>
-#include <unordered_map>
 
 /// @brief 收盘卖出策略（对应 qh2h收盘卖出.txt）
 /// 时间窗口：14:53:00-14:56:45
@@ -49,27 +47,27 @@ private:
     int64_t hold_vol_ = 300;           // 底仓数量
     double trigger_probability_ = 0.15; // 触发概率
     
-    // 运行时数据: symbol -> sold_vol
-    std::map<std::string, int64_t> sold_volumes_;
+    // 运行时数据: instrument -> sold_vol
+    InstrumentMap<int64_t> sold_volumes_;
     
-    // 运行时数据: symbol -> total_vol
-    std::map<std::string, int64_t> total_volumes_;
+    // 运行时数据: instrument -> total_vol
+    InstrumentMap<int64_t> total_volumes_;
     
-    // 运行时数据: symbol -> remark
-    std::map<std::string, std::string> remarks_;
+    // 运行时数据: instrument -> 最近一次委托的订单标签（0 表示未下单）
+    InstrumentMap<OrderTag> tags_;
 
-    // 运行时数据: symbol -> order_id list
-    std::map<std::string, std::vector<std::string>> order_ids_;
+    // 运行时数据: instrument -> order_id list
+    InstrumentMap<std::vector<std::string>> order_ids_;
     
-    // 运行时数据: symbol -> callback flag
-    std::map<std::string, int> callbacks_;
+    // 运行时数据: instrument -> callback flag
+    InstrumentMap<int> callbacks_;
     
     // 阶段控制标志
     int phase2_cancel_done_ = 0;
     int phase3_test_sell_done_ = 0;
     int phase4_bulk_sell_done_ = 0;
     // phase1 启动时记录的可用持仓基数（用于计算70%限制）
-    std::unordered_map<std::string, int64_t> phase1_base_available_;
+    InstrumentMap<int64_t> phase1_base_available_;
     bool phase1_base_recorded_ = false;  // 是否已记录基数
     // 随机数生成器
     std::mt19937 rng_;
@@ -2,7 +2,6 @@
 #include "../core/util.h"
 #include <iostream>
 #include <chrono>
-#include <thread>
 #include <iomanip>
 #include <ctime>
 #include <cmath>
@@ -145,6 +144,7 @@ void IntradaySellStrategy::execute_sell() {
     }
     
     // 遍历所有股票
+    std::vector<OrderRequest> reqs;
     for (const auto& symbol : csv_config_.get_all_symbols()) {
         auto* stock = csv_config_.get_stock(symbol);
         if (!stock) continue;
@@ -209,7 +209,7 @@ void IntradaySellStrategy::execute_sell() {
                           << ", time_window=" << window.start_time << "-" << window.end_time
                           << ", keep=" << window.keep_position << std::endl;
                 
-                sell_order(symbol, window.keep_position, now);
+                sell_order(symbol, window.keep_position, now, reqs);
                 placed = true;
                 break;
             }
@@ -223,12 +223,23 @@ void IntradaySellStrategy::execute_sell() {
             std::cout << std::endl;
         }
     }
+    
+    // 本轮全部卖单一次批量委托，14:49 撤单时同批各腿可整批撤回
+    std::vector<std::string> order_ids = api_->place_orders(reqs);
+    for (size_t i = 0; i < reqs.size(); ++i) {
+        if (!order_ids[i].empty()) {
+            on_order_placed(reqs[i], order_ids[i]);
+        } else {
+            std::cerr << "    ✗ Order failed: " << reqs[i].symbol << std::endl;
+        }
+    }
 }
 
 void IntradaySellStrategy::sell_order(
     const std::string& symbol,
     double keep_position,
-    int current_time
+    int current_time,
+    std::vector<OrderRequest>& reqs
 ) {
     auto* stock = csv_config_.get_stock(symbol);
     if (!stock) return;
@@ -280,8 +291,8 @@ void IntradaySellStrategy::sell_order(
         return;
     }
     
-    double buy_price1 = snapshot.bid_price1;
-    double sell_price1 = snapshot.ask_price1;
+    double buy_price1 = snapshot.bid_price(0);
+    double sell_price1 = snapshot.ask_price(0);
     
     // txt line 225-227: 涨停判断
     if (stock->zt_price > 0 && std::abs(buy_price1 - stock->zt_price) < 0.01) {
@@ -317,51 +328,48 @@ void IntradaySellStrategy::sell_order(
     OrderRequest req;
     req.account_id = account_id_;
     req.symbol = symbol;
+    req.instrument = stock->id;
     req.price = sell_price;
     req.volume = vol;
     req.is_market = false;
-    req.remark = "盘中卖出" + symbol;
-    
-    std::string order_id = api_->place_order(req);
-    
-    if (!order_id.empty()) {
-        stock->sold_vol += vol;
-        stock->remark = "盘中卖出" + symbol;
-        std::cout << "    ✓ Order placed: " << order_id << std::endl;
+    req.tag = next_order_tag(StrategyIds::kIntradaySell, stock->id);
+    reqs.push_back(req);
+}
+
+void IntradaySellStrategy::on_order_placed(const OrderRequest& req, const std::string& order_id) {
+    auto* stock = csv_config_.get_stock(req.symbol);
+    if (stock) {
+        stock->sold_vol += req.volume;
+        stock->order_tag = req.tag;
+    }
+    std::cout << "    ✓ Order placed: " << req.symbol << " " << order_id << std::endl;
+    
+    // 【新增】查询订单状态（按委托号单行查询）
+    OrderResult order = api_->query_order(order_id);
+    if (order.success) {
+        std::cout << "    订单状态: ";
+        switch (order.status) {
+            case OrderResult::Status::SUBMITTED:
+                std::cout << "已提交"; break;
+            case OrderResult::Status::PARTIAL:
+                std::cout << "部分成交 (" << order.filled_volume << "/" << order.volume << ")"; break;
+            case OrderResult::Status::FILLED:
+                std::cout << "全部成交"; break;
+            case OrderResult::Status::CANCELLED:
+                std::cout << "已撤单"; break;
+            case OrderResult::Status::REJECTED:
+                std::cout << "已拒绝"; break;
+            default:
+                std::cout << "未知";
+        }
+        std::cout << std::endl;
         
-        // 【新增】查询订单状态（延迟后查询最新状态）
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        auto orders = api_->query_orders();
-        for (const auto& order : orders) {
-            if (order.order_id == order_id) {
-                std::cout << "    订单状态: ";
-                switch (order.status) {
-                    case OrderResult::Status::SUBMITTED:
-                        std::cout << "已提交"; break;
-                    case OrderResult::Status::PARTIAL:
-                        std::cout << "部分成交 (" << order.filled_volume << "/" << order.volume << ")"; break;
-                    case OrderResult::Status::FILLED:
-                        std::cout << "全部成交"; break;
-                    case OrderResult::Status::CANCELLED:
-                        std::cout << "已撤单"; break;
-                    case OrderResult::Status::REJECTED:
-                        std::cout << "已拒绝"; break;
-                    default:
-                        std::cout << "未知";
-                }
-                std::cout << std::endl;
-                
-                if (order.filled_volume > 0) {
-                    double avg_price = (order.filled_volume > 0) ? 
-                        (order.price * order.filled_volume) / order.filled_volume : 0.0;
-                    std::cout << "    成交信息: 已成交 " << order.filled_volume 
-                             << " 股，剩余 " << (order.volume - order.filled_volume) << " 股" << std::endl;
-                }
-                break;
-            }
+        if (order.filled_volume > 0) {
+            double avg_price = (order.filled_volume > 0) ? 
+                (order.price * order.filled_volume) / order.filled_volume : 0.0;
+            std::cout << "    成交信息: 已成交 " << order.filled_volume 
+                     << " 股，剩余 " << (order.volume - order.filled_volume) << " 股" << std::endl;
         }
-    } else {
-        std::cerr << "    ✗ Order failed!" << std::endl;
     }
 }
 
@@ -381,56 +389,68 @@ void IntradaySellStrategy::cancel_orders() {
     
     // txt line 176-190逻辑:
     // 1. 获取所有订单列表 get_trade_detail_data(MyaccountID, 'STOCK', 'order')
-    // 2. 遍历订单，精确匹配remark字段
+    // 2. 遍历订单，按订单标签（策略 + 证券）匹配
     // 3. 如果订单状态不是已成交(56)，则撤单
     
-    auto orders = api_->query_orders();
-    std::cout << "查询到 " << orders.size() << " 个订单" << std::endl;
+    std::vector<std::string> symbols = csv_config_.get_all_symbols();
+    std::vector<uint32_t> keys(symbols.size(), 0);
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (auto* stock = csv_config_.get_stock(symbols[i])) {
+            keys[i] = order_tag_key(make_order_tag(StrategyIds::kIntradaySell, stock->id, 0));
+        }
+    }
+    // 按订单标签键（策略 + 证券）读本地订单簿，不支持时退回一次全量查询
+    std::vector<std::vector<OrderResult>> orders_by_key = api_->query_orders_by_tags(keys);
     
     int cancel_count = 0;
     int checked_count = 0;
+    std::vector<std::string> cancel_ids;
+    std::vector<std::string> cancel_symbols;
     
     // 遍历CSV中的所有股票
-    for (const auto& symbol : csv_config_.get_all_symbols()) {
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const std::string& symbol = symbols[i];
         auto* stock = csv_config_.get_stock(symbol);
         if (!stock) continue;
         
-        // 匹配remark
-        std::string expected_remark = "盘中卖出" + symbol;
-        
-        for (const auto& order : orders) {
-            // txt: if order.m_strRemark == df.loc[key,'remark']
-            // 精确匹配且状态不是已成交(FILLED)
-            if (order.remark == expected_remark) {
-                checked_count++;
-                std::cout << "  检查订单: " << symbol << " order_id=" << order.order_id 
-                         << " status=";
-                switch (order.status) {
-                    case OrderResult::Status::SUBMITTED: std::cout << "已提交"; break;
-                    case OrderResult::Status::PARTIAL: std::cout << "部分成交"; break;
-                    case OrderResult::Status::FILLED: std::cout << "全部成交"; break;
-                    case OrderResult::Status::CANCELLED: std::cout << "已撤单"; break;
-                    case OrderResult::Status::REJECTED: std::cout << "已拒绝"; break;
-                    default: std::cout << "未知";
-                }
-                std::cout << " filled=" << order.filled_volume << "/" << order.volume << std::endl;
-                
-                if (order.status == OrderResult::Status::SUBMITTED ||
-                    order.status == OrderResult::Status::PARTIAL) {
-                    if (api_->cancel_order(order.order_id)) {
-                        cancel_count++;
-                        std::cout << "    ✓ Cancelled order: " << symbol 
-                                  << ", order_id=" << order.order_id << std::endl;
-                    } else {
-                        std::cout << "    ✗ Cancel failed: " << symbol << std::endl;
-                    }
-                }
+        // txt: if order.m_strRemark == df.loc[key,'remark']（备注改为订单标签）
+        // 状态不是已成交(FILLED)
+        for (const OrderResult& order : orders_by_key[i]) {
+            checked_count++;
+            std::cout << "  检查订单: " << symbol << " order_id=" << order.order_id 
+                     << " status=";
+            switch (order.status) {
+                case OrderResult::Status::SUBMITTED: std::cout << "已提交"; break;
+                case OrderResult::Status::PARTIAL: std::cout << "部分成交"; break;
+                case OrderResult::Status::FILLED: std::cout << "全部成交"; break;
+                case OrderResult::Status::CANCELLED: std::cout << "已撤单"; break;
+                case OrderResult::Status::REJECTED: std::cout << "已拒绝"; break;
+                default: std::cout << "未知";
+            }
+            std::cout << " filled=" << order.filled_volume << "/" << order.volume << std::endl;
+            
+            if (order.status == OrderResult::Status::SUBMITTED ||
+                order.status == OrderResult::Status::PARTIAL) {
+                cancel_ids.push_back(order.order_id);
+                cancel_symbols.push_back(symbol);
             }
         }
         
         stock->call_back = 1;  // 标记已处理
     }
     
+    // 一次提交全部撤单
+    std::vector<bool> cancelled = api_->cancel_orders(cancel_ids);
+    for (size_t i = 0; i < cancel_ids.size(); ++i) {
+        if (cancelled[i]) {
+            cancel_count++;
+            std::cout << "    ✓ Cancelled order: " << cancel_symbols[i] 
+                      << ", order_id=" << cancel_ids[i] << std::endl;
+        } else {
+            std::cout << "    ✗ Cancel failed: " << cancel_symbols[i] << std::endl;
+        }
+    }
+    
     std::cout << "检查了 " << checked_count << " 个订单，成功撤单 " << cancel_count << " 个" << std::endl;
 }
 
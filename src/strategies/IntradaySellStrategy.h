@@ -75,12 +75,17 @@ private:
     /// @param symbol 股票代码
     /// @param keep_position 保留仓位比例
     /// @param current_time 当前时间 HHMMSS
+    /// @param reqs 需要卖出时追加委托请求，由 execute_sell 本轮统一批量委托
     void sell_order(
         const std::string& symbol,
         double keep_position,
-        int current_time
+        int current_time,
+        std::vector<OrderRequest>& reqs
     );
     
+    /// @brief 委托成功后的记账与订单状态打印
+    void on_order_placed(const OrderRequest& req, const std::string& order_id);
+    
     /// @brief 获取当前时间 HHMMSS格式
     int get_current_time() const;
     
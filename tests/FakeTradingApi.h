@@ -0,0 +1,119 @@
+#pragma once
+// 测试用 ITradingApi：记录执行顺序，可在调用入口阻塞（hold/release），用于检查
+// QueuedTradingApi 的排队、合并与限速行为
+
+#include "ITradingApi.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class FakeTradingApi : public ITradingApi {
+public:
+    /// @brief 之后进入的调用在执行前阻塞，直到 release()
+    void hold() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_ = false;
+        }
+        cv_.notify_all();
+    }
+
+    /// @brief 等到有调用阻塞在入口；超时返回 false
+    bool wait_blocked(int timeout_ms = 2000) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return blocked_ > 0; });
+    }
+
+    /// @brief 已执行的调用（按执行顺序），如 "place:600000.SH"、"cancel:1"、"query_orders"
+    std::vector<std::string> calls() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return calls_;
+    }
+
+    size_t count(const std::string& call) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t n = 0;
+        for (const auto& c : calls_) {
+            n += (c == call) ? 1 : 0;
+        }
+        return n;
+    }
+
+    bool connect(const std::string&, int, const std::string&, const std::string&) override {
+        enter("connect");
+        return true;
+    }
+
+    void disconnect() override { enter("disconnect"); }
+
+    bool is_connected() const override { return true; }
+
+    std::string place_order(const OrderRequest& req) override {
+        enter("place:" + req.symbol);
+        std::lock_guard<std::mutex> lock(mutex_);
+        OrderResult order;
+        order.success = true;
+        order.order_id = std::to_string(++next_id_);
+        order.symbol = req.symbol;
+        order.volume = req.volume;
+        placed_.push_back(order);
+        accounts_.push_back(req.account_id);
+        return order.order_id;
+    }
+
+    bool cancel_order(const std::string& order_id) override {
+        enter("cancel:" + order_id);
+        return true;
+    }
+
+    std::vector<Position> query_positions() override {
+        enter("query_positions");
+        return std::vector<Position>();
+    }
+
+    bool order_route(const std::string& order_id, std::string& account, std::string& symbol) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < placed_.size(); ++i) {
+            if (placed_[i].order_id == order_id) {
+                account = accounts_[i];
+                symbol = placed_[i].symbol;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief 返回截至执行时已下的全部订单
+    std::vector<OrderResult> query_orders() override {
+        enter("query_orders");
+        std::lock_guard<std::mutex> lock(mutex_);
+        return placed_;
+    }
+
+private:
+    void enter(const std::string& call) const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++blocked_;
+        cv_.notify_all();
+        cv_.wait(lock, [this]() { return !held_; });
+        --blocked_;
+        calls_.push_back(call);
+    }
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+    mutable std::vector<std::string> calls_;
+    mutable int blocked_ = 0;
+    bool held_ = false;
+    int next_id_ = 0;
+    std::vector<OrderResult> placed_;
+    std::vector<std::string> accounts_;
+};
@@ -0,0 +1,34 @@
+#pragma once
+// 测试用最小断言工具：失败时打印位置并计数，main 末尾以 TEST_RESULT() 返回退出码
+
+#include <cstdio>
+#include <iostream>
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++test_failures();                                                        \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                    \
+    do {                                                                              \
+        auto check_a_ = (actual);                                                     \
+        auto check_e_ = (expected);                                                   \
+        if (!(check_a_ == check_e_)) {                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ failed: " #actual \
+                      << " = " << check_a_ << ", expected " << check_e_ << std::endl; \
+            ++test_failures();                                                        \
+        }                                                                             \
+    } while (0)
+
+#define TEST_RESULT()                                                                 \
+    (std::printf("%s: %s (%d failure(s))\n", __FILE__,                                \
+                 test_failures() ? "FAILED" : "OK", test_failures()),                 \
+     test_failures() ? 1 : 0)
@@ -0,0 +1,424 @@
+#include "MockSecItpdk.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int64 kToken = 7001;
+
+struct PendingConfirm {
+    Clock::time_point due;
+    stStructOrderFuncMsg msg;
+};
+
+struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    pStructMessageCallbackMethod on_push = nullptr;
+    pStructOrderAsyncCallbackFunc on_async = nullptr;
+    std::vector<ITPDK_ZQGL> positions;
+    std::vector<int64> kfsbdbhs;
+    std::map<int64, int64> sys_by_kfsbdbh;
+    std::deque<PendingConfirm> confirms;
+    std::string last_error;
+    std::string fail_next;
+    std::string reject_code;
+    std::vector<BatchOrderInfo> last_batch;
+    int64 last_batch_no = 0;
+    std::function<void(const std::string&)> hook;
+    int64 next_sys_id = 5000001;
+    int delay_ms = 0;
+    bool paused = false;
+    bool reject = false;
+    int requests = 0;
+    int confirmed = 0;
+    int64 last_withdraw_kfsbdbh = 0;
+    bool stop = false;
+    std::thread worker;
+
+    ~State() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+// 回报线程：按到期时间依次送出异步确认，回调在锁外执行
+void confirm_loop() {
+    State& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    while (!s.stop) {
+        if (s.paused || s.confirms.empty()) {
+            s.cv.wait(lock);
+            continue;
+        }
+        Clock::time_point due = s.confirms.front().due;
+        if (Clock::now() < due) {
+            s.cv.wait_until(lock, due);
+            continue;
+        }
+        stStructOrderFuncMsg msg = s.confirms.front().msg;
+        s.confirms.pop_front();
+        pStructOrderAsyncCallbackFunc callback = s.on_async;
+        lock.unlock();
+        if (callback) {
+            callback("", msg, 0);
+        }
+        lock.lock();
+        ++s.confirmed;
+        s.cv.notify_all();
+    }
+}
+
+// 调用测试设置的入口钩子（锁外调用，钩子内可以再调用桩接口）
+void call_hook(const char* entry) {
+    State& s = state();
+    std::function<void(const std::string&)> hook;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        hook = s.hook;
+    }
+    if (hook) {
+        hook(entry);
+    }
+}
+
+// 消耗一次下单失败设置；需持有 mutex
+bool take_failure(State& s) {
+    if (s.fail_next.empty()) {
+        return false;
+    }
+    s.last_error = s.fail_next;
+    s.fail_next.clear();
+    return true;
+}
+
+void copy_text(char* dst, size_t n, const char* src) {
+    std::strncpy(dst, src, n - 1);
+    dst[n - 1] = '\0';
+}
+
+}  // namespace
+
+namespace mock_itpdk {
+
+void reset() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.positions.clear();
+    s.kfsbdbhs.clear();
+    s.sys_by_kfsbdbh.clear();
+    s.confirms.clear();
+    s.last_error.clear();
+    s.fail_next.clear();
+    s.reject_code.clear();
+    s.last_batch.clear();
+    s.last_batch_no = 0;
+    s.hook = nullptr;
+    s.delay_ms = 0;
+    s.paused = false;
+    s.reject = false;
+    s.requests = 0;
+    s.confirmed = 0;
+    s.last_withdraw_kfsbdbh = 0;
+}
+
+void set_position(const char* market, const char* code, const char* gdh, int64 qty, int64 available) {
+    ITPDK_ZQGL row;
+    std::memset(&row, 0, sizeof(row));
+    copy_text(row.Market, sizeof(row.Market), market);
+    copy_text(row.StockCode, sizeof(row.StockCode), code);
+    copy_text(row.SecuAccount, sizeof(row.SecuAccount), gdh);
+    row.CurrentQty = qty;
+    row.QtyAvl = available;
+    row.FrozenQty = qty - available;
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (ITPDK_ZQGL& existing : s.positions) {
+        if (std::strcmp(existing.Market, row.Market) == 0 && std::strcmp(existing.StockCode, row.StockCode) == 0) {
+            row.BrowIndex = existing.BrowIndex;
+            existing = row;
+            return;
+        }
+    }
+    row.BrowIndex = static_cast<int64>(s.positions.size()) + 1;
+    s.positions.push_back(row);
+}
+
+void set_confirm_delay_ms(int delay_ms) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.delay_ms = delay_ms;
+}
+
+void pause_confirms(bool paused) {
+    State& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.paused = paused;
+    }
+    s.cv.notify_all();
+}
+
+void reject_async(bool reject) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.reject = reject;
+}
+
+void fail_next_order(const char* message) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.fail_next = message;
+}
+
+void reject_batch_code(const char* code) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.reject_code = code;
+}
+
+int64 last_batch_no() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.last_batch_no;
+}
+
+int64 batch_wth(int k) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return (k >= 0 && k < static_cast<int>(s.last_batch.size())) ? s.last_batch[static_cast<size_t>(k)].Wth : 0;
+}
+
+void set_call_hook(std::function<void(const std::string& entry)> hook) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.hook = std::move(hook);
+}
+
+bool wait_confirms(int timeout_ms) {
+    State& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    return s.cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                         [&s]() { return s.confirmed == s.requests; });
+}
+
+int async_requests() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.requests;
+}
+
+int async_confirms() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.confirmed;
+}
+
+int64 last_withdraw_kfsbdbh() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.last_withdraw_kfsbdbh;
+}
+
+int64 async_kfsbdbh(int n) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return (n >= 0 && n < static_cast<int>(s.kfsbdbhs.size())) ? s.kfsbdbhs[static_cast<size_t>(n)] : 0;
+}
+
+int64 sys_id_of(int64 kfsbdbh) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.sys_by_kfsbdbh.find(kfsbdbh);
+    return it == s.sys_by_kfsbdbh.end() ? 0 : it->second;
+}
+
+bool push(stStructMsg& msg, int type) {
+    pStructMessageCallbackMethod callback = nullptr;
+    {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        callback = s.on_push;
+    }
+    if (!callback) {
+        return false;
+    }
+    msg.nStructToken = static_cast<uint64>(kToken);
+    callback("", msg, type);
+    return true;
+}
+
+}  // namespace mock_itpdk
+
+// ==================== SECITPDK_* 入口 ====================
+
+void SECITPDK_GetVersion(char* buffer) {
+    std::strcpy(buffer, "mock");
+}
+
+void SECITPDK_SetLogPath(const char*) {}
+
+void SECITPDK_SetProfilePath(const char*) {}
+
+void SECITPDK_SetWriteLog(bool) {}
+
+void SECITPDK_SetFixWriteLog(bool) {}
+
+bool SECITPDK_Init(int) {
+    return true;
+}
+
+void SECITPDK_Exit() {}
+
+int64 SECITPDK_GetLastError(char* result_msg) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::strcpy(result_msg, s.last_error.c_str());
+    return s.last_error.empty() ? 0 : -1;
+}
+
+void SECITPDK_SetStructMsgCallback(pStructMessageCallbackMethod func) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.on_push = func;
+}
+
+void SECITPDK_SetStructOrderFuncCallback(pStructOrderAsyncCallbackFunc func) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.on_async = func;
+}
+
+bool SECITPDK_SetNode(const char*) {
+    return true;
+}
+
+bool SECITPDK_SetWTFS(const char*) {
+    return true;
+}
+
+int64 SECITPDK_TradeLogin(const char*, const char*, const char*) {
+    return kToken;
+}
+
+int64 SECITPDK_OrderEntrust(const char*, const char*, const char*, int, int64, double, int64, const char*) {
+    call_hook("OrderEntrust");
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (take_failure(s)) {
+        return -1;
+    }
+    return s.next_sys_id++;
+}
+
+int64 SECITPDK_OrderEntrust_ASync(const char* lpKhh, const char*, const char*, int nJylb, int64, double,
+                                  int64, const char*, int64 nKFSBDBH) {
+    call_hook("OrderEntrust_ASync");
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (take_failure(s)) {
+        return -1;
+    }
+    PendingConfirm pending;
+    pending.due = Clock::now() + std::chrono::milliseconds(s.delay_ms);
+    copy_text(pending.msg.AccountId, sizeof(pending.msg.AccountId), lpKhh);
+    std::snprintf(pending.msg.KFSBDBH, sizeof(pending.msg.KFSBDBH), "%lld", static_cast<long long>(nKFSBDBH));
+    pending.msg.EntrustType = static_cast<uint8>(nJylb);
+    if (s.reject) {
+        pending.msg.nRetCode = -1;
+        copy_text(pending.msg.sRetNote, sizeof(pending.msg.sRetNote), "mock reject");
+    } else {
+        pending.msg.OrderId = s.next_sys_id++;
+        s.sys_by_kfsbdbh[nKFSBDBH] = pending.msg.OrderId;
+    }
+    s.confirms.push_back(pending);
+    s.kfsbdbhs.push_back(nKFSBDBH);
+    ++s.requests;
+    if (!s.worker.joinable()) {
+        s.worker = std::thread(confirm_loop);
+    }
+    s.cv.notify_all();
+    return 0;
+}
+
+int64 SECITPDK_BatchOrderEntrust(const char*, vector<BatchOrderInfo>& arBatOrder, int64 nLSH) {
+    State& s = state();
+    int64 rejected = 0;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (take_failure(s)) {
+            return -1;
+        }
+        for (BatchOrderInfo& leg : arBatOrder) {
+            if (!s.reject_code.empty() && s.reject_code == leg.Zqdm) {
+                leg.Wth = -1;
+                copy_text(leg.Msg, sizeof(leg.Msg), "mock reject");
+                ++rejected;
+                continue;
+            }
+            leg.Wth = s.next_sys_id++;
+        }
+        s.last_batch = arBatOrder;
+        s.last_batch_no = nLSH;
+    }
+    call_hook("BatchOrderEntrust");  // 委托号已分配、调用尚未返回
+    return rejected;
+}
+
+int64 SECITPDK_OrderWithdraw(const char*, const char*, int64 nCxwth) {
+    return nCxwth;
+}
+
+int64 SECITPDK_OrderWithdrawByKFSBDBH(const char*, const char*, int64 nCXKFSBDBH) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.last_withdraw_kfsbdbh = nCXKFSBDBH;
+    return nCXKFSBDBH;
+}
+
+int64 SECITPDK_BatchOrderWithdraw(const char*, int64 nLSH) {
+    return nLSH;
+}
+
+int64 SECITPDK_QueryOrders(const char*, int, int, int, int64, const char*, const char*, int64,
+                           vector<ITPDK_DRWT>& arDrwt, int64) {
+    arDrwt.clear();
+    return 0;
+}
+
+int64 SECITPDK_QueryPositions(const char*, int, int nRowcount, int64 nBrowindex, const char*, const char*,
+                              const char*, int32, vector<ITPDK_ZQGL>& arZqgl) {
+    State& s = state();
+    std::vector<ITPDK_ZQGL> rows;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        rows = s.positions;
+    }
+    call_hook("QueryPositions");  // 柜台结果已定，之后到达的推送不反映在本次结果中
+    arZqgl.clear();
+    for (const ITPDK_ZQGL& row : rows) {
+        if (row.BrowIndex > nBrowindex && static_cast<int>(arZqgl.size()) < nRowcount) {
+            arZqgl.push_back(row);
+        }
+    }
+    return static_cast<int64>(arZqgl.size());
+}
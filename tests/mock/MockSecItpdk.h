@@ -0,0 +1,68 @@
+#pragma once
+// SECITPDK 接口桩：实现 SecTradingApi 用到的 SECITPDK_* 入口，不连接柜台
+//
+// - TradeLogin 返回固定令牌，QueryPositions 返回 set_position 设置的柜台持仓（含股东号）；
+// - OrderEntrust / BatchOrderEntrust 同步返回递增的委托号；
+// - OrderEntrust_ASync 立即返回，确认由桩内的回报线程在 set_confirm_delay_ms 指定的延迟后
+//   经 SetStructOrderFuncCallback 登记的回调送出（与柜台一样不在下单线程上回调）；
+// - 测试可用 push 以 SetStructMsgCallback 登记的回调模拟委托/成交/撤单/废单推送。
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "secitpdk/secitpdk.h"
+#include "secitpdk/secitpdk_struct.h"
+
+namespace mock_itpdk {
+
+/// @brief 恢复初始状态（清空持仓、委托记录与计数，停止并清空待送出的确认）
+void reset();
+
+/// @brief 设置 QueryPositions 返回的一行持仓（同一证券覆盖）；market 为 "SH"/"SZ"，gdh 为股东号
+void set_position(const char* market, const char* code, const char* gdh, int64 qty, int64 available);
+
+/// @brief 异步委托确认的送出延迟（毫秒）
+void set_confirm_delay_ms(int delay_ms);
+
+/// @brief 暂停/恢复送出异步确认；暂停期间的确认排队，恢复后按下单顺序送出
+void pause_confirms(bool paused);
+
+/// @brief 之后的异步委托被柜台拒绝（确认回调 nRetCode<0，不分配委托号）
+void reject_async(bool reject);
+
+/// @brief 等待已排队的异步确认全部送出；超时返回 false
+bool wait_confirms(int timeout_ms);
+
+/// @brief 下一笔 OrderEntrust / OrderEntrust_ASync / BatchOrderEntrust 返回失败，GetLastError 返回 message
+void fail_next_order(const char* message);
+
+/// @brief 之后的批量委托中证券代码为 code 的腿被拒绝（Wth<0）；传空串取消
+void reject_batch_code(const char* code);
+
+/// @brief 最近一次批量委托的批次号与第 k 条腿（从 0 起）的 Wth；越界时为 0
+int64 last_batch_no();
+int64 batch_wth(int k);
+
+/// @brief 在 OrderEntrust / OrderEntrust_ASync / QueryPositions 入口（返回结果之前）、
+/// BatchOrderEntrust 分配委托号之后返回之前调用 hook，参数为入口名；用于模拟调用期间到达的推送。传空函数取消
+void set_call_hook(std::function<void(const std::string& entry)> hook);
+
+/// @brief 异步委托请求数 / 已送出的确认数
+int async_requests();
+int async_confirms();
+
+/// @brief 最近一次按开发商本地编号撤单的编号（未调用过时为 0）
+int64 last_withdraw_kfsbdbh();
+
+/// @brief 第 n 个异步委托（从 0 起）的开发商本地编号；越界时为 0
+int64 async_kfsbdbh(int n);
+
+/// @brief 开发商本地编号对应的柜台委托号（被拒绝或未知时为 0）
+int64 sys_id_of(int64 kfsbdbh);
+
+/// @brief 以 SetStructMsgCallback 登记的回调送出一条推送（nType 为 NOTIFY_PUSH_*）
+bool push(stStructMsg& msg, int type);
+
+}  // namespace mock_itpdk
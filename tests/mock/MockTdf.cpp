@@ -0,0 +1,98 @@
+#include "MockTdf.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace {
+
+struct OpenFeed {
+    TDF_DataMsgHandler on_data = nullptr;
+    TDF_SystemMsgHandler on_system = nullptr;
+};
+
+std::mutex g_mutex;
+std::map<THANDLE, OpenFeed> g_feeds;
+THANDLE g_last = nullptr;
+uintptr_t g_next_handle = 0x7d0000;
+TDF_ERR g_open_error = TDF_ERR_SUCCESS;
+
+}  // namespace
+
+namespace mock_tdf {
+
+THANDLE last_handle() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_last;
+}
+
+void set_open_error(TDF_ERR err) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_open_error = err;
+}
+
+bool deliver(THANDLE handle, int data_type, void* items, int item_size, int item_count,
+             int server_time) {
+    TDF_DataMsgHandler on_data = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_feeds.find(handle);
+        if (it == g_feeds.end()) {
+            return false;
+        }
+        on_data = it->second.on_data;
+    }
+    if (!on_data) {
+        return false;
+    }
+
+    TDF_APP_HEAD head;
+    head.nHeadSize = sizeof(TDF_APP_HEAD);
+    head.nItemCount = item_count;
+    head.nItemSize = item_size;
+
+    TDF_MSG msg = TDF_MSG();
+    msg.nDataType = data_type;
+    msg.nDataLen = item_size * item_count;
+    msg.nServerTime = server_time;
+    msg.pAppHead = &head;
+    msg.pData = items;
+    on_data(handle, &msg);  // 与真实 SDK 一样在锁外回调
+    return true;
+}
+
+}  // namespace mock_tdf
+
+int TDF_SetEnv(TDF_ENVIRON_SETTING, unsigned int) {
+    return TDF_ERR_SUCCESS;
+}
+
+int TDF_SetLogPath(const char*) {
+    return TDF_ERR_SUCCESS;
+}
+
+THANDLE TDF_OpenExt(TDF_OPEN_SETTING_EXT* pSettings, TDF_ERR* pErr) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_open_error != TDF_ERR_SUCCESS || !pSettings) {
+        if (pErr) {
+            *pErr = pSettings ? g_open_error : TDF_ERR_INVALID_PARAMS;
+        }
+        return nullptr;
+    }
+    THANDLE handle = reinterpret_cast<THANDLE>(g_next_handle);
+    g_next_handle += 0x10;
+    OpenFeed& feed = g_feeds[handle];
+    feed.on_data = pSettings->pfnMsgHandler;
+    feed.on_system = pSettings->pfnSysMsgNotify;
+    g_last = handle;
+    if (pErr) {
+        *pErr = TDF_ERR_SUCCESS;
+    }
+    return handle;
+}
+
+int TDF_Close(THANDLE hTdf) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_feeds.erase(hTdf);
+    return TDF_ERR_SUCCESS;
+}
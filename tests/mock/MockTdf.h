@@ -0,0 +1,31 @@
+#pragma once
+// TDF 接口桩：实现 TdfMarketDataApi 用到的 TDF_* 入口，不连接行情服务器
+//
+// TDF_OpenExt 记录回调并返回一个伪造的 THANDLE；测试通过 deliver 以该句柄调用数据回调，
+// 模拟 TDF 推送线程（可在任意线程、多个线程上调用）。
+
+#include "TDFAPI.h"
+#include "TDFAPIStruct.h"
+
+#include <vector>
+
+namespace mock_tdf {
+
+/// @brief 最近一次 TDF_OpenExt 返回的句柄（尚未打开时为 nullptr）
+THANDLE last_handle();
+
+/// @brief 让之后的 TDF_OpenExt 返回指定错误（TDF_ERR_SUCCESS 恢复正常）
+void set_open_error(TDF_ERR err);
+
+/// @brief 以 handle 调用 TDF_OpenExt 登记的数据回调；句柄未打开或已关闭时返回 false
+bool deliver(THANDLE handle, int data_type, void* items, int item_size, int item_count,
+             int server_time = 0);
+
+/// @brief 推送一批结构体（MSG_DATA_MARKET / MSG_DATA_TRANSACTION / MSG_DATA_ORDERQUEUE）
+template <typename T>
+bool deliver(THANDLE handle, int data_type, std::vector<T>& items, int server_time = 0) {
+    return deliver(handle, data_type, items.empty() ? nullptr : &items[0], static_cast<int>(sizeof(T)),
+                   static_cast<int>(items.size()), server_time);
+}
+
+}  // namespace mock_tdf
@@ -0,0 +1,120 @@
+// 行情记录器：写入不同大小（含跨越环形缓冲末尾）的记录后读回日志逐条核对，
+// 检查文件截断到最后一条记录，以及缓冲满时丢弃并计数
+
+#include "TestUtil.h"
+#include "MarketRecorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* kDir = ".";
+
+std::vector<char> read_file(const std::string& path) {
+    std::vector<char> data;
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        return data;
+    }
+    char buf[4096];
+    size_t n = 0;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    std::fclose(f);
+    return data;
+}
+
+/// 第 i 条记录的内容：item_size 随 i 变化，字节按 (i + 偏移) 填充
+std::vector<char> payload(int i, int32_t item_size, int32_t item_count) {
+    std::vector<char> items(static_cast<size_t>(item_size) * static_cast<size_t>(item_count));
+    for (size_t k = 0; k < items.size(); ++k) {
+        items[k] = static_cast<char>(i + static_cast<int>(k));
+    }
+    return items;
+}
+
+int32_t item_size_of(int i) {
+    return 8 + (i * 13) % 200;
+}
+
+void test_round_trip() {
+    const int kRecords = 2000;
+    MarketRecorder recorder(kDir, 4096);  // 小缓冲：记录频繁跨越环形缓冲末尾
+    CHECK(recorder.start());
+    for (int i = 0; i < kRecords; ++i) {
+        int32_t item_count = 1 + i % 3;
+        std::vector<char> items = payload(i, item_size_of(i), item_count);
+        recorder.record(i % 4, 93000000 + i, items.data(), item_size_of(i), item_count, 1000 + i);
+        if (i % 8 == 0) {
+            // 让写线程跟上，避免缓冲满丢弃
+            while (recorder.stats().records + recorder.stats().dropped < static_cast<uint64_t>(i + 1)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    recorder.stop();
+    MarketRecorder::Stats stats = recorder.stats();
+
+    std::vector<char> data = read_file(recorder.path());
+    CHECK_EQ(data.size(), sizeof(MarketRecorder::FileHeader) + stats.bytes);  // 关闭时截掉预分配部分
+    MarketRecorder::FileHeader fh;
+    CHECK(data.size() >= sizeof(fh));
+    std::memcpy(&fh, data.data(), sizeof(fh));
+    CHECK(std::memcmp(fh.magic, MarketRecorder::kMagic, sizeof(fh.magic)) == 0);
+    CHECK_EQ(fh.version, MarketRecorder::kVersion);
+    CHECK_EQ(fh.record_header, sizeof(MarketRecorder::RecordHeader));
+
+    // 逐条核对；丢弃的记录不在日志中，按 server_time 找回序号
+    size_t pos = sizeof(fh);
+    uint64_t seen = 0;
+    int last = -1;
+    while (pos + sizeof(MarketRecorder::RecordHeader) <= data.size()) {
+        MarketRecorder::RecordHeader rh;
+        std::memcpy(&rh, data.data() + pos, sizeof(rh));
+        int i = rh.server_time - 93000000;
+        CHECK(i > last);
+        last = i;
+        CHECK_EQ(rh.data_type, i % 4);
+        CHECK_EQ(rh.item_size, item_size_of(i));
+        CHECK_EQ(rh.item_count, 1 + i % 3);
+        CHECK_EQ(rh.recv_ns, 1000 + i);
+        CHECK_EQ(rh.length % 8, 0u);
+        std::vector<char> items = payload(i, rh.item_size, rh.item_count);
+        CHECK(pos + sizeof(rh) + items.size() <= data.size());
+        CHECK(std::memcmp(data.data() + pos + sizeof(rh), items.data(), items.size()) == 0);
+        pos += rh.length;
+        ++seen;
+    }
+    CHECK_EQ(pos, data.size());
+    CHECK_EQ(seen, stats.records);
+    CHECK_EQ(stats.records + stats.dropped, static_cast<uint64_t>(kRecords));
+    CHECK(stats.records > 0);
+    std::remove(recorder.path().c_str());
+}
+
+/// 写线程未启动时缓冲写满：之后的记录丢弃并计数，不阻塞；启动后写出已缓冲的记录
+void test_drop_when_full() {
+    MarketRecorder recorder(kDir, 256);
+    std::vector<char> items = payload(0, 200, 1);  // 记录长 232 字节
+    recorder.record(1, 93000000, items.data(), 200, 1, 1);
+    recorder.record(1, 93000001, items.data(), 200, 1, 2);
+    CHECK_EQ(recorder.stats().dropped, 1u);
+    CHECK(recorder.start());
+    recorder.stop();
+    CHECK_EQ(recorder.stats().records, 1u);
+    CHECK_EQ(recorder.stats().dropped, 1u);
+    std::remove(recorder.path().c_str());
+}
+
+}  // namespace
+
+int main() {
+    test_round_trip();
+    test_drop_when_full();
+    return TEST_RESULT();
+}
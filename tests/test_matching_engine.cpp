@@ -0,0 +1,156 @@
+// 模拟撮合引擎：连续竞价主动成交外部盘口、按可见排队量估计的被动成交、撤单、
+// 模拟委托之间互相撮合，以及集合竞价结束后的集中撮合
+
+#include "TestUtil.h"
+#include "MatchingEngine.h"
+
+#include <vector>
+
+namespace {
+
+using Event = MatchingEngine::Event;
+
+int64_t px(double yuan) {
+    return static_cast<int64_t>(yuan * kPriceScale + 0.5);
+}
+
+MarketSnapshot snapshot(InstrumentId id, int timestamp, double last, int64_t volume) {
+    MarketSnapshot s;
+    s.instrument = id;
+    s.timestamp = timestamp;
+    s.last_price = last;
+    s.volume = volume;
+    s.valid = true;
+    return s;
+}
+
+/// 某订单的成交总量
+int64_t filled(const std::vector<Event>& events, uint64_t id) {
+    int64_t qty = 0;
+    for (const Event& ev : events) {
+        if (ev.kind == Event::Kind::FILL && ev.order_id == id) {
+            qty += ev.qty;
+        }
+    }
+    return qty;
+}
+
+/// 主动成交：先吃外部买一再吃买二，剩余部分挂单
+void test_take_external() {
+    InstrumentId id = InstrumentRegistry::instance().intern("600000.SH");
+    MatchingEngine engine;
+    std::vector<Event> events;
+    MarketSnapshot s = snapshot(id, 100000000, 10.0, 10000);
+    s.bid_px[0] = px(10.00);
+    s.bid_qty[0] = 500;
+    s.bid_px[1] = px(9.99);
+    s.bid_qty[1] = 1000;
+    s.ask_px[0] = px(10.01);
+    s.ask_qty[0] = 800;
+    engine.on_snapshot(s, events);
+    CHECK(events.empty());
+
+    CHECK(engine.add(1, id, OrderSide::Sell, px(9.99), 1000, false, events));
+    CHECK_EQ(events.size(), 2u);
+    CHECK_EQ(events[0].price, px(10.00));
+    CHECK_EQ(events[0].qty, 500);
+    CHECK_EQ(events[1].price, px(9.99));
+    CHECK_EQ(events[1].qty, 500);
+    CHECK_EQ(events[1].leaves, 0);
+    CHECK_EQ(engine.resting(), 0u);
+
+    // 盘口量已被扣减：买二只剩 500，剩余 100 挂单
+    events.clear();
+    CHECK(engine.add(2, id, OrderSide::Sell, px(9.99), 600, false, events));
+    CHECK_EQ(filled(events, 2), 500);
+    CHECK_EQ(engine.resting(), 1u);
+    CHECK(!engine.add(2, id, OrderSide::Sell, px(9.99), 100, false, events));  // ID 重复
+
+    // 同一快照重复到达不恢复已扣减的盘口
+    events.clear();
+    engine.on_snapshot(s, events);
+    CHECK(events.empty());
+}
+
+/// 被动挂单：排在同价位已有的 1000 之后，成交量增量先消耗前面的外部委托；随后撤单
+void test_queue_position_and_cancel() {
+    InstrumentId id = InstrumentRegistry::instance().intern("600036.SH");
+    MatchingEngine engine;
+    std::vector<Event> events;
+    MarketSnapshot s = snapshot(id, 100000000, 10.0, 10000);
+    s.bid_px[0] = px(10.00);
+    s.bid_qty[0] = 500;
+    s.ask_px[0] = px(10.01);
+    s.ask_qty[0] = 1000;
+    engine.on_snapshot(s, events);
+    CHECK(engine.add(10, id, OrderSide::Sell, px(10.01), 300, false, events));
+    CHECK(events.empty());
+
+    s.timestamp = 100003000;
+    s.last_price = 10.01;
+    s.volume = 10600;
+    s.ask_qty[0] = 400;
+    engine.on_snapshot(s, events);
+    CHECK(events.empty());          // 前面还剩 400
+
+    s.timestamp = 100006000;
+    s.volume = 11200;
+    engine.on_snapshot(s, events);
+    CHECK_EQ(filled(events, 10), 200);
+    CHECK_EQ(events.back().leaves, 100);
+
+    events.clear();
+    CHECK(engine.cancel(10, events));
+    CHECK_EQ(events.size(), 1u);
+    CHECK(events[0].kind == Event::Kind::CANCEL);
+    CHECK_EQ(events[0].qty, 100);
+    CHECK(!engine.cancel(10, events));
+    CHECK(!engine.has_resting(id));
+}
+
+/// 无外部盘口时模拟买卖单互相成交，按先挂单一方的价格
+void test_cross_own_orders() {
+    InstrumentId id = InstrumentRegistry::instance().intern("000001.SZ");
+    MatchingEngine engine;
+    std::vector<Event> events;
+    CHECK(engine.add(20, id, OrderSide::Buy, px(10.00), 200, false, events));
+    CHECK(events.empty());
+    CHECK(engine.add(21, id, OrderSide::Sell, px(9.90), 300, false, events));
+    CHECK_EQ(filled(events, 20), 200);
+    CHECK_EQ(filled(events, 21), 200);
+    for (const Event& ev : events) {
+        CHECK_EQ(ev.price, px(10.00));
+    }
+    CHECK_EQ(engine.resting(), 1u);  // 卖单剩余 100 挂单
+}
+
+/// 集合竞价：委托挂单不成交、市价单拒绝；竞价结束后的快照按最新价集中撮合
+void test_call_auction() {
+    InstrumentId id = InstrumentRegistry::instance().intern("300750.SZ");
+    MatchingEngine engine;
+    std::vector<Event> events;
+    engine.on_snapshot(snapshot(id, 92000000, 0.0, 0), events);
+    CHECK(engine.add(30, id, OrderSide::Buy, px(20.00), 100, false, events));
+    CHECK(engine.add(31, id, OrderSide::Sell, px(19.50), 300, false, events));
+    CHECK(!engine.add(32, id, OrderSide::Sell, 0, 100, true, events));
+    CHECK(events.empty());
+    CHECK_EQ(engine.resting(), 2u);
+
+    engine.on_snapshot(snapshot(id, 92500000, 19.80, 1000), events);
+    CHECK_EQ(filled(events, 30), 100);
+    CHECK_EQ(filled(events, 31), 300);
+    for (const Event& ev : events) {
+        CHECK_EQ(ev.price, px(19.80));
+    }
+    CHECK_EQ(engine.resting(), 0u);
+}
+
+}  // namespace
+
+int main() {
+    test_take_external();
+    test_queue_position_and_cancel();
+    test_cross_own_orders();
+    test_call_auction();
+    return TEST_RESULT();
+}
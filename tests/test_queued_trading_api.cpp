@@ -0,0 +1,285 @@
+// QueuedTradingApi：以 FakeTradingApi 为内层接口，检查
+// - *_async 调用不等待工作线程即返回 future，结果按提交顺序完成，停止后返回带异常的 future；
+// - 三条优先级通道（撤单 > 下单 > 查询）的执行顺序、紧急调用插队；
+// - 低优先级通道连续被跳过 kStarvationLimit 次后必被执行；
+// - 查询合并在下单/撤单使查询失效后的行为；
+// - 撤单按所撤订单的账号/交易所计入撤单自己的令牌桶，不受下单消耗的影响；紧急撤单不受限流阻挡
+
+#include "FakeTradingApi.h"
+#include "QueuedTradingApi.h"
+#include "TestUtil.h"
+#include "TradingMarketApi.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <string>
+#include <vector>
+
+namespace {
+
+OrderRequest sell(const char* symbol) {
+    OrderRequest req;
+    req.account_id = "khh001";
+    req.symbol = symbol;
+    req.side = OrderSide::Sell;
+    req.volume = 100;
+    req.price = 10.0;
+    return req;
+}
+
+template <typename T>
+bool is_ready(std::future<T>& f) {
+    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// 工作线程阻塞时，异步下单/撤单立即返回未就绪的 future（经组合接口转发同样如此），放行后依次完成
+void test_async_calls() {
+    auto fake = std::make_shared<FakeTradingApi>();
+    auto queued = std::make_shared<QueuedTradingApi>(fake);
+    TradingMarketApi combined(queued, nullptr);
+
+    // 未排队的接口：默认实现同步执行，返回已就绪的 future
+    auto direct = fake->place_order_async(sell("600000.SH"));
+    CHECK(is_ready(direct));
+    CHECK_EQ(direct.get(), std::string("1"));
+
+    fake->hold();
+    auto blocker = queued->query_positions_async();
+    CHECK(fake->wait_blocked());
+    std::vector<std::future<std::string>> legs;
+    for (int i = 0; i < 5; ++i) {
+        legs.push_back(combined.place_order_async(sell("600000.SH")));
+    }
+    auto cancel = combined.cancel_order_async("2");
+    for (auto& leg : legs) {
+        CHECK(!is_ready(leg));
+    }
+    CHECK(!is_ready(cancel));
+    CHECK_EQ(fake->count("place:600000.SH"), 1u);  // 只有直接调用的那一笔已执行
+    fake->release();
+    blocker.get();
+    for (size_t i = 0; i < legs.size(); ++i) {
+        CHECK_EQ(legs[i].get(), std::to_string(i + 2));  // 按提交顺序执行
+    }
+    CHECK(cancel.get());
+    CHECK_EQ(combined.query_orders_async().get().size(), 6u);
+
+    // 停止后提交的调用返回带异常的 future，阻塞接口抛出同一异常
+    queued->shutdown();
+    auto late = combined.place_order_async(sell("600000.SH"));
+    CHECK(is_ready(late));
+    bool threw = false;
+    try {
+        late.get();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    threw = false;
+    try {
+        combined.cancel_order("1");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// 工作线程阻塞在内层调用上时排入各通道，放行后等待全部完成，返回除阻塞调用外的执行顺序
+template <typename Enqueue, typename Wait>
+std::vector<std::string> run_queued(FakeTradingApi& fake, QueuedTradingApi& api, Enqueue enqueue, Wait wait) {
+    size_t before = fake.calls().size();
+    fake.hold();
+    auto blocker = api.query_positions_async();
+    CHECK(fake.wait_blocked());
+    enqueue();
+    fake.release();
+    blocker.get();
+    wait();
+    std::vector<std::string> calls = fake.calls();
+    return std::vector<std::string>(calls.begin() + static_cast<long>(before) + 1, calls.end());
+}
+
+void test_lane_priority() {
+    auto fake = std::make_shared<FakeTradingApi>();
+    QueuedTradingApi api(fake);
+    std::vector<std::future<std::string>> places;
+    std::vector<std::future<bool>> cancels;
+    std::future<std::vector<OrderResult>> query;
+    std::future<bool> urgent;
+    std::vector<std::string> calls = run_queued(*fake, api, [&]() {
+        query = api.query_orders_async();
+        for (int i = 0; i < 3; ++i) {
+            places.push_back(api.place_order_async(sell("600000.SH")));
+        }
+        cancels.push_back(api.cancel_order_async("a"));
+        cancels.push_back(api.cancel_order_async("b"));
+        QueuedTradingApi::UrgentScope scope;  // 紧急调用排在撤单通道最前
+        urgent = api.cancel_order_async("u");
+    }, [&]() {
+        CHECK(urgent.get());
+        for (auto& f : cancels) {
+            CHECK(f.get());
+        }
+        for (auto& f : places) {
+            CHECK(!f.get().empty());
+        }
+        CHECK_EQ(query.get().size(), 3u);
+    });
+    std::vector<std::string> expected = {"cancel:u", "cancel:a", "cancel:b", "place:600000.SH",
+                                         "place:600000.SH", "place:600000.SH", "query_orders"};
+    CHECK(calls == expected);
+    CHECK_EQ(api.lane_stats(QueuedTradingApi::Lane::CANCEL).count, 3u);
+    CHECK_EQ(api.lane_stats(QueuedTradingApi::Lane::QUERY).count, 2u);
+}
+
+// 撤单持续到达时，排队的查询与下单各自最多被跳过 kStarvationLimit 次
+void test_starvation_limit() {
+    auto fake = std::make_shared<FakeTradingApi>();
+    QueuedTradingApi api(fake);
+    const int kCancels = 3 * QueuedTradingApi::kStarvationLimit;
+    std::vector<std::future<bool>> cancels;
+    std::future<std::vector<OrderResult>> query;
+    std::future<std::string> place;
+    std::vector<std::string> calls = run_queued(*fake, api, [&]() {
+        query = api.query_orders_async();
+        place = api.place_order_async(sell("000001.SZ"));
+        for (int i = 0; i < kCancels; ++i) {
+            cancels.push_back(api.cancel_order_async(std::to_string(i)));
+        }
+    }, [&]() {
+        CHECK_EQ(place.get(), std::string("1"));
+        query.get();
+        for (auto& f : cancels) {
+            CHECK(f.get());
+        }
+    });
+    CHECK_EQ(calls.size(), static_cast<size_t>(kCancels + 2));
+    size_t query_at = 0;
+    size_t place_at = 0;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (calls[i] == "query_orders") {
+            query_at = i;
+        } else if (calls[i] == "place:000001.SZ") {
+            place_at = i;
+        }
+    }
+    // 两条通道同时达到上限：较低的查询通道先执行，下单通道紧随其后
+    CHECK_EQ(query_at, static_cast<size_t>(QueuedTradingApi::kStarvationLimit));
+    CHECK_EQ(place_at, static_cast<size_t>(QueuedTradingApi::kStarvationLimit + 1));
+}
+
+// 下单使在途查询失效：之后的查询不能合并到失效前发出的查询上
+void test_no_share_after_invalidate() {
+    auto fake = std::make_shared<FakeTradingApi>();
+    QueuedTradingApi api(fake);
+
+    fake->hold();
+    auto before = api.query_orders_async();   // 在内层阻塞
+    CHECK(fake->wait_blocked());
+    auto placed = api.place_order_async(sell("600000.SH"));
+    auto after = api.query_orders_async();    // 失效之后：新发一次查询
+    auto shared = api.query_orders_async();   // 与 after 同一代：合并
+    CHECK_EQ(api.coalesced_queries(), 1u);
+    fake->release();
+
+    CHECK_EQ(placed.get(), std::string("1"));
+    CHECK_EQ(before.get().size(), 0u);
+    CHECK_EQ(after.get().size(), 1u);         // 下单优先于查询执行，结果包含新订单
+    CHECK_EQ(shared.get().size(), 1u);
+    CHECK_EQ(fake->count("query_orders"), 2u);
+
+    // 撤单同样使在途查询失效
+    fake->hold();
+    auto running = api.query_orders_async();
+    CHECK(fake->wait_blocked());
+    auto cancelled = api.cancel_order_async("1");
+    auto fresh = api.query_orders_async();
+    CHECK_EQ(api.coalesced_queries(), 1u);
+    fake->release();
+    CHECK(cancelled.get());
+    running.get();
+    fresh.get();
+    CHECK_EQ(fake->count("query_orders"), 4u);
+}
+
+}  // namespace
+
+long long elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+// 撤单有自己的令牌桶：下单耗尽委托的桶后撤单不等待；撤单的桶空时等待补充；未知订单（内层查不到路由）的撤单不限流
+void test_cancel_rate_limit() {
+    auto fake = std::make_shared<FakeTradingApi>();
+    QueuedTradingApi api(fake);
+    auto limiter = std::make_shared<RateLimiter>();
+    limiter->set_account_limit(10, 2);          // 每 100ms 补充一个
+    limiter->set_cancel_limit(10, 2);
+    limiter->set_cancel_exchange_limit("SZ", 10, 1);
+    api.set_rate_limiter(limiter);
+
+    std::string sh1 = api.place_order(sell("600000.SH"));
+    std::string sh2 = api.place_order(sell("600036.SH"));  // 委托的账号桶已空
+
+    // 撤单不占用委托的桶：不等待
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    CHECK(api.cancel_order("unknown"));
+    CHECK(api.cancel_order(sh1));
+    CHECK(api.cancel_order(sh2));
+    CHECK(elapsed_ms(t0) < 60);
+    // 撤单的账号桶已空，第三笔撤单等待补充
+    t0 = std::chrono::steady_clock::now();
+    CHECK(api.cancel_order(sh1));
+    CHECK(elapsed_ms(t0) >= 60);
+
+    // 撤单的交易所桶：SZ 每账号 1 个突发，第二笔撤单需等待
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));  // 撤单的账号桶回满
+    std::string sz = api.place_order(sell("000001.SZ"));
+    t0 = std::chrono::steady_clock::now();
+    CHECK(api.cancel_orders(std::vector<std::string>(1, sz))[0]);
+    CHECK(elapsed_ms(t0) < 60);
+    t0 = std::chrono::steady_clock::now();
+    CHECK(api.cancel_order(sz));
+    CHECK(elapsed_ms(t0) >= 60);
+    CHECK_EQ(fake->count("cancel:" + sz), 2u);
+    CHECK_EQ(fake->count("cancel:" + sh2), 1u);
+}
+
+// 撤单的桶已空时紧急撤单（UrgentScope）不等待补充，照常记账：之后的普通撤单偿还透支
+void test_urgent_cancel_bypasses_limit() {
+    auto fake = std::make_shared<FakeTradingApi>();
+    QueuedTradingApi api(fake);
+    auto limiter = std::make_shared<RateLimiter>();
+    limiter->set_cancel_limit(10, 1);
+    api.set_rate_limiter(limiter);
+
+    std::string a = api.place_order(sell("600000.SH"));
+    std::string b = api.place_order(sell("600036.SH"));
+    std::string c = api.place_order(sell("601318.SH"));
+    CHECK(api.cancel_order(a));                 // 用掉唯一的令牌
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    {
+        QueuedTradingApi::UrgentScope urgent;
+        CHECK(api.cancel_order(b));
+    }
+    CHECK(elapsed_ms(t0) < 60);
+
+    t0 = std::chrono::steady_clock::now();
+    CHECK(api.cancel_order(c));                 // 桶透支到 -1，约 200ms 后才有令牌
+    CHECK(elapsed_ms(t0) >= 150);
+    CHECK_EQ(fake->count("cancel:" + b), 1u);
+}
+
+int main() {
+    test_async_calls();
+    test_lane_priority();
+    test_starvation_limit();
+    test_no_share_after_invalidate();
+    test_cancel_rate_limit();
+    test_urgent_cancel_bypasses_limit();
+    return TEST_RESULT();
+}
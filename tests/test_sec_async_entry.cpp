@@ -0,0 +1,130 @@
+// 异步委托（SECITPDK_OrderEntrust_ASync）：经 SECITPDK 桩延迟送出确认，检查
+// 下单立即返回且全部在途、确认按开发商本地编号关联并补登委托号、确认前到达的成交推送
+// 与撤单、柜台拒单回退冻结并补发废单通知
+
+#include "MockSecItpdk.h"
+#include "TestUtil.h"
+#include "SecTradingApi.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+OrderRequest sell(const char* symbol, int64_t volume, double price) {
+    OrderRequest req;
+    req.symbol = symbol;
+    req.side = OrderSide::Sell;
+    req.volume = volume;
+    req.price = price;
+    return req;
+}
+
+stStructMsg push_msg(int64 sys_id, int64 kfsbdbh) {
+    stStructMsg msg;
+    std::strcpy(msg.AccountId, "khh001");
+    std::strcpy(msg.Market, "SH");
+    std::strcpy(msg.StockCode, "600000");
+    msg.OrderId = sys_id;
+    if (kfsbdbh != 0) {
+        std::snprintf(msg.KFSBDBH, sizeof(msg.KFSBDBH), "%lld", static_cast<long long>(kfsbdbh));
+    }
+    msg.EntrustType = JYLB_SALE;
+    msg.OrderQty = 100;
+    return msg;
+}
+
+OrderState state_of(SecTradingApi& api, const std::string& id) {
+    OrderState state = OrderState::PENDING;
+    CHECK(api.query_order_state(id, state));
+    return state;
+}
+
+int64_t available(SecTradingApi& api, const char* symbol) {
+    std::vector<Position> positions;
+    CHECK(api.query_positions_local(positions));
+    for (const Position& p : positions) {
+        if (p.symbol == symbol) {
+            return p.available;
+        }
+    }
+    return -1;
+}
+
+}  // namespace
+
+int main() {
+    const int kOrders = 100;
+    mock_itpdk::reset();
+    mock_itpdk::set_position("SH", "600000", "A000000001", 20000, 20000);
+    mock_itpdk::set_position("SZ", "000001", "0000000001", 5000, 5000);
+
+    SecTradingApi api;
+    CHECK(api.connect("sec", 0, "khh001", "pwd"));
+    api.set_async_entry(true);
+    std::atomic<int> invalid_events(0);
+    api.set_order_callback([&invalid_events](const OrderResult&, int type) {
+        if (type == NOTIFY_PUSH_INVALID) {
+            invalid_events.fetch_add(1);
+        }
+    });
+
+    // 确认暂停期间连续下单：全部立即返回本地 ID，均在途（PENDING），冻结已记账
+    mock_itpdk::set_confirm_delay_ms(2);
+    mock_itpdk::pause_confirms(true);
+    std::vector<std::string> ids;
+    for (int i = 0; i < kOrders; ++i) {
+        ids.push_back(api.place_order(sell("600000.SH", 100, 10.0)));
+        CHECK(!ids.back().empty());
+    }
+    CHECK_EQ(mock_itpdk::async_requests(), kOrders);
+    CHECK_EQ(mock_itpdk::async_confirms(), 0);
+    for (const std::string& id : ids) {
+        CHECK(state_of(api, id) == OrderState::PENDING);
+    }
+    CHECK_EQ(available(api, "600000.SH"), 20000 - 100 * kOrders);
+
+    // 确认前撤单：尚无柜台委托号，按开发商本地编号撤单
+    CHECK(api.cancel_order(ids[0]));
+    CHECK_EQ(mock_itpdk::last_withdraw_kfsbdbh(), mock_itpdk::async_kfsbdbh(0));
+    CHECK(state_of(api, ids[0]) == OrderState::CANCEL_PENDING);
+
+    // 成交推送先于异步确认到达：按开发商本地编号关联并补登委托号
+    int64 kfsbdbh1 = mock_itpdk::async_kfsbdbh(1);
+    stStructMsg match = push_msg(mock_itpdk::sys_id_of(kfsbdbh1), kfsbdbh1);
+    match.MatchQty = 100;
+    match.MatchPrice = 10.0;
+    match.TotalMatchQty = 100;
+    match.TotalMatchAmt = 1000.0;
+    CHECK(mock_itpdk::push(match, NOTIFY_PUSH_MATCH));
+    CHECK(state_of(api, ids[1]) == OrderState::FILLED);
+
+    // 放行确认（带延迟），全部送出后每笔都已绑定柜台委托号：仅按委托号的确认推送可以关联
+    mock_itpdk::pause_confirms(false);
+    CHECK(mock_itpdk::wait_confirms(5000));
+    CHECK_EQ(mock_itpdk::async_confirms(), kOrders);
+    for (int i = 2; i < kOrders; ++i) {
+        stStructMsg confirm = push_msg(mock_itpdk::sys_id_of(mock_itpdk::async_kfsbdbh(i)), 0);
+        CHECK(mock_itpdk::push(confirm, NOTIFY_PUSH_ORDER));
+        CHECK(state_of(api, ids[static_cast<size_t>(i)]) == OrderState::ACCEPTED);
+    }
+    CHECK(state_of(api, ids[1]) == OrderState::FILLED);
+    CHECK_EQ(invalid_events.load(), 0);
+
+    // 柜台拒单：确认回调 nRetCode<0，订单废单、冻结退回，并补发废单通知
+    int64_t before = available(api, "600000.SH");
+    mock_itpdk::reject_async(true);
+    std::string rejected = api.place_order(sell("600000.SH", 300, 10.0));
+    CHECK(!rejected.empty());
+    CHECK_EQ(available(api, "600000.SH"), before - 300);
+    CHECK(mock_itpdk::wait_confirms(5000));
+    CHECK(state_of(api, rejected) == OrderState::REJECTED);
+    CHECK_EQ(available(api, "600000.SH"), before);
+    CHECK_EQ(invalid_events.load(), 1);
+    mock_itpdk::reject_async(false);
+
+    api.disconnect();
+    return TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+// 批量委托（SECITPDK_BatchOrderEntrust）：经 SECITPDK 桩检查
+// - 调用柜台之前各腿已登记并冻结，调用期间到达的确认/成交推送按批次号关联到本地订单；
+// - 柜台拒绝的腿回滚（订单删除、冻结退回）；
+// - 推送关联到同批次中另一条相同的腿时，各请求仍各得一个本地订单，成交记在推送对应的订单上
+
+#include "MockSecItpdk.h"
+#include "TestUtil.h"
+#include "SecTradingApi.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+Position position(SecTradingApi& api, const char* symbol) {
+    std::vector<Position> positions;
+    CHECK(api.query_positions_local(positions));
+    for (const Position& p : positions) {
+        if (p.symbol == symbol) {
+            return p;
+        }
+    }
+    return Position();
+}
+
+OrderRequest sell(const char* symbol, int64_t volume) {
+    OrderRequest req;
+    req.symbol = symbol;
+    req.side = OrderSide::Sell;
+    req.volume = volume;
+    req.price = 10.0;
+    return req;
+}
+
+stStructMsg batch_push(const char* market, const char* code, int64 sys_id, int64 qty) {
+    stStructMsg msg;
+    std::strcpy(msg.AccountId, "khh001");
+    std::strcpy(msg.Market, market);
+    std::strcpy(msg.StockCode, code);
+    msg.OrderId = sys_id;
+    msg.BatchNo = mock_itpdk::last_batch_no();
+    msg.EntrustType = JYLB_SALE;
+    msg.OrderQty = qty;
+    msg.OrderPrice = 10.0;
+    return msg;
+}
+
+stStructMsg batch_match(const char* market, const char* code, int64 sys_id, int64 qty, int64 filled) {
+    stStructMsg msg = batch_push(market, code, sys_id, qty);
+    msg.MatchQty = filled;
+    msg.MatchPrice = 10.0;
+    msg.TotalMatchQty = filled;
+    msg.TotalMatchAmt = 10.0 * filled;
+    return msg;
+}
+
+}  // namespace
+
+int main() {
+    mock_itpdk::reset();
+    mock_itpdk::set_position("SH", "600000", "A000000001", 5000, 5000);
+    mock_itpdk::set_position("SZ", "000001", "0000000001", 3000, 3000);
+    mock_itpdk::set_position("SH", "600036", "A000000001", 2000, 2000);
+
+    SecTradingApi api;
+    CHECK(api.connect("sec", 0, "khh001", "pwd"));
+    int external_events = 0;
+    int local_events = 0;
+    api.set_order_callback([&](const OrderResult& r, int) { (r.is_local ? local_events : external_events)++; });
+
+    // 600036 的腿被柜台拒绝；调用返回之前 600000 的腿收到确认与部分成交推送
+    std::vector<OrderRequest> reqs = {sell("600000.SH", 1000), sell("000001.SZ", 500), sell("600036.SH", 300)};
+    mock_itpdk::reject_batch_code("600036");
+    int64_t frozen_in_call = -1;
+    int64_t rejected_frozen_in_call = -1;
+    mock_itpdk::set_call_hook([&](const std::string& entry) {
+        if (entry != "BatchOrderEntrust") {
+            return;
+        }
+        frozen_in_call = position(api, "600000.SH").frozen;
+        rejected_frozen_in_call = position(api, "600036.SH").frozen;
+        stStructMsg confirm = batch_push("SH", "600000", mock_itpdk::batch_wth(0), 1000);
+        CHECK(mock_itpdk::push(confirm, NOTIFY_PUSH_ORDER));
+        stStructMsg match = batch_match("SH", "600000", mock_itpdk::batch_wth(0), 1000, 200);
+        CHECK(mock_itpdk::push(match, NOTIFY_PUSH_MATCH));
+    });
+    std::vector<std::string> ids = api.place_orders(reqs);
+    CHECK_EQ(ids.size(), 3u);
+    CHECK(!ids[0].empty());
+    CHECK(!ids[1].empty());
+    CHECK(ids[2].empty());
+    CHECK_EQ(frozen_in_call, 1000);
+    CHECK_EQ(rejected_frozen_in_call, 300);
+    CHECK_EQ(external_events, 0);
+    CHECK_EQ(local_events, 2);
+
+    OrderState state = OrderState::PENDING;
+    CHECK(api.query_order_state(ids[0], state));
+    CHECK(state == OrderState::PARTIAL);
+    CHECK_EQ(api.query_order(ids[0]).filled_volume, 200);
+    CHECK(api.query_order_state(ids[1], state));
+    CHECK(state == OrderState::PENDING);
+    Position sh = position(api, "600000.SH");
+    CHECK_EQ(sh.total, 4800);
+    CHECK_EQ(sh.frozen, 800);
+    Position rejected = position(api, "600036.SH");
+    CHECK_EQ(rejected.frozen, 0);
+    CHECK_EQ(rejected.available, 2000);
+
+    // 两条相同的腿：第二条的成交推送在返回前到达，按批次关联到第一条尚无委托号的记录
+    mock_itpdk::reject_batch_code("");
+    mock_itpdk::set_call_hook([&](const std::string& entry) {
+        if (entry == "BatchOrderEntrust") {
+            stStructMsg match = batch_match("SZ", "000001", mock_itpdk::batch_wth(1), 100, 50);
+            CHECK(mock_itpdk::push(match, NOTIFY_PUSH_MATCH));
+        }
+    });
+    std::vector<std::string> twins = api.place_orders({sell("000001.SZ", 100), sell("000001.SZ", 100)});
+    CHECK_EQ(twins.size(), 2u);
+    CHECK(!twins[0].empty());
+    CHECK(!twins[1].empty());
+    CHECK(twins[0] != twins[1]);
+    CHECK_EQ(api.query_order(twins[1]).filled_volume, 50);
+    CHECK_EQ(api.query_order(twins[0]).filled_volume, 0);
+    CHECK_EQ(position(api, "000001.SZ").frozen, 500 + 150);
+    CHECK_EQ(external_events, 0);
+
+    // 整批失败：全部回滚
+    mock_itpdk::set_call_hook(nullptr);
+    mock_itpdk::fail_next_order("batch rejected");
+    std::vector<std::string> failed = api.place_orders({sell("600000.SH", 100)});
+    CHECK(failed[0].empty());
+    CHECK_EQ(position(api, "600000.SH").frozen, 800);
+
+    api.disconnect();
+    return TEST_RESULT();
+}
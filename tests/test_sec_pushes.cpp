@@ -0,0 +1,123 @@
+// 柜台推送处理：经 SECITPDK 桩送出委托/成交/撤单推送，检查撤单推送之后迟到的成交
+// 仍计入累计成交并记入持仓台账，终态不变；本地订单簿的活动订单与按标签查找随推送更新
+
+#include "MockSecItpdk.h"
+#include "TestUtil.h"
+#include "SecTradingApi.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+stStructMsg push_msg(int64 sys_id) {
+    stStructMsg msg;
+    std::strcpy(msg.AccountId, "khh001");
+    std::strcpy(msg.Market, "SH");
+    std::strcpy(msg.StockCode, "600000");
+    msg.OrderId = sys_id;
+    msg.EntrustType = JYLB_SALE;
+    msg.OrderQty = 1000;
+    return msg;
+}
+
+stStructMsg match_msg(int64 sys_id, int64 qty, int64 total_qty) {
+    stStructMsg msg = push_msg(sys_id);
+    msg.MatchQty = qty;
+    msg.MatchPrice = 10.0;
+    msg.TotalMatchQty = total_qty;
+    msg.TotalMatchAmt = 10.0 * total_qty;
+    return msg;
+}
+
+Position position(SecTradingApi& api, const char* symbol) {
+    std::vector<Position> positions;
+    CHECK(api.query_positions_local(positions));
+    for (const Position& p : positions) {
+        if (p.symbol == symbol) {
+            return p;
+        }
+    }
+    return Position();
+}
+
+}  // namespace
+
+int main() {
+    mock_itpdk::reset();
+    mock_itpdk::set_position("SH", "600000", "A000000001", 5000, 5000);
+
+    SecTradingApi api;
+    CHECK(api.connect("sec", 0, "khh001", "pwd"));
+    std::vector<int> events;
+    api.set_order_callback([&events](const OrderResult&, int type) { events.push_back(type); });
+
+    OrderRequest req;
+    req.symbol = "600000.SH";
+    req.side = OrderSide::Sell;
+    req.volume = 1000;
+    req.price = 10.0;
+    InstrumentId instrument = InstrumentRegistry::instance().intern("600000.SH");
+    req.tag = make_order_tag(StrategyIds::kCloseSell, instrument, 1);
+    uint32_t tag_key = order_tag_key(req.tag);
+    std::string id = api.place_order(req);
+    CHECK(!id.empty());
+    int64 sys_id = 5000001;  // 桩按下单顺序分配委托号
+
+    stStructMsg confirm = push_msg(sys_id);
+    CHECK(mock_itpdk::push(confirm, NOTIFY_PUSH_ORDER));
+    stStructMsg fill1 = match_msg(sys_id, 300, 300);
+    CHECK(mock_itpdk::push(fill1, NOTIFY_PUSH_MATCH));
+    CHECK_EQ(position(api, "600000.SH").frozen, 700);
+    std::vector<OrderResult> live;
+    CHECK(api.query_live_orders_local(instrument, live));
+    CHECK_EQ(live.size(), 1u);
+    CHECK(live[0].order_id == id);
+    CHECK(live[0].status == OrderResult::Status::PARTIAL);
+
+    // 撤单推送先到：退回未成交的 700
+    stStructMsg withdraw = push_msg(sys_id);
+    CHECK(mock_itpdk::push(withdraw, NOTIFY_PUSH_WITHDRAW));
+    Position after_cancel = position(api, "600000.SH");
+    CHECK_EQ(after_cancel.total, 4700);
+    CHECK_EQ(after_cancel.available, 4700);
+    CHECK_EQ(after_cancel.frozen, 0);
+    live.clear();
+    CHECK(api.query_live_orders_local(instrument, live));
+    CHECK(live.empty());
+    // 已撤订单仍可按标签键找到；查找其他标签键为空
+    std::vector<std::vector<OrderResult>> tagged =
+        api.query_orders_by_tags({tag_key, order_tag_key(make_order_tag(StrategyIds::kIntradaySell, instrument, 1))});
+    CHECK_EQ(tagged.size(), 2u);
+    CHECK_EQ(tagged[0].size(), 1u);
+    CHECK(tagged[0][0].order_id == id);
+    CHECK(tagged[0][0].status == OrderResult::Status::CANCELLED);
+    CHECK(tagged[1].empty());
+
+    // 迟到的成交推送（累计 500）：计入累计成交、从可用扣除，状态仍为已撤
+    stStructMsg fill2 = match_msg(sys_id, 200, 500);
+    CHECK(mock_itpdk::push(fill2, NOTIFY_PUSH_MATCH));
+    OrderState state = OrderState::PENDING;
+    CHECK(api.query_order_state(id, state));
+    CHECK(state == OrderState::CANCELLED);
+    OrderResult order = api.wait_order(id);
+    CHECK_EQ(order.filled_volume, 500);
+    CHECK(order.status == OrderResult::Status::CANCELLED);
+    Position late = position(api, "600000.SH");
+    CHECK_EQ(late.total, 4500);
+    CHECK_EQ(late.available, 4500);
+    CHECK_EQ(late.frozen, 0);
+
+    // 重复的成交推送（累计值未增加）被丢弃，不再通知上层
+    size_t notified = events.size();
+    CHECK(mock_itpdk::push(fill2, NOTIFY_PUSH_MATCH));
+    CHECK_EQ(events.size(), notified);
+    CHECK_EQ(position(api, "600000.SH").total, 4500);
+
+    std::vector<int> expected = {NOTIFY_PUSH_ORDER, NOTIFY_PUSH_MATCH, NOTIFY_PUSH_WITHDRAW, NOTIFY_PUSH_MATCH};
+    CHECK(events == expected);
+
+    api.disconnect();
+    return TEST_RESULT();
+}
@@ -0,0 +1,105 @@
+// 持仓对账与同步下单：经 SECITPDK 桩检查
+// - 同步委托在调用柜台之前登记订单并冻结，柜台失败时回滚；
+// - 查询柜台持仓期间到达的推送不被过时的柜台结果覆盖，其余证券以柜台为准
+
+#include "MockSecItpdk.h"
+#include "TestUtil.h"
+#include "SecTradingApi.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+Position position(SecTradingApi& api, const char* symbol) {
+    std::vector<Position> positions;
+    CHECK(api.query_positions_local(positions));
+    for (const Position& p : positions) {
+        if (p.symbol == symbol) {
+            return p;
+        }
+    }
+    return Position();
+}
+
+OrderRequest sell(const char* symbol, int64_t volume) {
+    OrderRequest req;
+    req.symbol = symbol;
+    req.side = OrderSide::Sell;
+    req.volume = volume;
+    req.price = 10.0;
+    return req;
+}
+
+}  // namespace
+
+int main() {
+    mock_itpdk::reset();
+    mock_itpdk::set_position("SH", "600000", "A000000001", 5000, 5000);
+    mock_itpdk::set_position("SZ", "000001", "0000000001", 3000, 3000);
+
+    SecTradingApi api;
+    CHECK(api.connect("sec", 0, "khh001", "pwd"));
+
+    // 同步委托：调用柜台时本地订单与冻结已登记
+    int64_t frozen_in_call = -1;
+    mock_itpdk::set_call_hook([&](const std::string& entry) {
+        if (entry == "OrderEntrust") {
+            frozen_in_call = position(api, "600000.SH").frozen;
+        }
+    });
+    std::string id = api.place_order(sell("600000.SH", 1000));
+    CHECK(!id.empty());
+    CHECK_EQ(frozen_in_call, 1000);
+    OrderState state = OrderState::REJECTED;
+    CHECK(api.query_order_state(id, state));
+    CHECK(state == OrderState::PENDING);
+
+    // 柜台失败：订单删除、冻结退回
+    mock_itpdk::fail_next_order("insufficient position");
+    CHECK(api.place_order(sell("600000.SH", 500)).empty());
+    CHECK_EQ(frozen_in_call, 1500);
+    CHECK_EQ(position(api, "600000.SH").frozen, 1000);
+    CHECK_EQ(position(api, "600000.SH").available, 4000);
+    CHECK(!api.query_order_state("100002", state));  // 失败订单的本地 ID 已删除
+
+    // 对账：柜台结果取定之后 600000 成交 300（推送），000001 柜台可用与本地不一致
+    mock_itpdk::set_position("SH", "600000", "A000000001", 5000, 4000);
+    mock_itpdk::set_position("SZ", "000001", "0000000001", 3000, 2000);
+    mock_itpdk::set_call_hook([&](const std::string& entry) {
+        if (entry != "QueryPositions") {
+            return;
+        }
+        stStructMsg match;
+        std::strcpy(match.AccountId, "khh001");
+        std::strcpy(match.Market, "SH");
+        std::strcpy(match.StockCode, "600000");
+        match.OrderId = 5000001;
+        match.EntrustType = JYLB_SALE;
+        match.OrderQty = 1000;
+        match.MatchQty = 300;
+        match.MatchPrice = 10.0;
+        match.TotalMatchQty = 300;
+        match.TotalMatchAmt = 3000.0;
+        CHECK(mock_itpdk::push(match, NOTIFY_PUSH_MATCH));
+    });
+    CHECK_EQ(api.reconcile_positions(), 1u);  // 只有 000001 计为偏差
+    Position sh = position(api, "600000.SH");
+    CHECK_EQ(sh.total, 4700);  // 成交推送保留，未被查询时的 5000 覆盖
+    CHECK_EQ(sh.available, 4000);
+    CHECK_EQ(sh.frozen, 700);
+    Position sz = position(api, "000001.SZ");
+    CHECK_EQ(sz.total, 3000);
+    CHECK_EQ(sz.available, 2000);
+    CHECK_EQ(sz.frozen, 1000);
+
+    // 柜台追上之后再对账：无偏差
+    mock_itpdk::set_call_hook(nullptr);
+    mock_itpdk::set_position("SH", "600000", "A000000001", 4700, 4000);
+    CHECK_EQ(api.reconcile_positions(), 0u);
+    CHECK_EQ(position(api, "600000.SH").total, 4700);
+
+    api.disconnect();
+    return TEST_RESULT();
+}
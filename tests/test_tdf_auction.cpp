@@ -0,0 +1,102 @@
+// 集合竞价逐笔累计：经 TDF 桩以 OnDataReceived 推送合成的 TDF_TRANSACTION 数组，
+// 检查时段边界、撤单记录排除以及截止时间早于首笔成交的情况
+
+#include "MockTdf.h"
+#include "TestUtil.h"
+#include "TdfMarketDataApi.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char* kCsv = "test_tdf_auction.csv";
+
+TDF_TRANSACTION trade(const char* symbol, int hhmmssmmm, double price, int volume,
+                      char function_code = '0') {
+    TDF_TRANSACTION t;
+    std::memset(&t, 0, sizeof(t));
+    std::strncpy(t.szWindCode, symbol, sizeof(t.szWindCode) - 1);
+    std::strncpy(t.szCode, symbol, 6);
+    t.nTime = hhmmssmmm;
+    t.nPrice = static_cast<long long>(price * 10000.0 + 0.5);
+    t.nVolume = volume;
+    t.nTurnover = static_cast<long long>(price * volume + 0.5);
+    t.nBSFlag = 'B';
+    t.chFunctionCode = function_code;
+    return t;
+}
+
+void write_csv() {
+    std::FILE* f = std::fopen(kCsv, "w");
+    std::fputs("ID,NAME,SYMBOL\n1,a,600000\n2,b,000001\n3,c,300750\n", f);
+    std::fclose(f);
+}
+
+}  // namespace
+
+int main() {
+    write_csv();
+    TdfMarketDataApi api;
+    api.set_csv_path(kCsv);
+    CHECK(api.connect("127.0.0.1", 6221));
+    THANDLE handle = mock_tdf::last_handle();
+    CHECK(handle != nullptr);
+
+    std::vector<TDF_TRANSACTION> batch;
+    // 600000.SH：开盘集合竞价边界
+    batch.push_back(trade("600000.SH", 91459999, 9.00, 100));   // 09:14:59.999 时段外
+    batch.push_back(trade("600000.SH", 91500000, 10.00, 200));  // 09:15:00 时段起点
+    batch.push_back(trade("600000.SH", 92500000, 10.10, 300));  // 09:25:00 撮合
+    batch.push_back(trade("600000.SH", 92500000, 10.10, 500, 'C'));  // 撤单不计入
+    batch.push_back(trade("600000.SH", 92959999, 10.10, 400));  // 09:29:59.999 仍属开盘时段
+    batch.push_back(trade("600000.SH", 93000000, 10.50, 700));  // 09:30:00 连续竞价
+    // 000001.SZ：首笔撮合在 09:25，截止时间更早时无数据
+    batch.push_back(trade("000001.SZ", 92500000, 12.00, 1000));
+    // 300750.SZ：收盘集合竞价边界
+    batch.push_back(trade("300750.SZ", 145659999, 200.00, 100));  // 14:56:59.999 连续竞价
+    batch.push_back(trade("300750.SZ", 145700000, 201.00, 100));  // 14:57:00 时段起点
+    batch.push_back(trade("300750.SZ", 150000000, 202.00, 300));  // 15:00:00 收盘撮合
+    batch.push_back(trade("300750.SZ", 150000000, 202.00, 50, 'C'));
+    CHECK(mock_tdf::deliver(handle, MSG_DATA_TRANSACTION, batch));
+
+    // 开盘：09:15:00 / 09:25:00 / 09:29:59.999 三笔，金额 2000 + 3030 + 4040
+    auto open = api.get_auction_data("600000.SH", "20250910", "09:29:59");
+    CHECK_EQ(open.first, 10.10);
+    CHECK_EQ(open.second, 2000.0 + 3030.0 + 4040.0);
+
+    // 截止时间等于首笔成交时间时可见；早于首笔时返回 0
+    auto at_first = api.get_auction_data("600000.SH", "20250910", "09:15:00");
+    CHECK(at_first.second > 0.0);
+    auto before_first = api.get_auction_data("000001.SZ", "20250910", "09:20:00");
+    CHECK_EQ(before_first.first, 0.0);
+    CHECK_EQ(before_first.second, 0.0);
+    auto after_match = api.get_auction_data("000001.SZ", "20250910", "092600000");
+    CHECK_EQ(after_match.first, 12.00);
+    CHECK_EQ(after_match.second, 12000.0);
+
+    // 收盘：只计 14:57:00 与 15:00:00 两笔，撤单不计入
+    auto close = api.get_auction_data("300750.SZ", "20250910", "15:00:00");
+    CHECK_EQ(close.first, 202.00);
+    CHECK_EQ(close.second, 20100.0 + 60600.0);
+
+    // 仅有连续竞价成交 / 仅有撤单的证券：截止时间在集合竞价时段内也没有累计
+    std::vector<TDF_TRANSACTION> only_cancel;
+    only_cancel.push_back(trade("600036.SH", 92500000, 30.00, 100, 'C'));
+    only_cancel.push_back(trade("600036.SH", 93100000, 30.00, 100));
+    CHECK(mock_tdf::deliver(handle, MSG_DATA_TRANSACTION, only_cancel));
+    auto none = api.get_auction_data("600036.SH", "20250910", "09:26:00");
+    CHECK_EQ(none.second, 0.0);
+
+    // 再次推送时累计延续（同一时段多批）
+    std::vector<TDF_TRANSACTION> more;
+    more.push_back(trade("000001.SZ", 92500000, 12.00, 500));
+    CHECK(mock_tdf::deliver(handle, MSG_DATA_TRANSACTION, more));
+    CHECK_EQ(api.get_auction_data("000001.SZ", "20250910", "09:26:00").second, 18000.0);
+
+    api.disconnect();
+    CHECK(!mock_tdf::deliver(handle, MSG_DATA_TRANSACTION, more));  // 断开后句柄失效
+    std::remove(kCsv);
+    return TEST_RESULT();
+}
@@ -0,0 +1,188 @@
+// TDF 回调句柄解析压力测试：多个实例各自的推送线程以伪造 THANDLE 并发回调，
+// 同时反复断开/重连其中一个实例，检查回调只路由到本实例、断开返回后不再有回调进入，
+// 以及实例表满时 connect 失败
+
+#include "MockTdf.h"
+#include "TestUtil.h"
+#include "TdfMarketDataApi.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* kCsv = "test_tdf_callbacks.csv";
+const int kStable = 3;              // 全程保持连接的实例
+const int kInstances = kStable + 1; // 最后一个实例反复断开/重连
+const char* kSymbols[] = {"600000.SH", "600036.SH", "000001.SZ", "300750.SZ"};
+const int kSymbolCount = 4;
+
+struct Instance {
+    TdfMarketDataApi api;
+    std::atomic<THANDLE> handle{nullptr};
+    std::atomic<bool> alive{false};       // connect 之后、disconnect 返回之前为 true
+    std::atomic<int> in_callback{0};
+    std::atomic<uint64_t> callbacks{0};
+    std::atomic<uint64_t> late_callbacks{0};  // disconnect 返回后仍进入的回调（应为 0）
+};
+
+TDF_MARKET_DATA market(const char* symbol, int instance, int seq) {
+    TDF_MARKET_DATA m;
+    std::memset(&m, 0, sizeof(m));
+    std::strncpy(m.szWindCode, symbol, sizeof(m.szWindCode) - 1);
+    m.nTime = 100000000 + seq;
+    m.nPreClose = 100000;
+    m.nMatch = (instance + 1) * 10000;  // 最新价编码实例序号，检查是否路由到别的实例
+    m.nHighLimited = 110000;
+    m.nLowLimited = 90000;
+    m.nBidPrice[0] = m.nMatch;
+    m.nBidVol[0] = 100;
+    return m;
+}
+
+TDF_TRANSACTION trade(const char* symbol, int seq) {
+    TDF_TRANSACTION t;
+    std::memset(&t, 0, sizeof(t));
+    std::strncpy(t.szWindCode, symbol, sizeof(t.szWindCode) - 1);
+    t.nTime = 100000000 + seq;
+    t.nPrice = 100000;
+    t.nVolume = 100;
+    t.nTurnover = 1000;
+    t.chFunctionCode = '0';
+    return t;
+}
+
+bool connect(Instance& inst) {
+    inst.api.set_csv_path(kCsv);
+    inst.api.set_tick_history_capacity(16);
+    if (!inst.api.connect("127.0.0.1", 6221)) {
+        return false;
+    }
+    inst.handle.store(mock_tdf::last_handle());
+    inst.alive.store(true);
+    return true;
+}
+
+void disconnect(Instance& inst) {
+    inst.api.disconnect();
+    inst.alive.store(false);  // 此后不应再有该实例的回调进入
+}
+
+}  // namespace
+
+int main() {
+    std::FILE* f = std::fopen(kCsv, "w");
+    std::fputs("ID,NAME,SYMBOL\n1,a,600000\n2,b,600036\n3,c,000001\n4,d,300750\n", f);
+    std::fclose(f);
+
+    std::vector<std::unique_ptr<Instance>> instances;
+    for (int i = 0; i < kInstances; ++i) {
+        instances.emplace_back(new Instance());
+        Instance* inst = instances.back().get();
+        inst->api.set_transaction_callback([inst](const TransactionData&) {
+            inst->in_callback.fetch_add(1);
+            if (!inst->alive.load()) {
+                inst->late_callbacks.fetch_add(1);
+            }
+            inst->callbacks.fetch_add(1);
+            inst->in_callback.fetch_sub(1);
+        });
+        CHECK(connect(*inst));
+    }
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> delivered(0);
+    // 每个实例一个推送线程（与 TDF 相同：同一句柄的回调串行，不同句柄的回调并发）
+    std::vector<std::thread> feeders;
+    for (int t = 0; t < kInstances; ++t) {
+        feeders.emplace_back([&, t]() {
+            Instance& inst = *instances[static_cast<size_t>(t)];
+            int seq = 0;
+            while (!stop.load()) {
+                std::vector<TDF_MARKET_DATA> md;
+                std::vector<TDF_TRANSACTION> tx;
+                for (int s = 0; s < kSymbolCount; ++s) {
+                    md.push_back(market(kSymbols[s], t, ++seq));
+                    tx.push_back(trade(kSymbols[s], seq));
+                }
+                // 句柄可能已被关闭（重连实例），桩返回 false 或回调找不到实例，都应安全
+                THANDLE handle = inst.handle.load();
+                if (mock_tdf::deliver(handle, MSG_DATA_MARKET, md)) {
+                    delivered.fetch_add(1);
+                }
+                mock_tdf::deliver(handle, MSG_DATA_TRANSACTION, tx);
+            }
+        });
+    }
+
+    // 等每个推送线程都已送达过回调再开始重连（单核上线程可能迟迟得不到调度）
+    for (int waited = 0; waited < 5000; ++waited) {
+        bool all = true;
+        for (auto& inst : instances) {
+            all = all && inst->callbacks.load() > 0;
+        }
+        if (all) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 反复断开/重连最后一个实例：每次得到新句柄，旧句柄上的在途回调必须在 disconnect 返回前结束
+    Instance& churn = *instances.back();
+    int reconnects = 0;
+    for (int round = 0; round < 200; ++round) {
+        disconnect(churn);
+        CHECK_EQ(churn.in_callback.load(), 0);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        if (connect(churn)) {
+            ++reconnects;
+        }
+    }
+
+    stop.store(true);
+    for (std::thread& t : feeders) {
+        t.join();
+    }
+
+    CHECK_EQ(reconnects, 200);
+    CHECK(delivered.load() > 0);
+    for (int i = 0; i < kInstances; ++i) {
+        Instance& inst = *instances[static_cast<size_t>(i)];
+        CHECK_EQ(inst.late_callbacks.load(), 0u);
+        CHECK(inst.callbacks.load() > 0);
+    }
+    // 全程连接的实例只收到发给自己的快照
+    for (int i = 0; i < kStable; ++i) {
+        for (int s = 0; s < kSymbolCount; ++s) {
+            MarketSnapshot snap = instances[static_cast<size_t>(i)]->api.get_snapshot(kSymbols[s]);
+            CHECK(snap.valid);
+            CHECK_EQ(snap.last_price, static_cast<double>(i + 1));
+        }
+    }
+
+    // 实例表共 16 个槽位：已占 kInstances 个，再连满后下一个实例 connect 失败
+    std::vector<std::unique_ptr<Instance>> extra;
+    int extra_ok = 0;
+    for (int i = 0; i < 16 - kInstances; ++i) {
+        extra.emplace_back(new Instance());
+        extra_ok += connect(*extra.back()) ? 1 : 0;
+    }
+    CHECK_EQ(extra_ok, 16 - kInstances);
+    Instance overflow;
+    CHECK(!connect(overflow));
+    CHECK(!mock_tdf::deliver(mock_tdf::last_handle(), MSG_DATA_MARKET, nullptr, 0, 0));  // 失败时句柄已关闭
+
+    for (auto& inst : extra) {
+        disconnect(*inst);
+    }
+    for (auto& inst : instances) {
+        disconnect(*inst);
+    }
+    std::remove(kCsv);
+    return TEST_RESULT();
+}